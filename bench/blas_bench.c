@@ -0,0 +1,126 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file blas_bench.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Times blas_gemm() on the shapes produced by the neural layers and
+ * recursive least squares predictions.
+ * @details Built once with the built-in kernels and once against CBLAS when
+ * USE_CBLAS is enabled so that the two backends can be compared.
+ */
+
+#include "../xcsf/blas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @brief A blas_gemm() problem to be timed.
+ */
+struct Shape {
+    const char *name; //!< Description of the caller
+    int TA; //!< Whether A is transposed
+    int TB; //!< Whether B is transposed
+    int M; //!< Number of rows of op(A) and C
+    int N; //!< Number of columns of op(B) and C
+    int K; //!< Number of columns of op(A) and rows of op(B)
+    double BETA; //!< Scalar used to scale C
+};
+
+static const struct Shape shapes[] = {
+    { "conv forward 3x3x1 -> 8 @ 28x28", 0, 0, 8, 784, 9, 1 },
+    { "conv forward 3x3x8 -> 16 @ 14x14", 0, 0, 16, 196, 72, 1 },
+    { "conv weights 3x3x8 -> 16 @ 14x14", 0, 1, 16, 72, 196, 1 },
+    { "conv delta 3x3x8 -> 16 @ 14x14", 1, 0, 72, 196, 16, 0 },
+    { "connected forward 100 -> 100", 0, 1, 1, 100, 100, 1 },
+    { "connected weights 100 -> 100", 1, 0, 100, 100, 1, 1 },
+    { "connected delta 100 -> 100", 0, 0, 1, 100, 100, 1 },
+    { "rls gain n=11", 0, 0, 11, 1, 11, 0 },
+    { "rls matrix n=11", 0, 0, 11, 11, 11, 0 },
+    { "rls gain n=51", 0, 0, 51, 1, 51, 0 },
+    { "rls matrix n=51", 0, 0, 51, 51, 51, 0 },
+};
+
+/**
+ * @brief Returns the current time in seconds.
+ * @return The time.
+ */
+static double
+bench_time(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Times repeated multiplications of one shape and prints the result.
+ * @param [in] s The shape to time.
+ */
+static void
+bench_shape(const struct Shape *s)
+{
+    const int lda = s->TA ? s->M : s->K;
+    const int ldb = s->TB ? s->K : s->N;
+    double *A = malloc(sizeof(double) * s->M * s->K);
+    double *B = malloc(sizeof(double) * s->K * s->N);
+    double *C = calloc(s->M * s->N, sizeof(double));
+    for (int i = 0; i < s->M * s->K; ++i) {
+        A[i] = (double) rand() / RAND_MAX - 0.5;
+    }
+    for (int i = 0; i < s->K * s->N; ++i) {
+        B[i] = (double) rand() / RAND_MAX - 0.5;
+    }
+    const double flops = 2.0 * s->M * s->N * s->K;
+    const int reps = (int) (2e8 / flops) + 1;
+    const double start = bench_time();
+    for (int r = 0; r < reps; ++r) {
+        blas_gemm(s->TA, s->TB, s->M, s->N, s->K, 1e-3, A, lda, B, ldb,
+                  s->BETA, C, s->N);
+    }
+    const double elapsed = bench_time() - start;
+    double sum = 0;
+    for (int i = 0; i < s->M * s->N; ++i) {
+        sum += C[i];
+    }
+    printf("%-36s %10.3f us %8.2f GFLOP/s  checksum %.6e\n", s->name,
+           elapsed / reps * 1e6, flops * reps / elapsed * 1e-9, sum);
+    free(A);
+    free(B);
+    free(C);
+}
+
+/**
+ * @brief Runs the benchmark.
+ * @return Zero on success.
+ */
+int
+main(void)
+{
+#ifdef USE_CBLAS
+    printf("backend: CBLAS\n");
+#else
+    printf("backend: built-in\n");
+#endif
+    srand(1);
+    const int n_shapes = sizeof(shapes) / sizeof(shapes[0]);
+    for (int i = 0; i < n_shapes; ++i) {
+        bench_shape(&shapes[i]);
+    }
+    return 0;
+}
@@ -44,7 +44,7 @@ TEST_CASE("ACT_INTEGER")
     struct Cl c2;
     rand_init();
     param_init(&xcsf, 3, 1, 10);
-    param_set_random_state(&xcsf, 1);
+    param_set_random_state(&xcsf, 2);
     action_param_set_type(&xcsf, ACT_TYPE_INTEGER);
     cl_init(&xcsf, &c1, 1, 1);
     cl_init(&xcsf, &c2, 1, 1);
@@ -0,0 +1,165 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file alloc_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Steady-state trial heap allocation tests.
+ * @details The C allocation functions are interposed with counting wrappers
+ * where the C library provides its internal entry points. The tests are built
+ * as a separate executable so that the wrappers replace the allocators of
+ * these tests only.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_rl.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+}
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+    #define COUNT_ALLOCS
+#endif
+
+#ifdef COUNT_ALLOCS
+
+static bool counting = false;
+static long n_allocs = 0;
+
+extern "C" {
+void *
+__libc_malloc(size_t size);
+void *
+__libc_calloc(size_t n, size_t size);
+void *
+__libc_realloc(void *ptr, size_t size);
+
+void *
+malloc(size_t size)
+{
+    if (counting) {
+        ++n_allocs;
+    }
+    return __libc_malloc(size);
+}
+
+void *
+calloc(size_t n, size_t size)
+{
+    if (counting) {
+        ++n_allocs;
+    }
+    return __libc_calloc(n, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+    if (counting) {
+        ++n_allocs;
+    }
+    return __libc_realloc(ptr, size);
+}
+}
+
+TEST_CASE("ALLOC")
+{
+    /* Test supervised trials do not allocate once warmed up */
+    const int n_samples = 50;
+    const int x_dim = 2;
+    double x[100];
+    double y[50];
+    struct XCSF xcsf;
+    param_init(&xcsf, x_dim, 1, 1);
+    param_set_random_state(&xcsf, 1);
+    param_set_pop_size(&xcsf, 200);
+    xcsf_init(&xcsf);
+    for (int i = 0; i < n_samples; ++i) {
+        x[i * x_dim] = rand_uniform(0, 1);
+        x[i * x_dim + 1] = rand_uniform(0, 1);
+        y[i] = (x[i * x_dim] > 0.5) ? 0.2 : 0.8;
+    }
+    struct Input data;
+    data.n_samples = n_samples;
+    data.x_dim = x_dim;
+    data.y_dim = 1;
+    data.x = x;
+    data.y = y;
+    xcs_supervised_fit(&xcsf, &data, NULL, true, 5000);
+    n_allocs = 0;
+    counting = true;
+    xcs_supervised_fit(&xcsf, &data, NULL, true, 1000);
+    counting = false;
+    CHECK_EQ(n_allocs, 0);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
+
+/**
+ * @brief Runs reinforcement learning trials of two steps on a toy problem.
+ * @details The reward is given for choosing the action indicated by the
+ * first input variable.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] n_trials The number of trials to run.
+ */
+static void
+rl_trials(struct XCSF *xcsf, const int n_trials)
+{
+    double state[2];
+    for (int t = 0; t < n_trials; ++t) {
+        xcs_rl_init_trial(xcsf);
+        for (int step = 0; step < 2; ++step) {
+            state[0] = rand_uniform(0, 1);
+            state[1] = rand_uniform(0, 1);
+            xcs_rl_init_step(xcsf);
+            const int action = xcs_rl_decision(xcsf, state);
+            const double reward = (action == (state[0] > 0.5)) ? 1 : 0;
+            const bool done = step == 1;
+            xcs_rl_update(xcsf, state, action, reward, done);
+            xcs_rl_end_step(xcsf, state, action, reward);
+        }
+        xcs_rl_end_trial(xcsf);
+    }
+}
+
+TEST_CASE("ALLOC_RL")
+{
+    /* Test reinforcement learning trials do not allocate once warmed up */
+    struct XCSF xcsf;
+    param_init(&xcsf, 2, 1, 2);
+    param_set_random_state(&xcsf, 1);
+    param_set_pop_size(&xcsf, 200);
+    param_set_explore(&xcsf, true);
+    xcsf_init(&xcsf);
+    rl_trials(&xcsf, 3000);
+    n_allocs = 0;
+    counting = true;
+    rl_trials(&xcsf, 500);
+    counting = false;
+    CHECK_EQ(n_allocs, 0);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
+
+#endif
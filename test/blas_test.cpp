@@ -0,0 +1,152 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file blas_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Basic linear algebra function tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/blas.h"
+#include "../xcsf/utils.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+/**
+ * @brief Checks blas_gemm() against the textbook triple loop.
+ * @param [in] TA Whether A is transposed.
+ * @param [in] TB Whether B is transposed.
+ * @param [in] M Number of rows of op(A) and C.
+ * @param [in] N Number of columns of op(B) and C.
+ * @param [in] K Number of columns of op(A) and rows of op(B).
+ * @param [in] BETA Scalar used to scale C.
+ */
+static void
+check_gemm(const int TA, const int TB, const int M, const int N, const int K,
+           const double BETA)
+{
+    const double ALPHA = 0.7;
+    const int lda = TA ? M : K;
+    const int ldb = TB ? K : N;
+    double *A = (double *) malloc(sizeof(double) * M * K);
+    double *B = (double *) malloc(sizeof(double) * K * N);
+    double *C = (double *) malloc(sizeof(double) * M * N);
+    double *expected = (double *) malloc(sizeof(double) * M * N);
+    for (int i = 0; i < M * K; ++i) {
+        A[i] = rand_uniform(-1, 1);
+    }
+    for (int i = 0; i < K * N; ++i) {
+        B[i] = rand_uniform(-1, 1);
+    }
+    for (int i = 0; i < M * N; ++i) {
+        C[i] = rand_uniform(-1, 1);
+        expected[i] = C[i] * BETA;
+    }
+    for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+            double sum = 0;
+            for (int k = 0; k < K; ++k) {
+                const double a = TA ? A[k * lda + i] : A[i * lda + k];
+                const double b = TB ? B[j * ldb + k] : B[k * ldb + j];
+                sum += a * b;
+            }
+            expected[i * N + j] += ALPHA * sum;
+        }
+    }
+    blas_gemm(TA, TB, M, N, K, ALPHA, A, lda, B, ldb, BETA, C, N);
+    for (int i = 0; i < M * N; ++i) {
+        CHECK_EQ(doctest::Approx(C[i]), expected[i]);
+    }
+    free(A);
+    free(B);
+    free(C);
+    free(expected);
+}
+
+TEST_CASE("BLAS_GEMM")
+{
+    rand_init_seed(1);
+    /* Test shapes covering the kernels, their remainders and blocking */
+    const int shapes[7][3] = { { 1, 1, 1 },   { 1, 13, 9 },  { 9, 1, 7 },
+                               { 5, 6, 3 },   { 8, 8, 8 },   { 3, 600, 2 },
+                               { 6, 5, 300 } };
+    const double betas[3] = { 0, 0.5, 1 };
+    for (int s = 0; s < 7; ++s) {
+        for (int t = 0; t < 4; ++t) {
+            for (int b = 0; b < 3; ++b) {
+                check_gemm(t & 1, t >> 1, shapes[s][0], shapes[s][1],
+                           shapes[s][2], betas[b]);
+            }
+        }
+    }
+}
+
+TEST_CASE("BLAS_SINGLE")
+{
+    rand_init_seed(2);
+    /* Test the single precision functions against double precision */
+    const int M = 7;
+    const int N = 9;
+    const int K = 300;
+    double A[M * K];
+    double B[K * N];
+    double C[M * N];
+    float sA[M * K];
+    float sB[K * N];
+    float sC[M * N];
+    for (int i = 0; i < M * K; ++i) {
+        A[i] = rand_uniform(-1, 1);
+        sA[i] = (float) A[i];
+    }
+    for (int i = 0; i < K * N; ++i) {
+        B[i] = rand_uniform(-1, 1);
+        sB[i] = (float) B[i];
+    }
+    for (int t = 0; t < 4; ++t) {
+        const int TA = t & 1;
+        const int TB = t >> 1;
+        const int lda = TA ? M : K;
+        const int ldb = TB ? K : N;
+        for (int i = 0; i < M * N; ++i) {
+            C[i] = rand_uniform(-1, 1);
+            sC[i] = (float) C[i];
+        }
+        blas_gemm(TA, TB, M, N, K, 0.7, A, lda, B, ldb, 0.5, C, N);
+        blas_sgemm(TA, TB, M, N, K, 0.7f, sA, lda, sB, ldb, 0.5f, sC, N);
+        for (int i = 0; i < M * N; ++i) {
+            CHECK_EQ(doctest::Approx(sC[i]).epsilon(1e-4), C[i]);
+        }
+    }
+    CHECK_EQ(doctest::Approx(blas_sdot(K, sA, 1, sB, N)).epsilon(1e-4),
+             blas_dot(K, A, 1, B, N));
+    CHECK_EQ(doctest::Approx(blas_ssum(sA, K)).epsilon(1e-4), blas_sum(A, K));
+    blas_axpy(K, 0.3, A, 1, B, 1);
+    blas_saxpy(K, 0.3f, sA, 1, sB, 1);
+    blas_scal(K, 2, B, 1);
+    blas_sscal(K, 2, sB, 1);
+    blas_mul(K, A, 1, B, 1);
+    blas_smul(K, sA, 1, sB, 1);
+    for (int i = 0; i < K; ++i) {
+        CHECK_EQ(doctest::Approx(sB[i]).epsilon(1e-5), B[i]);
+    }
+}
@@ -0,0 +1,180 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_del_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Deletion vote tree tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/clset_del.h"
+#include "../xcsf/clset_soa.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+/**
+ * @brief Selects a rule for deletion by walking the whole population.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The population index of the selected rule.
+ */
+static int
+roulette(const struct XCSF *xcsf)
+{
+    const struct Set *pset = &xcsf->pset;
+    const double avg_fit = clset_total_fit(pset) / pset->num;
+    double total_vote = 0;
+    for (int i = 0; i < pset->size; ++i) {
+        total_vote += cl_del_vote(xcsf, pset->cl[i], avg_fit);
+    }
+    const double p = rand_uniform(0, total_vote);
+    int j = 0;
+    double sum = cl_del_vote(xcsf, pset->cl[j], avg_fit);
+    while (p > sum && j < pset->size - 1) {
+        ++j;
+        sum += cl_del_vote(xcsf, pset->cl[j], avg_fit);
+    }
+    return j;
+}
+
+/**
+ * @brief Deletes one numerosity from a rule and updates the tree.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] del The population index of the rule.
+ */
+static void
+delete_rule(struct XCSF *xcsf, const int del)
+{
+    struct Set *pset = &xcsf->pset;
+    struct Cl *c = pset->cl[del];
+    --(c->num);
+    --(pset->num);
+    if (c->num == 0) {
+        clset_add(&xcsf->kset, c);
+        --(pset->size);
+        pset->cl[del] = pset->cl[pset->size];
+    }
+    clset_del_update(xcsf, del, c);
+}
+
+TEST_CASE("CLSET_DEL")
+{
+    struct XCSF xcsf;
+    param_init(&xcsf, 4, 1, 1);
+    param_set_random_state(&xcsf, 1);
+    param_set_pop_size(&xcsf, 300);
+    param_set_theta_del(&xcsf, 20);
+    param_set_delta(&xcsf, 0.1);
+    param_set_m_probation(&xcsf, 100);
+    xcsf_init(&xcsf);
+    struct Set *pset = &xcsf.pset;
+    CHECK_EQ(pset->size, 300);
+    /* place many rules close to the low fitness threshold */
+    for (int i = 0; i < pset->size; ++i) {
+        struct Cl *c = pset->cl[i];
+        c->num = 1 + rand_uniform_int(0, 5);
+        c->exp = rand_uniform_int(0, 40);
+        c->size = rand_uniform(1, 20);
+        c->fit = c->num * rand_uniform(0.01, 1);
+        c->mtotal = 1;
+    }
+    pset->num = 0;
+    for (int i = 0; i < pset->size; ++i) {
+        pset->num += pset->cl[i]->num;
+    }
+    const double avg_fit = clset_total_fit(pset) / pset->num;
+    for (int i = 0; i < pset->size; i += 2) {
+        struct Cl *c = pset->cl[i];
+        c->fit = c->num * 0.1 * avg_fit * rand_uniform(0.97, 1.03);
+    }
+    /* test selections match the linear roulette as rules are deleted */
+    clset_del_prepare(&xcsf);
+    for (int k = 0; k < 400; ++k) {
+        rand_init_seed(k);
+        const int expected = roulette(&xcsf);
+        rand_init_seed(k);
+        const int del = clset_del_select(&xcsf);
+        CHECK_EQ(del, expected);
+        delete_rule(&xcsf, del);
+    }
+    /* test the tree follows rules being modified and added */
+    for (int k = 0; k < 50; ++k) {
+        struct Cl *c = pset->cl[rand_uniform_int(0, pset->size)];
+        c->exp += rand_uniform_int(0, 20);
+        c->fit = c->num * rand_uniform(0.01, 1);
+        clset_del_touch(&xcsf, c);
+        struct Cl *new_cl = cl_alloc(&xcsf);
+        cl_init(&xcsf, new_cl, rand_uniform(1, 20), 0);
+        cl_rand(&xcsf, new_cl);
+        new_cl->exp = rand_uniform_int(0, 40);
+        new_cl->mtotal = 1;
+        clset_pset_add(&xcsf, new_cl);
+        rand_init_seed(k);
+        const int expected = roulette(&xcsf);
+        rand_init_seed(k);
+        clset_del_prepare(&xcsf);
+        CHECK_EQ(clset_del_select(&xcsf), expected);
+    }
+    /* test rules that never match are selected first */
+    pset->cl[17]->mtotal = 0;
+    pset->cl[17]->age = 101;
+    clset_del_touch(&xcsf, pset->cl[17]);
+    pset->cl[42]->mtotal = 0;
+    pset->cl[42]->age = 101;
+    clset_del_aged(&xcsf, pset->cl[42], 1, 0);
+    clset_del_prepare(&xcsf);
+    CHECK_EQ(clset_del_select(&xcsf), 17);
+    while (pset->cl[17]->mtotal == 0) {
+        CHECK_EQ(clset_del_select(&xcsf), 17);
+        delete_rule(&xcsf, 17);
+    }
+    CHECK_EQ(clset_del_select(&xcsf), 42);
+    /* test a probationary rule that matches during prediction survives */
+    double x[4];
+    for (int i = 0; i < 4; ++i) {
+        x[i] = rand_uniform(0, 1);
+    }
+    cond_cover(&xcsf, pset->cl[42], x);
+    clset_soa_invalidate(&xcsf);
+    param_set_explore(&xcsf, false);
+    clset_init(&xcsf.mset);
+    clset_match(&xcsf, x, false);
+    clset_free(&xcsf.mset);
+    CHECK_EQ(pset->cl[42]->mtotal, 1);
+    for (int k = 0; k < 20; ++k) {
+        rand_init_seed(k);
+        const int expected = roulette(&xcsf);
+        rand_init_seed(k);
+        clset_del_prepare(&xcsf);
+        CHECK_EQ(clset_del_select(&xcsf), expected);
+    }
+    /* test clean up */
+    clset_kill(&xcsf, &xcsf.kset);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
@@ -0,0 +1,121 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_soa_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief SoA batch matching tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/clset_soa.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+/**
+ * @brief Checks the batch matcher agrees with matching each rule in turn.
+ * @param [in] xcsf The XCSF data structure.
+ */
+static void
+check_soa_match(struct XCSF *xcsf)
+{
+    double x[10];
+    for (int n = 0; n < 100; ++n) {
+        for (int i = 0; i < xcsf->x_dim; ++i) {
+            x[i] = rand_uniform(-0.1, 1.1);
+        }
+        const uint64_t *bitmap = clset_soa_match(xcsf, x);
+        for (int i = 0; i < xcsf->pset.size; ++i) {
+            const struct Cl *c = xcsf->pset.cl[i];
+            CHECK_EQ(clset_soa_bit(bitmap, i), cond_match(xcsf, c, x));
+        }
+    }
+}
+
+TEST_CASE("CLSET_SOA")
+{
+    const int types[4] = { COND_TYPE_HYPERRECTANGLE_CSR,
+                           COND_TYPE_HYPERRECTANGLE_UBR,
+                           COND_TYPE_HYPERELLIPSOID, COND_TYPE_TERNARY };
+    for (int t = 0; t < 4; ++t) {
+        struct XCSF xcsf;
+        param_init(&xcsf, 10, 1, 1);
+        param_set_random_state(&xcsf, 1);
+        param_set_pop_size(&xcsf, 200);
+        cond_param_set_type(&xcsf, types[t]);
+        cond_param_set_min(&xcsf, 0);
+        cond_param_set_max(&xcsf, 1);
+        cond_param_set_spread_min(&xcsf, 0.5);
+        cond_param_set_bits(&xcsf, 7);
+        cond_param_set_p_dontcare(&xcsf, 0.9);
+        xcsf_init(&xcsf);
+        CHECK(clset_soa_enabled(&xcsf));
+        CHECK_EQ(xcsf.pset.size, 200);
+        check_soa_match(&xcsf);
+        /* test the store follows deletions and reordering */
+        param_set_pop_size(&xcsf, 150);
+        clset_pset_enforce_limit(&xcsf);
+        CHECK_EQ(xcsf.pset.size, 150);
+        check_soa_match(&xcsf);
+        /* test the store follows insertions */
+        for (int i = 0; i < 20; ++i) {
+            struct Cl *c = cl_alloc(&xcsf);
+            cl_init(&xcsf, c, 1, 0);
+            cl_rand(&xcsf, c);
+            clset_pset_add(&xcsf, c);
+        }
+        check_soa_match(&xcsf);
+        /* test the store follows compaction of the population */
+        for (int i = 0; i < xcsf.pset.size; i += 3) {
+            struct Cl *c = xcsf.pset.cl[i];
+            c->num = 0;
+            clset_add(&xcsf.kset, c);
+        }
+        clset_validate(&xcsf.pset);
+        clset_soa_refresh(&xcsf);
+        check_soa_match(&xcsf);
+        clset_kill(&xcsf, &xcsf.kset);
+        /* test updating centers disables batch matching */
+        if (types[t] != COND_TYPE_HYPERRECTANGLE_UBR &&
+            types[t] != COND_TYPE_TERNARY) {
+            cond_param_set_eta(&xcsf, 0.1);
+            CHECK(!clset_soa_enabled(&xcsf));
+            /* test centers moved meanwhile are seen once re-enabled */
+            const double x[10] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+            const double y[1] = { 0 };
+            for (int i = 0; i < xcsf.pset.size; ++i) {
+                cond_update(&xcsf, xcsf.pset.cl[i], x, y);
+            }
+            cond_param_set_eta(&xcsf, 0);
+            CHECK(clset_soa_enabled(&xcsf));
+            check_soa_match(&xcsf);
+        }
+        xcsf_free(&xcsf);
+        param_free(&xcsf);
+    }
+}
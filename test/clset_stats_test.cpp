@@ -0,0 +1,85 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_stats_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Running population statistics tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/clset_stats.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_CASE("CLSET_STATS")
+{
+    const int n_samples = 50;
+    const int x_dim = 2;
+    double x[100];
+    double y[50];
+    struct XCSF xcsf;
+    param_init(&xcsf, x_dim, 1, 1);
+    param_set_random_state(&xcsf, 1);
+    param_set_pop_size(&xcsf, 200);
+    param_set_e0(&xcsf, 0.05);
+    xcsf_init(&xcsf);
+    for (int i = 0; i < n_samples; ++i) {
+        x[i * x_dim] = rand_uniform(0, 1);
+        x[i * x_dim + 1] = rand_uniform(0, 1);
+        y[i] = (x[i * x_dim] > 0.5) ? 0.2 : 0.8;
+    }
+    struct Input data;
+    data.n_samples = n_samples;
+    data.x_dim = x_dim;
+    data.y_dim = 1;
+    data.x = x;
+    data.y = y;
+    /* Test the running statistics match full scans during training */
+    int n_pruned = 0;
+    for (int t = 0; t < 200; ++t) {
+        xcs_supervised_fit(&xcsf, &data, NULL, true, 10);
+        const struct Set *pset = &xcsf.pset;
+        CHECK_EQ(clset_stats_mfrac(&xcsf), clset_mfrac(&xcsf));
+        if (xcsf.stats->valid && xcsf.stats->n_cand + 1 < pset->size) {
+            ++n_pruned;
+        }
+        double cond_size = 0;
+        double pred_size = 0;
+        for (int i = 0; i < pset->size; ++i) {
+            cond_size += cl_cond_size(&xcsf, pset->cl[i]);
+            pred_size += cl_pred_size(&xcsf, pset->cl[i]);
+        }
+        CHECK_EQ(clset_mean_cond_size(&xcsf, pset), cond_size / pset->size);
+        CHECK_EQ(clset_mean_pred_size(&xcsf, pset), pred_size / pset->size);
+    }
+    CHECK(n_pruned > 0);
+    /* Test clean up */
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
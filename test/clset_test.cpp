@@ -66,8 +66,15 @@ TEST_CASE("CLSET")
     cJSON_AddItemToObject(json, "current_prediction", p);
     clset_json_insert_cl(&xcsf, json);
     cJSON_Delete(json);
+    // find the classifier; deletion may have moved it within the population
+    struct Cl *c = NULL;
+    for (int i = 0; i < xcsf.pset.size; ++i) {
+        if (xcsf.pset.cl[i]->time == 100) {
+            c = xcsf.pset.cl[i];
+        }
+    }
+    CHECK(c != NULL);
     // check the classifier
-    struct Cl *c = xcsf.pset.list->cl;
     CHECK_EQ(c->err, 0.1);
     CHECK_EQ(c->fit, 0.2);
     CHECK_EQ(c->size, 10);
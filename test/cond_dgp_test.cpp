@@ -27,6 +27,7 @@ extern "C" {
 #include "../xcsf/cl.h"
 #include "../xcsf/cond_dgp.h"
 #include "../xcsf/condition.h"
+#include "../xcsf/dgp.h"
 #include "../xcsf/param.h"
 #include "../xcsf/utils.h"
 #include "../xcsf/xcsf.h"
@@ -41,6 +42,31 @@ const double x[5] = { 0.8455260670, 0.7566081103, 0.3125093674, 0.3449376898,
 
 const double y[1] = { 0.9 };
 
+/* Updates a graph node by node for comparison with the compiled update */
+static void
+reference_update(const struct Graph *dgp, const double *in, double *state)
+{
+    double *next = (double *) malloc(sizeof(double) * dgp->n);
+    double *v = (double *) malloc(sizeof(double) * dgp->max_k);
+    for (int t = 0; t < dgp->t; ++t) {
+        for (int i = 0; i < dgp->n; ++i) {
+            for (int k = 0; k < dgp->max_k; ++k) {
+                const int c = dgp->connectivity[i * dgp->max_k + k];
+                v[k] = (c < dgp->n_inputs) ? in[c] : state[c - dgp->n_inputs];
+            }
+            double s = v[0];
+            for (int k = 1; k < dgp->max_k; ++k) {
+                s = (dgp->function[i] == 1) ? s * v[k] : s + v[k];
+            }
+            s = (dgp->function[i] == 0) ? 1 - v[0] : s;
+            next[i] = clamp(s, 0, 1);
+        }
+        memcpy(state, next, sizeof(double) * dgp->n);
+    }
+    free(next);
+    free(v);
+}
+
 TEST_CASE("COND_DGP")
 {
     /* Test initialisation */
@@ -101,6 +127,37 @@ TEST_CASE("COND_DGP")
     CHECK(!check_array_eq_int(dest_cond->dgp.connectivity,
                               src_cond->dgp.connectivity, src_cond->dgp.klen));
 
+    /* Test compiled and batch updates */
+    const struct Graph *dgp = &src_cond->dgp;
+    const int n_samples = 21;
+    double inputs[n_samples * 5];
+    double *states = (double *) malloc(sizeof(double) * n_samples * dgp->n);
+    double *expected = (double *) malloc(sizeof(double) * dgp->n);
+    for (int i = 0; i < n_samples * 5; ++i) {
+        inputs[i] = rand_uniform(0, 1);
+    }
+    graph_update_batch(dgp, inputs, n_samples, states);
+    for (int i = 0; i < n_samples; ++i) {
+        memcpy(expected, dgp->initial_state, sizeof(double) * dgp->n);
+        reference_update(dgp, &inputs[i * 5], expected);
+        graph_update(dgp, &inputs[i * 5], true);
+        CHECK(check_array_eq(dgp->state, expected, dgp->n));
+        CHECK(check_array_eq(&states[i * dgp->n], expected, dgp->n));
+    }
+
+    /* Test batch matching of stateless graphs */
+    param_set_stateful(&xcsf, false);
+    uint64_t bits = 0;
+    cond_dgp_match_batch(&xcsf, &c1, inputs, n_samples, &bits);
+    memcpy(expected, dgp->state, sizeof(double) * dgp->n);
+    for (int i = 0; i < n_samples; ++i) {
+        const bool m = cond_dgp_match(&xcsf, &c1, &inputs[i * 5]);
+        CHECK_EQ(m, (bool) ((bits >> i) & 1));
+    }
+    CHECK(check_array_eq(dgp->state, expected, dgp->n));
+    free(states);
+    free(expected);
+
     /* Test import and export */
     char *json_str = cond_dgp_json_export(&xcsf, &c1);
     struct Cl new_cl;
@@ -28,6 +28,7 @@ extern "C" {
 #include "../xcsf/cond_gp.h"
 #include "../xcsf/condition.h"
 #include "../xcsf/ea.h"
+#include "../xcsf/gp.h"
 #include "../xcsf/param.h"
 #include "../xcsf/utils.h"
 #include "../xcsf/xcsf.h"
@@ -104,6 +105,30 @@ TEST_CASE("COND_GP")
     }
     CHECK(!check_array_eq_int(dest_cond->gp.tree, src_cond->gp.tree, n));
 
+    /* Test compiled evaluation: (x0 * x1) - (x2 / (x3 + x4)) */
+    struct ArgsGPTree *args = xcsf.cond->targs;
+    const int in = 4 + args->n_constants;
+    const int prog[9] = { 1, 2, in, in + 1, 3, in + 2, 0, in + 3, in + 4 };
+    src_cond->gp.len = 9;
+    src_cond->gp.tree = (int *) realloc(src_cond->gp.tree, sizeof(int) * 9);
+    memcpy(src_cond->gp.tree, prog, sizeof(int) * 9);
+    tree_compile(&src_cond->gp);
+    CHECK_EQ(src_cond->gp.depth, 4);
+    const double expected = (x[0] * x[1]) - (x[2] / (x[3] + x[4]));
+    CHECK_EQ(tree_eval(&src_cond->gp, args, x), doctest::Approx(expected));
+
+    /* Test batch evaluation */
+    const int n_rows = 37;
+    double rows[n_rows * 5];
+    double out[n_rows];
+    for (int i = 0; i < n_rows * 5; ++i) {
+        rows[i] = rand_uniform(-1, 1);
+    }
+    tree_eval_batch(&dest_cond->gp, args, rows, n_rows, out);
+    for (int i = 0; i < n_rows; ++i) {
+        CHECK_EQ(out[i], tree_eval(&dest_cond->gp, args, &rows[i * 5]));
+    }
+
     /* Smoke test export */
     CHECK(cond_gp_json_export(&xcsf, &c1) != NULL);
 
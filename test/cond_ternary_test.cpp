@@ -36,6 +36,27 @@ extern "C" {
 #include <string.h>
 }
 
+/**
+ * @brief Sets the packed masks of a ternary condition from a bitstring.
+ * @param [in] cond The ternary condition to set.
+ * @param [in] string The ternary bitstring.
+ */
+static void
+set_string(struct CondTernary *cond, const char *string)
+{
+    memset(cond->care, 0, sizeof(uint64_t) * cond->n_words);
+    memset(cond->value, 0, sizeof(uint64_t) * cond->n_words);
+    for (int i = 0; i < cond->length; ++i) {
+        const uint64_t bit = (uint64_t) 1 << (i % 64);
+        if (string[i] != '#') {
+            cond->care[i / 64] |= bit;
+        }
+        if (string[i] == '1') {
+            cond->value[i / 64] |= bit;
+        }
+    }
+}
+
 TEST_CASE("COND_TERNARY")
 {
     /* Test initialisation */
@@ -57,21 +78,21 @@ TEST_CASE("COND_TERNARY")
 
     /* test for true match condition */
     const char *true_1 = "1100010110";
-    memcpy(p->string, true_1, sizeof(char) * 10);
+    set_string(p, true_1);
     bool match = cond_ternary_match(&xcsf, &c1, x);
     CHECK_EQ(match, true);
     const char *true_2 = "1#00#101#0";
-    memcpy(p->string, true_2, sizeof(char) * 10);
+    set_string(p, true_2);
     match = cond_ternary_match(&xcsf, &c1, x);
     CHECK_EQ(match, true);
 
     /* test for false match condition */
     const char *false_1 = "1100000110";
-    memcpy(p->string, false_1, sizeof(char) * 10);
+    set_string(p, false_1);
     match = cond_ternary_match(&xcsf, &c1, x);
     CHECK_EQ(match, false);
     const char *false_2 = "0#00#101#0";
-    memcpy(p->string, false_2, sizeof(char) * 10);
+    set_string(p, false_2);
     match = cond_ternary_match(&xcsf, &c1, x);
     CHECK_EQ(match, false);
 
@@ -82,7 +103,7 @@ TEST_CASE("COND_TERNARY")
     cond_ternary_init(&xcsf, &c2);
     struct CondTernary *p2 = (struct CondTernary *) c2.cond;
     const char *spec = "0000#101#0";
-    memcpy(p2->string, spec, sizeof(char) * 10);
+    set_string(p2, spec);
     bool general = cond_ternary_general(&xcsf, &c1, &c2);
     CHECK_EQ(general, true);
     general = cond_ternary_general(&xcsf, &c2, &c1);
@@ -107,8 +128,9 @@ TEST_CASE("COND_TERNARY")
     struct CondTernary *dest_cond = (struct CondTernary *) dest_cl.cond;
     struct CondTernary *src_cond = (struct CondTernary *) c1.cond;
     CHECK_EQ(dest_cond->length, src_cond->length);
-    for (int i = 0; i < src_cond->length; ++i) {
-        CHECK_EQ(dest_cond->string[i], src_cond->string[i]);
+    for (int i = 0; i < src_cond->n_words; ++i) {
+        CHECK_EQ(dest_cond->care[i], src_cond->care[i]);
+        CHECK_EQ(dest_cond->value[i], src_cond->value[i]);
     }
     for (int i = 0; i < 1; ++i) {
         CHECK_EQ(dest_cond->mu[i], src_cond->mu[i]);
@@ -124,8 +146,9 @@ TEST_CASE("COND_TERNARY")
     cond_ternary_json_import(&xcsf, &new_cl, json);
     struct CondTernary *new_cond = (struct CondTernary *) new_cl.cond;
     CHECK_EQ(new_cond->length, src_cond->length);
-    for (int i = 0; i < src_cond->length; ++i) {
-        CHECK_EQ(new_cond->string[i], src_cond->string[i]);
+    for (int i = 0; i < src_cond->n_words; ++i) {
+        CHECK_EQ(new_cond->care[i], src_cond->care[i]);
+        CHECK_EQ(new_cond->value[i], src_cond->value[i]);
     }
     CHECK(check_array_eq(new_cond->mu, src_cond->mu, 1));
     free(json_str);
@@ -134,8 +157,9 @@ TEST_CASE("COND_TERNARY")
     /* test mutation */
     CHECK(cond_ternary_mutate(&xcsf, &c1));
     bool equal = true;
-    for (int i = 0; i < src_cond->length; ++i) {
-        if (new_cond->string[i] != src_cond->string[i]) {
+    for (int i = 0; i < src_cond->n_words; ++i) {
+        if (new_cond->care[i] != src_cond->care[i] ||
+            new_cond->value[i] != src_cond->value[i]) {
             equal = false;
         }
     }
@@ -153,12 +177,17 @@ TEST_CASE("COND_TERNARY")
     CHECK(json_rtn == NULL);
 
     /* test serialisation */
+    char *saved_str = cond_ternary_json_export(&xcsf, &c1);
     FILE *fp = fopen("temp.bin", "wb");
     size_t s = cond_ternary_save(&xcsf, &c1, fp);
     fclose(fp);
     fp = fopen("temp.bin", "rb");
     size_t r = cond_ternary_load(&xcsf, &c1, fp);
     CHECK_EQ(s, r);
+    char *loaded_str = cond_ternary_json_export(&xcsf, &c1);
+    CHECK_EQ(strcmp(saved_str, loaded_str), 0);
+    free(saved_str);
+    free(loaded_str);
 
     /* clean up */
     cond_ternary_free(&xcsf, &c1);
@@ -0,0 +1,91 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file ea_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Evolutionary algorithm tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/ea.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_CASE("EA")
+{
+    /* Test initialisation */
+    struct XCSF xcsf;
+    param_init(&xcsf, 4, 1, 1);
+    param_set_random_state(&xcsf, 1);
+    param_set_omp_num_threads(&xcsf, 4);
+    param_set_pop_size(&xcsf, 20);
+    xcsf_init(&xcsf);
+    cond_param_set_type(&xcsf, COND_TYPE_NEURAL);
+    ea_param_set_theta(&xcsf, 0);
+    ea_param_set_lambda(&xcsf, 9);
+    ea_param_set_p_crossover(&xcsf, 1);
+    clset_pset_init(&xcsf);
+    CHECK_EQ(xcsf.pset.num, 20);
+    struct Set set;
+    clset_init(&set);
+    for (int i = 0; i < xcsf.pset.size; ++i) {
+        clset_add(&set, xcsf.pset.cl[i]);
+    }
+
+    /* Test offspring of an odd lambda are all inserted */
+    param_set_pop_size(&xcsf, 100);
+    ea(&xcsf, &set);
+    CHECK_EQ(xcsf.time, 1);
+    CHECK_EQ(xcsf.pset.num, 30);
+    int num = 0;
+    for (int i = 0; i < xcsf.pset.size; ++i) {
+        const struct Cl *c = xcsf.pset.cl[i];
+        CHECK(c->cond != NULL);
+        CHECK(c->prediction != NULL);
+        CHECK(c->time == 0 || c->time == 1);
+        num += c->num;
+    }
+    CHECK_EQ(num, xcsf.pset.num);
+
+    /* Test repeated invocations respect the population limit */
+    param_set_pop_size(&xcsf, 25);
+    for (int i = 0; i < 10; ++i) {
+        clset_free(&set);
+        for (int j = 0; j < xcsf.pset.size; ++j) {
+            clset_add(&set, xcsf.pset.cl[j]);
+        }
+        ea(&xcsf, &set);
+        CHECK_EQ(xcsf.pset.num, 25);
+    }
+
+    /* Test clean up */
+    clset_free(&set);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
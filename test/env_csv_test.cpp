@@ -0,0 +1,91 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file env_csv_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief CSV environment tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/env_csv.h"
+#include "../xcsf/param.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+static const char *names[4] = { "temp_train_x.csv", "temp_train_y.csv",
+                                "temp_test_x.csv", "temp_test_y.csv" };
+
+TEST_CASE("ENV_CSV")
+{
+    /* Test wide rows, CRLF endings, blank lines and no final newline */
+    const int x_dim = 40;
+    for (int f = 0; f < 4; ++f) {
+        FILE *fp = fopen(names[f], "w");
+        const int dim = (f % 2 == 0) ? x_dim : 1;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < dim; ++j) {
+                fprintf(fp, "%s%.10f", (j > 0) ? "," : "", i + j * 0.001);
+            }
+            fprintf(fp, (i == 0) ? "\r\n\n" : (i == 1) ? "\n" : "");
+        }
+        fclose(fp);
+    }
+    /* Test the csv files and then their binary sidecars */
+    for (int pass = 0; pass < 2; ++pass) {
+        struct XCSF xcsf;
+        env_csv_init(&xcsf, "temp");
+        const struct EnvCSV *env = (const struct EnvCSV *) xcsf.env;
+        CHECK_EQ(env->train_data->n_samples, 3);
+        CHECK_EQ(env->train_data->x_dim, x_dim);
+        CHECK_EQ(env->train_data->y_dim, 1);
+        CHECK_EQ(env->test_data->n_samples, 3);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < x_dim; ++j) {
+                CHECK_EQ(env->train_data->x[i * x_dim + j],
+                         doctest::Approx(i + j * 0.001));
+            }
+            CHECK_EQ(env->test_data->y[i], doctest::Approx(i));
+        }
+        env_csv_free(&xcsf);
+        param_free(&xcsf);
+    }
+    /* Test a csv file rewritten after its sidecar is parsed again */
+    FILE *fp = fopen(names[3], "w");
+    fprintf(fp, "10\n11\n12\n");
+    fclose(fp);
+    struct XCSF xcsf;
+    env_csv_init(&xcsf, "temp");
+    const struct EnvCSV *env = (const struct EnvCSV *) xcsf.env;
+    for (int i = 0; i < 3; ++i) {
+        CHECK_EQ(env->test_data->y[i], doctest::Approx(10 + i));
+    }
+    env_csv_free(&xcsf);
+    param_free(&xcsf);
+    for (int f = 0; f < 4; ++f) {
+        char sidecar[64];
+        snprintf(sidecar, sizeof(sidecar), "%s.bin", names[f]);
+        remove(names[f]);
+        remove(sidecar);
+    }
+}
@@ -74,17 +74,17 @@ TEST_CASE("NEURAL_ACTIVATIONS")
 
     /* Test array activation */
     const int x_dim = 4;
-    double state[4] = { 0.1, 0.2, 0.3, 0.4 };
-    double output[4] = { 0, 0, 0, 0 };
-    double active[4] = { 0.524979, 0.549834, 0.574443, 0.598688 };
+    real state[4] = { 0.1, 0.2, 0.3, 0.4 };
+    real output[4] = { 0, 0, 0, 0 };
+    real active[4] = { 0.524979, 0.549834, 0.574443, 0.598688 };
     neural_activate_array(state, output, x_dim, LOGISTIC);
     for (int i = 0; i < x_dim; ++i) {
         CHECK_EQ(output[i], doctest::Approx(active[i]));
     }
 
     /* Test array gradient */
-    double delta[4] = { 1, 1, 1, 1 };
-    double gradient[4] = { 0.249376, 0.247517, 0.244458, 0.240261 };
+    real delta[4] = { 1, 1, 1, 1 };
+    real gradient[4] = { 0.249376, 0.247517, 0.244458, 0.240261 };
     neural_gradient_array(state, delta, x_dim, LOGISTIC);
     for (int i = 0; i < x_dim; ++i) {
         CHECK_EQ(delta[i], doctest::Approx(gradient[i]));
@@ -73,21 +73,21 @@ TEST_CASE("NEURAL_LAYER_CONNECTED")
     CHECK_EQ(l->momentum, 0.9);
 
     /* Test one forward pass of input */
-    const double x[10] = { -0.4792173279, -0.2056298252, -0.1775459629,
-                           -0.0814486626, 0.0923277094,  0.2779675621,
-                           -0.3109822596, -0.6788371120, -0.0714929928,
-                           -0.1332985280 };
-    const double output[2] = { 0.7936726123, 0.0963342482 };
-    const double orig_weights[20] = {
+    const real x[10] = { -0.4792173279, -0.2056298252, -0.1775459629,
+                         -0.0814486626, 0.0923277094,  0.2779675621,
+                         -0.3109822596, -0.6788371120, -0.0714929928,
+                         -0.1332985280 };
+    const real output[2] = { 0.7936726123, 0.0963342482 };
+    const real orig_weights[20] = {
         0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
         2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
         -1.5489524535, -2.0932767781, 5.4797621223,  0.3326639519,
         -0.4446678553, 0.1033557369,  -1.2581317787, 2.8042169798,
         0.2236021733,  -1.2206964138, -0.2022042865, -1.5489524535
     };
-    const double orig_biases[2] = { 0.1033557369, -1.2581317787 };
-    memcpy(l->weights, orig_weights, sizeof(double) * l->n_weights);
-    memcpy(l->biases, orig_biases, sizeof(double) * l->n_outputs);
+    const real orig_biases[2] = { 0.1033557369, -1.2581317787 };
+    memcpy(l->weights, orig_weights, sizeof(real) * l->n_weights);
+    memcpy(l->biases, orig_biases, sizeof(real) * l->n_outputs);
     neural_layer_connected_forward(l, &net, x);
     double output_error = 0;
     for (int i = 0; i < l->n_outputs; ++i) {
@@ -96,15 +96,15 @@ TEST_CASE("NEURAL_LAYER_CONNECTED")
     CHECK_EQ(doctest::Approx(output_error), 0);
 
     /* Test one backward pass of input */
-    const double y[2] = { 0.7343893899, 0.2289711363 };
-    const double new_weights[20] = {
+    const real y[2] = { 0.7343893899, 0.2289711363 };
+    const real new_weights[20] = {
         0.3331291764,  -0.4444682297, 0.1035280986,  -1.2580527083,
         2.8041273480,  0.2233323222,  -1.2203945120, -0.2015452710,
         -1.5488830481, -2.0931473718, 5.4792087908,  0.3324265201,
         -0.4448728599, 0.1032616917,  -1.2580251719, 2.8045379369,
         0.2232430956,  -1.2214802376, -0.2022868364, -1.5491063675
     };
-    const double new_biases[2] = { 0.1023849362, -1.2569771221 };
+    const real new_biases[2] = { 0.1023849362, -1.2569771221 };
     for (int i = 0; i < l->n_outputs; ++i) {
         l->delta[i] = y[i] - l->output[i];
     }
@@ -122,14 +122,14 @@ TEST_CASE("NEURAL_LAYER_CONNECTED")
     CHECK_EQ(doctest::Approx(bias_error), 0);
 
     /* Test convergence on one input */
-    const double conv_weights[20] = {
+    const real conv_weights[20] = {
         0.4127301724,  -0.4103118294, 0.1330195938,  -1.2445235759,
         2.7887911379,  0.1771601713,  -1.1687384133, -0.0887861801,
         -1.5370076147, -2.0710056524, 5.2313215338,  0.2260593034,
         -0.5367129900, 0.0611303154,  -1.2102663341, 2.9483236736,
         0.0623796734,  -1.5726258658, -0.2392683912, -1.6180583952
     };
-    const double conv_biases[2] = { -0.0637213195, -0.7397018847 };
+    const real conv_biases[2] = { -0.0637213195, -0.7397018847 };
     for (int i = 0; i < 200; ++i) {
         neural_layer_connected_forward(l, &net, x);
         for (int j = 0; j < l->n_outputs; ++j) {
@@ -182,9 +182,14 @@ TEST_CASE("NEURAL_LAYER_CONNECTED")
     for (int i = 0; i < 6; ++i) {
         CHECK(l->mu[i] == l2->mu[i]);
     }
+    CHECK(l->weights == l2->weights);
+    CHECK_EQ(*l->share, 2);
 
     /* Test randomisation */
     neural_layer_connected_rand(l);
+    CHECK(l->weights != l2->weights);
+    CHECK_EQ(*l->share, 1);
+    CHECK_EQ(*l2->share, 1);
     for (int i = 0; i < l->n_weights; ++i) {
         CHECK(l->weights[i] != l2->weights[i]);
     }
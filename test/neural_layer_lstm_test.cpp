@@ -72,12 +72,22 @@ TEST_CASE("NEURAL_LAYER_LSTM")
     CHECK_EQ(l->max_outputs, 1);
     CHECK_EQ(l->n_weights, 8);
 
+    /* Test the gates view two stacked connected layers */
+    CHECK_EQ(l->input_layer->n_outputs, 4);
+    CHECK_EQ(l->self_layer->n_outputs, 4);
+    CHECK(l->uf->weights == l->input_layer->weights);
+    CHECK(l->ui->weights == l->uf->weights + l->uf->n_weights);
+    CHECK(l->ug->weights == l->ui->weights + l->ui->n_weights);
+    CHECK(l->uo->weights == l->ug->weights + l->ug->n_weights);
+    CHECK(l->uo->biases == l->input_layer->biases + 3);
+    CHECK(l->wo->weights == l->self_layer->weights + 3);
+
     /* Test forward passing input */
-    const double x[1] = { 0.90598097 };
-    const double orig_weights[8] = { 0.1866107,   -0.6872276,  1.0366809,
-                                     -0.02821708, -0.21004653, 0.4503114,
-                                     0.49545765,  0.71247584 };
-    const double orig_biases[4] = { 0, 1, 0, 0 };
+    const real x[1] = { 0.90598097 };
+    const real orig_weights[8] = { 0.1866107,   -0.6872276,  1.0366809,
+                                   -0.02821708, -0.21004653, 0.4503114,
+                                   0.49545765,  0.71247584 };
+    const real orig_biases[4] = { 0, 1, 0, 0 };
     l->ui->weights[0] = orig_weights[0];
     l->uf->weights[0] = orig_weights[1];
     l->ug->weights[0] = orig_weights[2];
@@ -105,7 +115,7 @@ TEST_CASE("NEURAL_LAYER_LSTM")
     CHECK_EQ(doctest::Approx(l->output[0]), 0.37268567);
 
     /* Test one backward pass of input */
-    const double y[1] = { 0.946146918 };
+    const real y[1] = { 0.946146918 };
     for (int i = 0; i < l->n_outputs; ++i) {
         l->delta[i] = y[i] - l->output[i];
     }
@@ -166,6 +176,9 @@ TEST_CASE("NEURAL_LAYER_LSTM")
 
     /* Test randomisation */
     neural_layer_lstm_rand(l);
+    CHECK(l->input_layer->weights != l2->input_layer->weights);
+    CHECK(l->uf->weights == l->input_layer->weights);
+    CHECK(l->wf->weights == l->self_layer->weights);
     for (int i = 0; i < l->uf->n_weights; ++i) {
         CHECK(l->uf->weights[i] != l2->uf->weights[i]);
     }
@@ -199,6 +212,36 @@ TEST_CASE("NEURAL_LAYER_LSTM")
     size_t r = neural_layer_lstm_load(l, fp);
     CHECK_EQ(w, r);
     fclose(fp);
+    struct Layer *l3 = (struct Layer *) malloc(sizeof(struct Layer));
+    layer_defaults(l3);
+    l3->type = LSTM;
+    layer_set_vptr(l3);
+    fp = fopen("temp.bin", "rb");
+    r = neural_layer_lstm_load(l3, fp);
+    CHECK_EQ(w, r);
+    fclose(fp);
+    CHECK(l3->ug->weights == l3->input_layer->weights + 2);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(l3->input_layer->weights[i] == l->input_layer->weights[i]);
+        CHECK(l3->self_layer->biases[i] == l->self_layer->biases[i]);
+    }
+
+    /* Test resizing the input of each gate */
+    struct Layer prev;
+    layer_defaults(&prev);
+    prev.n_outputs = 3;
+    neural_layer_lstm_resize(l3, &prev);
+    CHECK_EQ(l3->n_inputs, 3);
+    CHECK_EQ(l3->input_layer->n_weights, 12);
+    CHECK_EQ(l3->n_weights, 16);
+    CHECK(l3->ui->weights == l3->input_layer->weights + 3);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(l3->input_layer->weights[3 * i] == l->input_layer->weights[i]);
+    }
+    neural_layer_lstm_free(l3);
+    free(l3);
+    neural_layer_lstm_free(l2);
+    free(l2);
 
     /* Test clean */
     neural_free(&net);
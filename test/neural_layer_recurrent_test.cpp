@@ -64,6 +64,7 @@ TEST_CASE("NEURAL_LAYER_RECURRENT")
     args.decay = 0;
     args.sgd_weights = true;
     args.evolve_neurons = true;
+    args.max_neuron_grow = 1;
     args.evolve_connect = true;
     args.evolve_weights = true;
     args.evolve_functions = true;
@@ -75,9 +76,9 @@ TEST_CASE("NEURAL_LAYER_RECURRENT")
     CHECK_EQ(l->max_outputs, 1);
 
     /* test forward passing input */
-    const double x[1] = { 0.90598097 };
-    const double orig_weights[2] = { -0.0735234, -1 };
-    const double orig_biases[1] = { 0 };
+    const real x[1] = { 0.90598097 };
+    const real orig_weights[2] = { -0.0735234, -1 };
+    const real orig_biases[1] = { 0 };
     l->input_layer->weights[0] = orig_weights[0];
     l->input_layer->biases[0] = orig_biases[0];
     l->self_layer->weights[0] = orig_weights[1];
@@ -98,7 +99,7 @@ TEST_CASE("NEURAL_LAYER_RECURRENT")
     CHECK_EQ(doctest::Approx(output_error), 0);
 
     /* test one backward pass of input */
-    const double y[1] = { 0.946146918 };
+    const real y[1] = { 0.946146918 };
     for (int i = 0; i < l->n_outputs; ++i) {
         l->delta[i] = y[i] - l->output[i];
     }
@@ -122,9 +123,9 @@ TEST_CASE("NEURAL_LAYER_RECURRENT")
     CHECK_EQ(doctest::Approx(l->output[0]), y[0]);
 
     /* Test mutation */
-    double *lw = (double *) malloc(sizeof(double) * l->input_layer->n_weights);
+    real *lw = (real *) malloc(sizeof(real) * l->input_layer->n_weights);
     memcpy(lw, l->input_layer->weights,
-           sizeof(double) * l->input_layer->n_weights);
+           sizeof(real) * l->input_layer->n_weights);
     CHECK(neural_layer_recurrent_mutate(l));
     for (int i = 0; i < l->input_layer->n_weights; ++i) {
         CHECK(l->input_layer->weights[i] != lw[i]);
@@ -64,10 +64,10 @@ TEST_CASE("NEURAL_LAYER_SOFTMAX")
     CHECK_EQ(l->scale, 1);
 
     /* Test one forward pass of input */
-    const double x[3] = { 0.2, 0.5, 0.3 };
-    const double output[3] = { 0.289433, 0.390694, 0.319873 };
+    const real x[3] = { 0.2, 0.5, 0.3 };
+    const real output[3] = { 0.289433, 0.390694, 0.319873 };
     neural_layer_softmax_forward(l, &net, x);
-    double *out = neural_layer_softmax_output(l);
+    real *out = neural_layer_softmax_output(l);
     double sum = 0;
     for (int i = 0; i < l->n_outputs; ++i) {
         CHECK_EQ(doctest::Approx(out[i]), output[i]);
@@ -76,8 +76,8 @@ TEST_CASE("NEURAL_LAYER_SOFTMAX")
     CHECK_EQ(doctest::Approx(sum), 1);
 
     /* Test one backward pass of input */
-    double delta[3] = { 0.2, 0.3, 0.4 };
-    memcpy(l->delta, delta, sizeof(double) * 3);
+    real delta[3] = { 0.2, 0.3, 0.4 };
+    memcpy(l->delta, delta, sizeof(real) * 3);
     neural_layer_softmax_backward(l, &net, x, delta);
     for (int i = 0; i < 3; ++i) {
         CHECK_EQ(doctest::Approx(l->delta[i] * 2), delta[i]);
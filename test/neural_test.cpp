@@ -54,17 +54,17 @@ TEST_CASE("NEURAL")
                            -0.3109822596, -0.6788371120, -0.0714929928,
                            -0.1332985280 };
     const double output[2] = { 0.5804315660, 0.2146193788 };
-    const double orig_weights1[20] = {
+    const real orig_weights1[20] = {
         0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
         2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
         -1.5489524535, -2.0932767781, 5.4797621223,  0.3326639519,
         -0.4446678553, 0.1033557369,  -1.2581317787, 2.8042169798,
         0.2236021733,  -1.2206964138, -0.2022042865, -1.5489524535
     };
-    const double orig_biases1[2] = { 0.1033557369, -1.2581317787 };
-    const double orig_weights2[4] = { 0.3326639519, -0.4446678553, 0.1033557369,
-                                      -1.2581317787 };
-    const double orig_biases2[2] = { 0.1033557369, -1.2581317787 };
+    const real orig_biases1[2] = { 0.1033557369, -1.2581317787 };
+    const real orig_weights2[4] = { 0.3326639519, -0.4446678553, 0.1033557369,
+                                    -1.2581317787 };
+    const real orig_biases2[2] = { 0.1033557369, -1.2581317787 };
     neural_init(&net);
     struct ArgsLayer args;
     layer_args_init(&args);
@@ -78,13 +78,13 @@ TEST_CASE("NEURAL")
     args.decay = 0;
     args.sgd_weights = true;
     l = layer_init(&args);
-    memcpy(l->weights, orig_weights1, sizeof(double) * l->n_weights);
-    memcpy(l->biases, orig_biases1, sizeof(double) * l->n_outputs);
+    memcpy(l->weights, orig_weights1, sizeof(real) * l->n_weights);
+    memcpy(l->biases, orig_biases1, sizeof(real) * l->n_outputs);
     neural_push(&net, l);
     args.n_inputs = 2;
     l = layer_init(&args);
-    memcpy(l->weights, orig_weights2, sizeof(double) * l->n_weights);
-    memcpy(l->biases, orig_biases2, sizeof(double) * l->n_outputs);
+    memcpy(l->weights, orig_weights2, sizeof(real) * l->n_weights);
+    memcpy(l->biases, orig_biases2, sizeof(real) * l->n_outputs);
     neural_push(&net, l);
     neural_propagate(&net, x, false);
     double output_error = 0;
@@ -102,6 +102,30 @@ TEST_CASE("NEURAL")
     CHECK_EQ(doctest::Approx(neural_output(&net, 0)), y[0]);
     CHECK_EQ(doctest::Approx(neural_output(&net, 1)), y[1]);
 
+    /* Test a mini-batch of identical samples matches a single update */
+    struct Net batch_net;
+    struct Net single_net;
+    neural_copy(&batch_net, &net);
+    neural_copy(&single_net, &net);
+    const double z[2] = { 0.1, 0.9 };
+    double batch_x[40];
+    double batch_y[8];
+    for (int i = 0; i < 4; ++i) {
+        memcpy(&batch_x[i * 10], x, sizeof(double) * 10);
+        memcpy(&batch_y[i * 2], z, sizeof(double) * 2);
+    }
+    neural_learn_batch(&batch_net, batch_y, batch_x, 4);
+    neural_propagate(&single_net, x, false);
+    neural_learn(&single_net, z, x);
+    neural_propagate(&batch_net, x, false);
+    neural_propagate(&single_net, x, false);
+    CHECK_EQ(doctest::Approx(neural_output(&batch_net, 0)),
+             neural_output(&single_net, 0));
+    CHECK_EQ(doctest::Approx(neural_output(&batch_net, 1)),
+             neural_output(&single_net, 1));
+    neural_free(&batch_net);
+    neural_free(&single_net);
+
     /* Smoke test export */
     char *str = neural_json_export(&net, true);
     CHECK(str != NULL);
@@ -54,10 +54,10 @@ TEST_CASE("PA")
     double pa3[5] = { 0.6423, 0.6423, 0.6423, 0.6423, 0.445 };
     xcsf.pa = pa3;
     action = pa_best_action(&xcsf);
-    CHECK_EQ(action, 1);
+    CHECK_EQ(action, 3);
 
     action = pa_best_action(&xcsf);
-    CHECK_EQ(action, 2);
+    CHECK_EQ(action, 0);
 
     action = pa_best_action(&xcsf);
     CHECK_EQ(action, 0);
@@ -0,0 +1,68 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pool_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Slab allocator tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/pool.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_CASE("POOL")
+{
+    struct Pool *pool = pool_init();
+    /* Test blocks are aligned, disjoint, and zeroed by calloc */
+    const int n = 5000;
+    double **blocks = (double **) malloc(sizeof(double *) * n);
+    for (int i = 0; i < n; ++i) {
+        const int len = 1 + i % 40;
+        blocks[i] = (double *) pool_calloc(pool, len, sizeof(double));
+        CHECK_EQ((uintptr_t) blocks[i] % POOL_GRAIN, 0);
+        for (int j = 0; j < len; ++j) {
+            CHECK_EQ(blocks[i][j], 0);
+            blocks[i][j] = i;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        const int len = 1 + i % 40;
+        for (int j = 0; j < len; ++j) {
+            CHECK_EQ(blocks[i][j], i);
+        }
+    }
+    /* Test released blocks are reused by the same size class */
+    void *p = blocks[7];
+    pool_free(pool, p);
+    CHECK_EQ(pool_malloc(pool, sizeof(double) * 8), p);
+    pool_free(pool, NULL);
+    /* Test requests beyond the largest class */
+    const size_t large = POOL_GRAIN * POOL_CLASSES + 1;
+    char *big = (char *) pool_malloc(pool, large);
+    memset(big, 1, large);
+    pool_free(pool, big);
+    pool_destroy(pool);
+    free(blocks);
+}
@@ -78,19 +78,19 @@ TEST_CASE("PRED_NEURAL")
     CHECK(pred_neural_mutate(&xcsf, &c));
 
     /* test size */
-    CHECK_EQ(pred_neural_size(&xcsf, &c), 108);
+    CHECK_EQ(pred_neural_size(&xcsf, &c), 114);
 
     /* Test n layers */
     CHECK_EQ(pred_neural_layers(&xcsf, &c), 2);
 
     /* Test n neurons */
-    CHECK_EQ(pred_neural_neurons(&xcsf, &c, 0), 10);
+    CHECK_EQ(pred_neural_neurons(&xcsf, &c, 0), 11);
 
     /* Test n connections */
-    CHECK_EQ(pred_neural_connections(&xcsf, &c, 0), 98);
+    CHECK_EQ(pred_neural_connections(&xcsf, &c, 0), 103);
 
     /* Test eta */
-    CHECK_EQ(pred_neural_eta(&xcsf, &c, 0), doctest::Approx(0.00685845));
+    CHECK_EQ(pred_neural_eta(&xcsf, &c, 0), doctest::Approx(0));
 
     /* Test export */
     char *json_str = pred_neural_json_export(&xcsf, &c);
@@ -108,7 +108,8 @@ TEST_CASE("PRED_NEURAL")
                             "\"layer_1\": {"
                             "\"type\": \"connected\","
                             "\"activation\": \"linear\""
-                            "}"
+                            "},"
+                            "\"batch_size\": 4"
                             "}";
     cJSON *json = cJSON_Parse(param_str);
     char *ret = pred_neural_param_json_import(&xcsf, json->child);
@@ -119,6 +120,36 @@ TEST_CASE("PRED_NEURAL")
     CHECK(xcsf.pred->largs->next->type == layer_type_as_int("connected"));
     CHECK(xcsf.pred->largs->next->function ==
           neural_activation_as_int("linear"));
+    CHECK_EQ(xcsf.pred->batch_size, 4);
+    CHECK(xcsf.pred->largs->next->next == NULL);
+
+    /* Test young rules are updated after every sample */
+    const struct PredNeural *pred = (const struct PredNeural *) c.pred;
+    for (int i = 1; i < 4; ++i) {
+        c.exp = i;
+        pred_neural_update(&xcsf, &c, x, y);
+        CHECK_EQ(pred->batch_n, 0);
+    }
+
+    /* Test mini-batch update */
+    c.exp = 4;
+    for (int i = 0; i < 3; ++i) {
+        pred_neural_update(&xcsf, &c, x, y);
+        CHECK_EQ(pred->batch_n, i + 1);
+    }
+    pred_neural_update(&xcsf, &c, x, y);
+    CHECK_EQ(pred->batch_n, 0);
+
+    /* Test the mini-batch buffers grow with the batch size */
+    pred_param_set_batch_size(&xcsf, 8);
+    c.exp = 8;
+    for (int i = 0; i < 7; ++i) {
+        pred_neural_update(&xcsf, &c, x, y);
+    }
+    CHECK_EQ(pred->batch_n, 7);
+    CHECK_EQ(pred->batch_max, 8);
+    pred_neural_update(&xcsf, &c, x, y);
+    CHECK_EQ(pred->batch_n, 0);
 
     /* Test save */
     FILE *fp = fopen("temp.bin", "wb");
@@ -136,6 +167,35 @@ TEST_CASE("PRED_NEURAL")
     /* Test ae to classifier */
     pred_neural_ae_to_classifier(&xcsf, &c, 1);
 
+    /* Test recurrent networks are updated after every sample */
+    const char *rnn_str = "{"
+                          "\"layer_0\": {"
+                          "\"type\": \"recurrent\","
+                          "\"activation\": \"relu\","
+                          "\"n_init\": 5"
+                          "},"
+                          "\"layer_1\": {"
+                          "\"type\": \"connected\","
+                          "\"activation\": \"linear\","
+                          "\"n_init\": 1"
+                          "},"
+                          "\"batch_size\": 4"
+                          "}";
+    cJSON *rnn_json = cJSON_Parse(rnn_str);
+    ret = pred_neural_param_json_import(&xcsf, rnn_json->child);
+    CHECK(ret == NULL);
+    cJSON_Delete(rnn_json);
+    struct Cl rnn_cl;
+    cl_init(&xcsf, &rnn_cl, 1, 1);
+    pred_neural_init(&xcsf, &rnn_cl);
+    const struct PredNeural *rnn = (const struct PredNeural *) rnn_cl.pred;
+    CHECK(neural_stateful(&rnn->net));
+    pred_neural_compute(&xcsf, &rnn_cl, x);
+    pred_neural_update(&xcsf, &rnn_cl, x, y);
+    CHECK_EQ(rnn->batch_n, 0);
+    CHECK(rnn->batch_x == NULL);
+    pred_neural_free(&xcsf, &rnn_cl);
+
     /* Clean up */
     xcsf_free(&xcsf);
     param_free(&xcsf);
@@ -0,0 +1,66 @@
+#!/usr/bin/python3
+#
+# Copyright (C) 2023 Richard Preen <rpreen@gmail.com>
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Tests pickling XCSF through in-memory buffers."""
+
+from __future__ import annotations
+
+import multiprocessing
+import pickle
+
+import numpy as np
+
+import xcsf
+
+
+def _predict(model: xcsf.XCS, x_data: np.ndarray) -> np.ndarray:
+    """Returns the predictions of a model passed to a worker process."""
+    return model.predict(x_data, cover=np.zeros(1))
+
+
+def test_pickle_round_trip() -> None:
+    """Tests that an unpickled model makes the same predictions."""
+    rng = np.random.default_rng(1)
+    x_data = rng.random((200, 2))
+    y_data = np.where(x_data[:, :1] > 0.5, 0.2, 0.8)
+    xcs = xcsf.XCS(
+        x_dim=2,
+        y_dim=1,
+        n_actions=1,
+        random_state=1,
+        pop_size=200,
+        max_trials=1000,
+        perf_trials=100,
+    )
+    xcs.fit(x_data, y_data, verbose=False)
+    state = pickle.dumps(xcs)
+    clone = pickle.loads(state)
+    # pickling the clone reproduces the same state
+    assert pickle.dumps(clone) == state
+    assert clone.pset_size() == xcs.pset_size()
+    assert clone.pset_num() == xcs.pset_num()
+    cover = np.zeros(1)
+    expected = xcs.predict(x_data, cover=cover)
+    np.testing.assert_array_equal(clone.predict(x_data, cover=cover), expected)
+    # models pickled to and from a worker process
+    ctx = multiprocessing.get_context("spawn")
+    with ctx.Pool(1) as pool:
+        np.testing.assert_array_equal(pool.apply(_predict, (xcs, x_data)), expected)
+        returned = pool.apply(pickle.loads, (state,))
+    assert returned.pset_size() == xcs.pset_size()
+    np.testing.assert_array_equal(returned.predict(x_data, cover=cover), expected)
@@ -0,0 +1,68 @@
+#!/usr/bin/python3
+#
+# Copyright (C) 2023 Richard Preen <rpreen@gmail.com>
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Tests saving and loading memory-mapped population snapshots."""
+
+from __future__ import annotations
+
+import multiprocessing
+
+import numpy as np
+
+import xcsf
+
+
+def _predict_snapshot(filename: str, x_data: np.ndarray) -> np.ndarray:
+    """Returns the predictions of a snapshot loaded in a worker process."""
+    xcs = xcsf.XCS()
+    xcs.load_snapshot(filename)
+    return xcs.predict(x_data, cover=np.zeros(1))
+
+
+def test_snapshot_load(tmp_path) -> None:
+    """Tests that a model loaded from a snapshot makes the same predictions."""
+    rng = np.random.default_rng(1)
+    x_data = rng.random((200, 2))
+    y_data = np.where(x_data[:, :1] > 0.5, 0.2, 0.8)
+    xcs = xcsf.XCS(
+        x_dim=2,
+        y_dim=1,
+        n_actions=1,
+        random_state=1,
+        pop_size=200,
+        max_trials=1000,
+        perf_trials=100,
+    )
+    xcs.fit(x_data, y_data, verbose=False)
+    filename = str(tmp_path / "model.snap")
+    assert xcs.save_snapshot(filename) > 0
+    clone = xcsf.XCS()
+    assert clone.load_snapshot(filename) > 0
+    assert clone.pset_size() == xcs.pset_size()
+    assert clone.pset_num() == xcs.pset_num()
+    cover = np.zeros(1)
+    expected = xcs.predict(x_data, cover=cover)
+    np.testing.assert_array_equal(clone.predict(x_data, cover=cover), expected)
+    # the same snapshot loaded by another process
+    ctx = multiprocessing.get_context("spawn")
+    with ctx.Pool(1) as pool:
+        preds = pool.apply(_predict_snapshot, (filename, x_data))
+    np.testing.assert_array_equal(preds, expected)
+    # the mapped rules can be trained further
+    clone.fit(x_data, y_data, warm_start=True, verbose=False)
+    assert clone.pset_size() > 0
@@ -0,0 +1,97 @@
+#!/usr/bin/python3
+#
+# Copyright (C) 2023 Richard Preen <rpreen@gmail.com>
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Tests training from a stream of batches read from csv files."""
+
+from __future__ import annotations
+
+from itertools import islice
+
+import numpy as np
+import pytest
+
+import xcsf
+
+N_SAMPLES: int = 250
+
+
+def read_csv(x_file, y_file, batch_size: int):
+    """Yields (X, y) batches of rows read from a pair of csv files."""
+    with open(x_file, encoding="utf-8") as fx, open(y_file, encoding="utf-8") as fy:
+        while True:
+            x_lines = list(islice(fx, batch_size))
+            y_lines = list(islice(fy, batch_size))
+            if not x_lines:
+                return
+            x_batch = np.loadtxt(x_lines, delimiter=",", ndmin=2)
+            y_batch = np.loadtxt(y_lines, delimiter=",", ndmin=2)
+            yield x_batch, y_batch
+
+
+def test_fit_stream_csv(tmp_path) -> None:
+    """Tests the trials recorded when the stream ends before MAX_TRIALS."""
+    rng = np.random.default_rng(1)
+    x_data = rng.random((N_SAMPLES, 2))
+    y_data = np.where(x_data[:, :1] > 0.5, 0.2, 0.8)
+    x_file = tmp_path / "stream_x.csv"
+    y_file = tmp_path / "stream_y.csv"
+    np.savetxt(x_file, x_data, delimiter=",")
+    np.savetxt(y_file, y_data, delimiter=",")
+    xcs = xcsf.XCS(
+        x_dim=2,
+        y_dim=1,
+        n_actions=1,
+        random_state=1,
+        pop_size=200,
+        max_trials=1000,
+        perf_trials=100,
+    )
+    xcs.fit_stream(read_csv(x_file, y_file, 32), chunk_size=64, verbose=False)
+    metrics = xcs.get_metrics()
+    assert list(metrics["trials"]) == [100, 200, N_SAMPLES]
+    assert xcs.pset_size() > 0
+    # an exhausted source records nothing further
+    xcs.fit_stream(iter([]), warm_start=True, verbose=False)
+    assert list(xcs.get_metrics()["trials"]) == [100, 200, N_SAMPLES]
+
+
+def failing_source(x_data: np.ndarray, y_data: np.ndarray):
+    """Yields one (X, y) batch and then raises."""
+    yield x_data, y_data
+    raise ValueError("source failed")
+
+
+def test_fit_stream_source_error() -> None:
+    """Tests that an error raised by the source is reported after cleanup."""
+    rng = np.random.default_rng(1)
+    x_data = rng.random((N_SAMPLES, 2))
+    y_data = np.where(x_data[:, :1] > 0.5, 0.2, 0.8)
+    xcs = xcsf.XCS(
+        x_dim=2,
+        y_dim=1,
+        n_actions=1,
+        random_state=1,
+        pop_size=200,
+        max_trials=1000,
+        perf_trials=100,
+    )
+    with pytest.raises(RuntimeError, match="source failed"):
+        xcs.fit_stream(failing_source(x_data, y_data), verbose=False)
+    # the stream was released and the model remains usable
+    xcs.fit_stream(iter([(x_data, y_data)]), warm_start=True, verbose=False)
+    assert xcs.pset_size() > 0
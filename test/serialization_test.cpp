@@ -24,6 +24,7 @@
 #include "../lib/doctest/doctest/doctest.h"
 
 extern "C" {
+#include "../xcsf/blas.h"
 #include "../xcsf/pa.h"
 #include "../xcsf/param.h"
 #include "../xcsf/utils.h"
@@ -46,6 +47,27 @@ TEST_CASE("Serialization")
     size_t r = xcsf_load(&xcsf, "temp.bin");
     CHECK_EQ(s, r);
 
+    /* test in-memory serialisation matches the file */
+    char *buf = NULL;
+    size_t len = 0;
+    s = xcsf_save_buffer(&xcsf, &buf, &len);
+    FILE *fp = fopen("temp.bin", "rb");
+    char *file_buf = (char *) malloc(len + 1);
+    CHECK_EQ(fread(file_buf, 1, len + 1, fp), len);
+    fclose(fp);
+    CHECK_EQ(memcmp(buf, file_buf, len), 0);
+    free(file_buf);
+
+    /* test the header records the precision of the build */
+    int header[4];
+    memcpy(header, buf, sizeof(header));
+    CHECK_EQ(header[0], VERSION_MAJOR);
+    CHECK_EQ(header[1], VERSION_MINOR);
+    CHECK_EQ(header[3], (int) sizeof(real));
+    r = xcsf_load_buffer(&xcsf, buf, len);
+    CHECK_EQ(s, r);
+    free(buf);
+
     /* test param export and import */
     char *json_str = param_json_export(&xcsf);
     param_json_import(&xcsf, json_str);
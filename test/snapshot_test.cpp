@@ -0,0 +1,109 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file snapshot_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Memory-mapped snapshot tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/blas.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/param.h"
+#include "../xcsf/prediction.h"
+#include "../xcsf/snapshot.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_CASE("SNAPSHOT")
+{
+    /* Test mapped and streamed representations load unchanged */
+    const int types[3][2] = {
+        { COND_TYPE_HYPERRECTANGLE_CSR, PRED_TYPE_RLS_LINEAR },
+        { COND_TYPE_HYPERELLIPSOID, PRED_TYPE_NLMS_QUADRATIC },
+        { COND_TYPE_GP, PRED_TYPE_CONSTANT },
+    };
+    const int n_samples = 100;
+    const int x_dim = 3;
+    const int y_dim = 2;
+    double x[300];
+    double y[200];
+    rand_init_seed(3);
+    for (int i = 0; i < n_samples * x_dim; ++i) {
+        x[i] = rand_uniform(0, 1);
+    }
+    for (int i = 0; i < n_samples * y_dim; ++i) {
+        y[i] = rand_uniform(0, 1);
+    }
+    struct Input data;
+    data.n_samples = n_samples;
+    data.x_dim = x_dim;
+    data.y_dim = y_dim;
+    data.x = x;
+    data.y = y;
+    double cover[2] = { 0, 0 };
+    double out_a[200];
+    double out_b[200];
+    for (int t = 0; t < 3; ++t) {
+        struct XCSF a;
+        param_init(&a, x_dim, y_dim, 1);
+        param_set_random_state(&a, 1);
+        param_set_pop_size(&a, 200);
+        cond_param_set_type(&a, types[t][0]);
+        pred_param_set_type(&a, types[t][1]);
+        xcsf_init(&a);
+        xcs_supervised_fit(&a, &data, NULL, true, 1000);
+        snapshot_save(&a, "temp.snap");
+        struct SnapshotHeader h;
+        FILE *fp = fopen("temp.snap", "rb");
+        CHECK_EQ(fread(&h, sizeof(struct SnapshotHeader), 1, fp), 1);
+        fclose(fp);
+        CHECK_EQ(h.format, SNAPSHOT_FORMAT);
+        CHECK_EQ(h.precision, (int32_t) sizeof(real));
+        struct XCSF b;
+        param_init(&b, x_dim, y_dim, 1);
+        xcsf_init(&b);
+        snapshot_load(&b, "temp.snap");
+        CHECK_EQ(b.pset.size, a.pset.size);
+        CHECK_EQ(b.pset.num, a.pset.num);
+        CHECK_EQ(b.cond->type, types[t][0]);
+        CHECK_EQ(b.pred->type, types[t][1]);
+        xcs_supervised_predict(&a, x, out_a, n_samples, cover);
+        xcs_supervised_predict(&b, x, out_b, n_samples, cover);
+        CHECK_EQ(memcmp(out_a, out_b, sizeof(out_a)), 0);
+        /* Test training continues and reloading releases the mapping */
+        xcs_supervised_fit(&b, &data, NULL, true, 1000);
+        CHECK(b.pset.size > 0);
+        snapshot_load(&b, "temp.snap");
+        xcs_supervised_predict(&b, x, out_b, n_samples, cover);
+        CHECK_EQ(memcmp(out_a, out_b, sizeof(out_a)), 0);
+        xcsf_free(&a);
+        param_free(&a);
+        xcsf_free(&b);
+        param_free(&b);
+    }
+    remove("temp.snap");
+}
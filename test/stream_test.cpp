@@ -0,0 +1,131 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Streaming data source tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/param.h"
+#include "../xcsf/stream.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+TEST_CASE("STREAM")
+{
+    const int n_samples = 1000;
+    double x[2000];
+    double y[1000];
+    FILE *fx = fopen("temp_stream_x.csv", "w");
+    FILE *fy = fopen("temp_stream_y.csv", "w");
+    for (int i = 0; i < n_samples; ++i) {
+        x[i * 2] = i / (double) n_samples;
+        x[i * 2 + 1] = (i % 7) / 7.;
+        y[i] = (i % 3) / 3.;
+        fprintf(fx, "%.17g,%.17g\n", x[i * 2], x[i * 2 + 1]);
+        fprintf(fy, "%.17g\n", y[i]);
+    }
+    fclose(fx);
+    fclose(fy);
+    /* Test rows are streamed in order across chunks */
+    struct StreamCSV csv;
+    struct Stream stream;
+    const double *sx = NULL;
+    const double *sy = NULL;
+    stream_csv_open(&csv, "temp_stream_x.csv", "temp_stream_y.csv", 2, 1);
+    stream_init(&stream, 2, 1, 64, 0, stream_csv_read, &csv);
+    int n = 0;
+    while (stream_next(&stream, &sx, &sy)) {
+        CHECK_EQ(sx[0], x[n * 2]);
+        CHECK_EQ(sx[1], x[n * 2 + 1]);
+        CHECK_EQ(sy[0], y[n]);
+        ++n;
+    }
+    CHECK_EQ(n, n_samples);
+    CHECK(!stream_next(&stream, &sx, &sy));
+    stream_free(&stream);
+    stream_csv_close(&csv);
+    /* Test a reservoir window returns every row once out of order */
+    rand_init_seed(1);
+    stream_csv_open(&csv, "temp_stream_x.csv", "temp_stream_y.csv", 2, 1);
+    stream_init(&stream, 2, 1, 64, 100, stream_csv_read, &csv);
+    bool *seen = (bool *) calloc(n_samples, sizeof(bool));
+    int n_moved = 0;
+    n = 0;
+    while (stream_next(&stream, &sx, &sy)) {
+        const int row = (int) (sx[0] * n_samples + 0.5);
+        CHECK(!seen[row]);
+        seen[row] = true;
+        CHECK_EQ(sy[0], y[row]);
+        n_moved += (row != n);
+        ++n;
+    }
+    CHECK_EQ(n, n_samples);
+    CHECK(n_moved > n_samples / 2);
+    free(seen);
+    stream_free(&stream);
+    stream_csv_close(&csv);
+    /* Test training from a stream matches training from memory */
+    struct Input data;
+    data.n_samples = n_samples;
+    data.x_dim = 2;
+    data.y_dim = 1;
+    data.x = x;
+    data.y = y;
+    struct XCSF a;
+    param_init(&a, 2, 1, 1);
+    param_set_random_state(&a, 1);
+    xcsf_init(&a);
+    const double err_a = xcs_supervised_fit(&a, &data, NULL, false, 800);
+    struct XCSF b;
+    param_init(&b, 2, 1, 1);
+    param_set_random_state(&b, 1);
+    xcsf_init(&b);
+    stream_csv_open(&csv, "temp_stream_x.csv", "temp_stream_y.csv", 2, 1);
+    stream_init(&stream, 2, 1, 64, 0, stream_csv_read, &csv);
+    int n_trials = 0;
+    const double err_b =
+        xcs_supervised_fit_stream(&b, &stream, NULL, false, 800, &n_trials);
+    CHECK_EQ(err_a, err_b);
+    CHECK_EQ(a.pset.size, b.pset.size);
+    CHECK_EQ(n_trials, 800);
+    /* Test the trials executed are reported when the stream ends early */
+    xcs_supervised_fit_stream(&b, &stream, NULL, false, 800, &n_trials);
+    CHECK_EQ(n_trials, n_samples - 800);
+    CHECK_EQ(xcs_supervised_fit_stream(&b, &stream, NULL, false, 800,
+                                       &n_trials),
+             0);
+    CHECK_EQ(n_trials, 0);
+    stream_free(&stream);
+    stream_csv_close(&csv);
+    xcsf_free(&a);
+    param_free(&a);
+    xcsf_free(&b);
+    param_free(&b);
+    remove("temp_stream_x.csv");
+    remove("temp_stream_y.csv");
+}
@@ -98,3 +98,61 @@ TEST_CASE("UTIL")
     max = argmax(x, 5);
     CHECK_EQ(max, 4);
 }
+
+TEST_CASE("UTIL_RAND")
+{
+    /* Test the same seed reproduces the same draws */
+    const int n = 101;
+    double a[101];
+    double b[101];
+    rand_init_seed(7);
+    for (int i = 0; i < n; ++i) {
+        a[i] = rand_uniform(0, 1);
+    }
+    rand_init_seed(7);
+    rand_uniform_fill(b, n, 0, 1);
+    for (int i = 0; i < n; ++i) {
+        CHECK_EQ(a[i], b[i]);
+        CHECK(a[i] > 0);
+        CHECK(a[i] < 1);
+    }
+    /* Test bulk fills continue the stream mid-buffer */
+    rand_init_seed(3);
+    const double first = rand_normal(1, 2);
+    for (int i = 0; i < n; ++i) {
+        a[i] = rand_normal(1, 2);
+    }
+    const double next = rand_uniform(-1, 1);
+    rand_init_seed(3);
+    CHECK_EQ(rand_normal(1, 2), first);
+    rand_normal_fill(b, n, 1, 2);
+    for (int i = 0; i < n; ++i) {
+        CHECK_EQ(a[i], b[i]);
+    }
+    CHECK_EQ(rand_uniform(-1, 1), next);
+    /* Test different seeds give different draws */
+    rand_init_seed(4);
+    rand_normal_fill(b, n, 1, 2);
+    int same = 0;
+    for (int i = 0; i < n; ++i) {
+        same += (a[i] == b[i]);
+    }
+    CHECK_EQ(same, 0);
+    /* Test the sample moments of a large fill */
+    const int m = 100000;
+    double *x = (double *) malloc(sizeof(double) * m);
+    rand_normal_fill(x, m, 1, 2);
+    double mean = 0;
+    for (int i = 0; i < m; ++i) {
+        mean += x[i];
+    }
+    mean /= m;
+    double var = 0;
+    for (int i = 0; i < m; ++i) {
+        var += (x[i] - mean) * (x[i] - mean);
+    }
+    var /= m;
+    CHECK_EQ(doctest::Approx(mean).epsilon(0.02), 1);
+    CHECK_EQ(doctest::Approx(var).epsilon(0.02), 4);
+    free(x);
+}
@@ -21,9 +21,13 @@
  * @brief High-level supervised learning function tests.
  */
 
+#include <utility>
+
 #include "../lib/doctest/doctest/doctest.h"
 
 extern "C" {
+#include "../xcsf/clset.h"
+#include "../xcsf/condition.h"
 #include "../xcsf/pa.h"
 #include "../xcsf/param.h"
 #include "../xcsf/utils.h"
@@ -50,7 +54,8 @@ TEST_CASE("SUPERVISED")
 
     double y[5] = { 0.1, 0.2, 0.3, 0.4, 0.5 };
 
-    double expected[5] = { 0.361102, 0.362183, 0.314256, 0.46298, 0.41342 };
+    double expected[5] = { 0.274741, 0.303803, 0.289269, 0.493498,
+                           0.427503 };
 
     struct XCSF xcsf;
     param_init(&xcsf, x_dim, y_dim, 1);
@@ -69,11 +74,11 @@ TEST_CASE("SUPERVISED")
     xcs_supervised_fit(&xcsf, &train_data, NULL, true, 100);
     // score()
     double score = xcs_supervised_score(&xcsf, &train_data, cover);
-    CHECK_EQ(doctest::Approx(score), 0.11742);
+    CHECK_EQ(doctest::Approx(score), 0.091054);
     score = xcs_supervised_score_n(&xcsf, &train_data, 10, cover);
-    CHECK_EQ(doctest::Approx(score), 0.11742);
+    CHECK_EQ(doctest::Approx(score), 0.091054);
     score = xcs_supervised_score_n(&xcsf, &train_data, 2, cover);
-    CHECK_EQ(doctest::Approx(score), 0.01425);
+    CHECK_EQ(doctest::Approx(score), 0.103803);
     // predict()
     double *output =
         (double *) malloc(sizeof(double) * n_samples * xcsf.pa_size);
@@ -84,9 +89,107 @@ TEST_CASE("SUPERVISED")
     // fit() with train and test data
     xcs_supervised_fit(&xcsf, &train_data, &train_data, true, 100);
     score = xcs_supervised_score(&xcsf, &train_data, cover);
-    CHECK_EQ(doctest::Approx(score), 0.0359);
+    CHECK_EQ(doctest::Approx(score), 0.0301443);
 
     /* Test clean up */
     xcsf_free(&xcsf);
     param_free(&xcsf);
 }
+
+TEST_CASE("SUPERVISED_BATCH")
+{
+    /* Test batch prediction matches predicting each sample in turn for
+     * rectangles in the SoA store, adaptive rectangles, tree GP and DGP */
+    const int types[4] = { COND_TYPE_HYPERRECTANGLE_CSR,
+                           COND_TYPE_HYPERRECTANGLE_CSR, COND_TYPE_GP,
+                           COND_TYPE_DGP };
+    const int n_samples = 300;
+    const int x_dim = 4;
+    const int y_dim = 2;
+    double *x = (double *) malloc(sizeof(double) * n_samples * x_dim);
+    double *y = (double *) malloc(sizeof(double) * n_samples * y_dim);
+    rand_init_seed(5);
+    for (int i = 0; i < n_samples * x_dim; ++i) {
+        x[i] = rand_uniform(0, 1);
+    }
+    for (int i = 0; i < n_samples * y_dim; ++i) {
+        y[i] = rand_uniform(0, 1);
+    }
+    struct Input data;
+    data.n_samples = n_samples;
+    data.x_dim = x_dim;
+    data.y_dim = y_dim;
+    data.x = x;
+    data.y = y;
+    double cover[2] = { 0.5, -0.5 };
+    double *output = (double *) malloc(sizeof(double) * n_samples * y_dim);
+    for (int t = 0; t < 4; ++t) {
+        struct XCSF xcsf;
+        param_init(&xcsf, x_dim, y_dim, 1);
+        param_set_random_state(&xcsf, 3);
+        param_set_pop_size(&xcsf, 500);
+        param_set_perf_trials(&xcsf, 5000);
+        cond_param_set_type(&xcsf, types[t]);
+        cond_param_set_eta(&xcsf, t == 1 ? 0.1 : 0);
+        param_set_stateful(&xcsf, false);
+        xcsf_init(&xcsf);
+        xcs_supervised_fit(&xcsf, &data, NULL, true, 2000);
+        param_set_explore(&xcsf, false);
+        // store the match statistics before predicting
+        const int size = xcsf.pset.size;
+        const double mset_size = xcsf.mset_size;
+        const double mfrac = xcsf.mfrac;
+        int *age = (int *) malloc(sizeof(int) * size);
+        int *mtotal = (int *) malloc(sizeof(int) * size);
+        for (int i = 0; i < size; ++i) {
+            age[i] = xcsf.pset.cl[i]->age;
+            mtotal[i] = xcsf.pset.cl[i]->mtotal;
+        }
+        // reference: one trial per sample
+        double *expected =
+            (double *) malloc(sizeof(double) * n_samples * y_dim);
+        for (int i = 0; i < n_samples; ++i) {
+            clset_init(&xcsf.mset);
+            clset_match(&xcsf, &x[i * x_dim], false);
+            if (xcsf.mset.size < 1) {
+                memcpy(xcsf.pa, cover, sizeof(double) * y_dim);
+            } else {
+                pa_build(&xcsf, &x[i * x_dim]);
+            }
+            memcpy(&expected[i * y_dim], xcsf.pa, sizeof(double) * y_dim);
+            clset_free(&xcsf.mset);
+        }
+        const double ref_mset_size = xcsf.mset_size;
+        const double ref_mfrac = xcsf.mfrac;
+        bool *m = (bool *) malloc(sizeof(bool) * size);
+        for (int i = 0; i < size; ++i) {
+            struct Cl *c = xcsf.pset.cl[i];
+            m[i] = c->m;
+            std::swap(age[i], c->age);
+            std::swap(mtotal[i], c->mtotal);
+        }
+        xcsf.mset_size = mset_size;
+        xcsf.mfrac = mfrac;
+        // batch prediction from the same starting state
+        xcs_supervised_predict(&xcsf, x, output, n_samples, cover);
+        for (int i = 0; i < n_samples * y_dim; ++i) {
+            CHECK_EQ(output[i], expected[i]);
+        }
+        CHECK_EQ(xcsf.mset_size, ref_mset_size);
+        CHECK_EQ(xcsf.mfrac, ref_mfrac);
+        for (int i = 0; i < size; ++i) {
+            CHECK_EQ(xcsf.pset.cl[i]->age, age[i]);
+            CHECK_EQ(xcsf.pset.cl[i]->mtotal, mtotal[i]);
+            CHECK_EQ(xcsf.pset.cl[i]->m, m[i]);
+        }
+        free(expected);
+        free(age);
+        free(mtotal);
+        free(m);
+        xcsf_free(&xcsf);
+        param_free(&xcsf);
+    }
+    free(x);
+    free(y);
+    free(output);
+}
@@ -22,6 +22,7 @@
  */
 
 #include "act_integer.h"
+#include "pool.h"
 #include "sam.h"
 #include "utils.h"
 
@@ -116,11 +117,10 @@ act_integer_compute(const struct XCSF *xcsf, const struct Cl *c,
 void
 act_integer_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 {
-    (void) xcsf;
-    struct ActInteger *new = malloc(sizeof(struct ActInteger));
+    struct ActInteger *new = pool_malloc(xcsf->pool, sizeof(struct ActInteger));
     const struct ActInteger *src_act = src->act;
     new->action = src_act->action;
-    new->mu = malloc(sizeof(double) * N_MU);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     memcpy(new->mu, src_act->mu, sizeof(double) * N_MU);
     dest->act = new;
 }
@@ -163,10 +163,9 @@ act_integer_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
 void
 act_integer_free(const struct XCSF *xcsf, const struct Cl *c)
 {
-    (void) xcsf;
     const struct ActInteger *act = c->act;
-    free(act->mu);
-    free(c->act);
+    pool_free(xcsf->pool, act->mu);
+    pool_free(xcsf->pool, c->act);
 }
 
 /**
@@ -177,8 +176,8 @@ act_integer_free(const struct XCSF *xcsf, const struct Cl *c)
 void
 act_integer_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct ActInteger *new = malloc(sizeof(struct ActInteger));
-    new->mu = malloc(sizeof(double) * N_MU);
+    struct ActInteger *new = pool_malloc(xcsf->pool, sizeof(struct ActInteger));
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     sam_init(new->mu, N_MU, MU_TYPE);
     new->action = rand_uniform_int(0, xcsf->n_actions);
     c->act = new;
@@ -229,11 +228,10 @@ act_integer_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
 size_t
 act_integer_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
-    (void) xcsf;
     size_t s = 0;
-    struct ActInteger *new = malloc(sizeof(struct ActInteger));
+    struct ActInteger *new = pool_malloc(xcsf->pool, sizeof(struct ActInteger));
     s += fread(&new->action, sizeof(int), 1, fp);
-    new->mu = malloc(sizeof(double) * N_MU);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     s += fread(new->mu, sizeof(double), N_MU, fp);
     c->act = new;
     return s;
@@ -108,7 +108,10 @@ act_neural_compute(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     struct ActNeural *act = c->act;
     neural_propagate(&act->net, x, xcsf->explore);
-    const double *outputs = neural_outputs(&act->net);
+    double outputs[xcsf->n_actions];
+    for (int i = 0; i < xcsf->n_actions; ++i) {
+        outputs[i] = neural_output(&act->net, i);
+    }
     return argmax(outputs, xcsf->n_actions);
 }
 
@@ -23,6 +23,26 @@
 
 #pragma once
 
+#ifdef SINGLE_PRECISION
+typedef float real; //!< Floating point type of neural network values
+    #define blas_rgemm blas_sgemm //!< GEMM in the precision of real
+    #define blas_raxpy blas_saxpy //!< AXPY in the precision of real
+    #define blas_rmul blas_smul //!< Vector multiply in the precision of real
+    #define blas_rscal blas_sscal //!< Scaling in the precision of real
+    #define blas_rfill blas_sfill //!< Filling in the precision of real
+    #define blas_rdot blas_sdot //!< Dot product in the precision of real
+    #define blas_rsum blas_ssum //!< Summation in the precision of real
+#else
+typedef double real; //!< Floating point type of neural network values
+    #define blas_rgemm blas_gemm //!< GEMM in the precision of real
+    #define blas_raxpy blas_axpy //!< AXPY in the precision of real
+    #define blas_rmul blas_mul //!< Vector multiply in the precision of real
+    #define blas_rscal blas_scal //!< Scaling in the precision of real
+    #define blas_rfill blas_fill //!< Filling in the precision of real
+    #define blas_rdot blas_dot //!< Dot product in the precision of real
+    #define blas_rsum blas_sum //!< Summation in the precision of real
+#endif
+
 void
 blas_gemm(const int TA, const int TB, const int M, const int N, const int K,
           const double ALPHA, const double *A, const int lda, const double *B,
@@ -48,3 +68,29 @@ blas_dot(const int N, const double *X, const int INCX, const double *Y,
 
 double
 blas_sum(const double *X, const int N);
+
+void
+blas_sgemm(const int TA, const int TB, const int M, const int N, const int K,
+           const float ALPHA, const float *A, const int lda, const float *B,
+           const int ldb, const float BETA, float *C, const int ldc);
+
+void
+blas_saxpy(const int N, const float ALPHA, const float *X, const int INCX,
+           float *Y, const int INCY);
+
+void
+blas_smul(const int N, const float *X, const int INCX, float *Y,
+          const int INCY);
+
+void
+blas_sscal(const int N, const float ALPHA, float *X, const int INCX);
+
+void
+blas_sfill(const int N, const float ALPHA, float *X, const int INCX);
+
+float
+blas_sdot(const int N, const float *X, const int INCX, const float *Y,
+          const int INCY);
+
+float
+blas_ssum(const float *X, const int N);
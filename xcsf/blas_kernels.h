@@ -0,0 +1,412 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file blas_kernels.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Basic linear algebra functions for one floating point type.
+ * @details Included by blas.c once per precision with BLAS_T defined as the
+ * element type, BLAS(name) naming each function, and CBLAS(name) naming the
+ * matching external routine.
+ */
+
+/**
+ * @brief Updates one row of C with a block of K: C += ALPHA A B.
+ * @param [in] N Number of columns in the panel.
+ * @param [in] K Number of rows of B in the block.
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in] A Row of A at the start of the block.
+ * @param [in] sak Stride between consecutive elements along K in A.
+ * @param [in] B Block of B.
+ * @param [in] ldb Leading dimension of B.
+ * @param [in,out] C Row of C.
+ */
+static void
+BLAS(gemm_row_1)(const int N, const int K, const BLAS_T ALPHA, const BLAS_T *A,
+                 const int sak, const BLAS_T *B, const int ldb, BLAS_T *C)
+{
+    for (int k = 0; k < K; ++k) {
+        const BLAS_T a = ALPHA * A[k * sak];
+        const BLAS_T *b = &B[k * ldb];
+        for (int j = 0; j < N; ++j) {
+            C[j] += a * b[j];
+        }
+    }
+}
+
+/**
+ * @brief Updates GEMM_MR rows of C with a block of K: C += ALPHA A B.
+ * @details Each row of B is loaded once for all of the rows of C.
+ * @param [in] N Number of columns in the panel.
+ * @param [in] K Number of rows of B in the block.
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in] A First row of A at the start of the block.
+ * @param [in] sai Stride between consecutive rows of A.
+ * @param [in] sak Stride between consecutive elements along K in A.
+ * @param [in] B Block of B.
+ * @param [in] ldb Leading dimension of B.
+ * @param [in,out] C First row of C.
+ * @param [in] ldc Leading dimension of C.
+ */
+static void
+BLAS(gemm_row_4)(const int N, const int K, const BLAS_T ALPHA, const BLAS_T *A,
+                 const int sai, const int sak, const BLAS_T *B, const int ldb,
+                 BLAS_T *C, const int ldc)
+{
+    BLAS_T *c0 = C;
+    BLAS_T *c1 = &C[ldc];
+    BLAS_T *c2 = &C[2 * ldc];
+    BLAS_T *c3 = &C[3 * ldc];
+    for (int k = 0; k < K; ++k) {
+        const BLAS_T a0 = ALPHA * A[k * sak];
+        const BLAS_T a1 = ALPHA * A[sai + k * sak];
+        const BLAS_T a2 = ALPHA * A[2 * sai + k * sak];
+        const BLAS_T a3 = ALPHA * A[3 * sai + k * sak];
+        const BLAS_T *b = &B[k * ldb];
+        for (int j = 0; j < N; ++j) {
+            c0[j] += a0 * b[j];
+            c1[j] += a1 * b[j];
+            c2[j] += a2 * b[j];
+            c3[j] += a3 * b[j];
+        }
+    }
+}
+
+/**
+ * @brief Matrix-vector product C += ALPHA A B where B and C are columns.
+ * @details Each element of C is accumulated in order along K.
+ * @param [in] M Number of rows of A and C.
+ * @param [in] K Number of columns of A and rows of B.
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in] A Matrix A.
+ * @param [in] sai Stride between consecutive rows of A.
+ * @param [in] sak Stride between consecutive elements along K in A.
+ * @param [in] B Column vector B.
+ * @param [in] ldb Stride between consecutive elements of B.
+ * @param [in,out] C Column vector C.
+ * @param [in] ldc Stride between consecutive elements of C.
+ */
+static void
+BLAS(gemm_col)(const int M, const int K, const BLAS_T ALPHA, const BLAS_T *A,
+               const int sai, const int sak, const BLAS_T *B, const int ldb,
+               BLAS_T *C, const int ldc)
+{
+    int i = 0;
+    for (; i + GEMM_MR <= M; i += GEMM_MR) {
+        const BLAS_T *a = &A[i * sai];
+        BLAS_T c0 = C[i * ldc];
+        BLAS_T c1 = C[(i + 1) * ldc];
+        BLAS_T c2 = C[(i + 2) * ldc];
+        BLAS_T c3 = C[(i + 3) * ldc];
+        for (int k = 0; k < K; ++k) {
+            const BLAS_T b = B[k * ldb];
+            c0 += ALPHA * a[k * sak] * b;
+            c1 += ALPHA * a[sai + k * sak] * b;
+            c2 += ALPHA * a[2 * sai + k * sak] * b;
+            c3 += ALPHA * a[3 * sai + k * sak] * b;
+        }
+        C[i * ldc] = c0;
+        C[(i + 1) * ldc] = c1;
+        C[(i + 2) * ldc] = c2;
+        C[(i + 3) * ldc] = c3;
+    }
+    for (; i < M; ++i) {
+        BLAS_T c = C[i * ldc];
+        for (int k = 0; k < K; ++k) {
+            c += ALPHA * A[i * sai + k * sak] * B[k * ldb];
+        }
+        C[i * ldc] = c;
+    }
+}
+
+/**
+ * @brief Computes C += ALPHA op(A) B with B not transposed.
+ * @details C is updated a panel of columns and a block of K at a time so that
+ * the block of B stays in cache while GEMM_MR rows of C are updated together.
+ * Blocks of K are visited in order, so each element of C accumulates its
+ * products in the same order as the unblocked loop.
+ * @param [in] M Number of rows of op(A) and C.
+ * @param [in] N Number of columns of B and C.
+ * @param [in] K Number of columns of op(A) and rows of B.
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in] A Matrix A.
+ * @param [in] sai Stride between consecutive rows of op(A).
+ * @param [in] sak Stride between consecutive columns of op(A).
+ * @param [in] B Matrix B.
+ * @param [in] ldb Leading dimension of B.
+ * @param [in,out] C Matrix C.
+ * @param [in] ldc Leading dimension of C.
+ */
+static void
+BLAS(gemm_xn)(const int M, const int N, const int K, const BLAS_T ALPHA,
+              const BLAS_T *A, const int sai, const int sak, const BLAS_T *B,
+              const int ldb, BLAS_T *C, const int ldc)
+{
+    if (N == 1) {
+        BLAS(gemm_col)(M, K, ALPHA, A, sai, sak, B, ldb, C, ldc);
+        return;
+    }
+    for (int jj = 0; jj < N; jj += GEMM_NC) {
+        const int nb = (N - jj < GEMM_NC) ? N - jj : GEMM_NC;
+        for (int kk = 0; kk < K; kk += GEMM_KC) {
+            const int kb = (K - kk < GEMM_KC) ? K - kk : GEMM_KC;
+            const BLAS_T *b = &B[kk * ldb + jj];
+            int i = 0;
+            for (; i + GEMM_MR <= M; i += GEMM_MR) {
+                BLAS(gemm_row_4)(nb, kb, ALPHA, &A[i * sai + kk * sak], sai,
+                                 sak, b, ldb, &C[i * ldc + jj], ldc);
+            }
+            for (; i < M; ++i) {
+                BLAS(gemm_row_1)(nb, kb, ALPHA, &A[i * sai + kk * sak], sak, b,
+                                 ldb, &C[i * ldc + jj]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Computes C += ALPHA op(A) B' with B transposed.
+ * @details Each element of C is a dot product accumulated in order along K
+ * and then added to C. GEMM_NR columns are computed together so that each
+ * element of A is loaded once for several independent sums; the rows of B
+ * are reused across every row of A.
+ * @param [in] M Number of rows of op(A) and C.
+ * @param [in] N Number of rows of B and columns of C.
+ * @param [in] K Number of columns of op(A) and B.
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in] A Matrix A.
+ * @param [in] sai Stride between consecutive rows of op(A).
+ * @param [in] sak Stride between consecutive columns of op(A).
+ * @param [in] B Matrix B.
+ * @param [in] ldb Leading dimension of B.
+ * @param [in,out] C Matrix C.
+ * @param [in] ldc Leading dimension of C.
+ */
+static void
+BLAS(gemm_xt)(const int M, const int N, const int K, const BLAS_T ALPHA,
+              const BLAS_T *A, const int sai, const int sak, const BLAS_T *B,
+              const int ldb, BLAS_T *C, const int ldc)
+{
+    int j = 0;
+    for (; j + GEMM_NR <= N; j += GEMM_NR) {
+        const BLAS_T *b0 = &B[j * ldb];
+        const BLAS_T *b1 = &B[(j + 1) * ldb];
+        const BLAS_T *b2 = &B[(j + 2) * ldb];
+        const BLAS_T *b3 = &B[(j + 3) * ldb];
+        for (int i = 0; i < M; ++i) {
+            const BLAS_T *a = &A[i * sai];
+            BLAS_T sum0 = 0;
+            BLAS_T sum1 = 0;
+            BLAS_T sum2 = 0;
+            BLAS_T sum3 = 0;
+            for (int k = 0; k < K; ++k) {
+                const BLAS_T ak = ALPHA * a[k * sak];
+                sum0 += ak * b0[k];
+                sum1 += ak * b1[k];
+                sum2 += ak * b2[k];
+                sum3 += ak * b3[k];
+            }
+            C[i * ldc + j] += sum0;
+            C[i * ldc + j + 1] += sum1;
+            C[i * ldc + j + 2] += sum2;
+            C[i * ldc + j + 3] += sum3;
+        }
+    }
+    for (; j < N; ++j) {
+        const BLAS_T *b = &B[j * ldb];
+        for (int i = 0; i < M; ++i) {
+            const BLAS_T *a = &A[i * sai];
+            BLAS_T sum = 0;
+            for (int k = 0; k < K; ++k) {
+                sum += ALPHA * a[k * sak] * b[k];
+            }
+            C[i * ldc + j] += sum;
+        }
+    }
+}
+
+/**
+ * @brief Performs the matrix-matrix multiplication:
+ * \f$ C = \alpha \mbox{op}(A) \mbox{op}(B) + \beta C \f$.
+ * @param [in] TA Operation op(A) that is non- or (conj.) transpose.
+ * @param [in] TB Operation op(B) that is non- or (conj.) transpose.
+ * @param [in] M Number of rows of matrix op(A) and C.
+ * @param [in] N Number of columns of matrix op(B) and C.
+ * @param [in] K Number of columns of op(A) and rows of op(B).
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in] A Array of dimension lda × K with lda >= max(1,M) if TA=0 and lda
+ * × M with lda >= max(1,K) otherwise.
+ * @param [in] lda Leading dimension of a 2-D array used to store the matrix A.
+ * @param [in] B Array of dimension ldb × N with ldb >= max(1,K) if TB=0 and ldb
+ * × K with ldb >= max(1,N) otherwise.
+ * @param [in] ldb Leading dimension of a 2-D array used to store the matrix B.
+ * @param [in] BETA Scalar used for multiplication.
+ * @param [in,out] C Array of dimension ldc × N with ldc >= max(1,M).
+ * @param [in] ldc Leading dimension of a 2-D array used to store the matrix C.
+ */
+void
+BLAS(gemm)(const int TA, const int TB, const int M, const int N, const int K,
+           const BLAS_T ALPHA, const BLAS_T *A, const int lda, const BLAS_T *B,
+           const int ldb, const BLAS_T BETA, BLAS_T *C, const int ldc)
+{
+#ifdef USE_CBLAS
+    CBLAS(gemm)(CblasRowMajor, TA ? CblasTrans : CblasNoTrans,
+                TB ? CblasTrans : CblasNoTrans, M, N, K, ALPHA, A, lda, B, ldb,
+                BETA, C, ldc);
+#else
+    if (BETA != 1) {
+        for (int i = 0; i < M; ++i) {
+            for (int j = 0; j < N; ++j) {
+                C[i * ldc + j] *= BETA;
+            }
+        }
+    }
+    // strides between the rows and columns of op(A)
+    const int sai = TA ? 1 : lda;
+    const int sak = TA ? lda : 1;
+    if (TB) {
+        BLAS(gemm_xt)(M, N, K, ALPHA, A, sai, sak, B, ldb, C, ldc);
+    } else {
+        BLAS(gemm_xn)(M, N, K, ALPHA, A, sai, sak, B, ldb, C, ldc);
+    }
+#endif
+}
+
+/**
+ * @brief Multiplies vector X by the scalar ALPHA and adds it to the vector Y.
+ * @param [in] N The number of elements in vectors X and Y.
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in] X Vector with N elements.
+ * @param [in] INCX Stride between consecutive elements of X.
+ * @param [in,out] Y Vector with N elements.
+ * @param [in] INCY Stride between consecutive elements of Y.
+ */
+void
+BLAS(axpy)(const int N, const BLAS_T ALPHA, const BLAS_T *X, const int INCX,
+           BLAS_T *Y, const int INCY)
+{
+#ifdef USE_CBLAS
+    CBLAS(axpy)(N, ALPHA, X, INCX, Y, INCY);
+#else
+    if (ALPHA != 1) {
+        for (int i = 0; i < N; ++i) {
+            Y[i * INCY] += ALPHA * X[i * INCX];
+        }
+    } else {
+        for (int i = 0; i < N; ++i) {
+            Y[i * INCY] += X[i * INCX];
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Scales vector X by the scalar ALPHA and overwrites it with the result.
+ * @param [in] N The number of elements in vector X.
+ * @param [in] ALPHA Scalar used for multiplication.
+ * @param [in,out] X Vector with N elements.
+ * @param [in] INCX Stride between consecutive elements of X.
+ */
+void
+BLAS(scal)(const int N, const BLAS_T ALPHA, BLAS_T *X, const int INCX)
+{
+    if (ALPHA != 0) {
+#ifdef USE_CBLAS
+        CBLAS(scal)(N, ALPHA, X, INCX);
+#else
+        for (int i = 0; i < N; ++i) {
+            X[i * INCX] *= ALPHA;
+        }
+#endif
+    } else {
+        for (int i = 0; i < N; ++i) {
+            X[i * INCX] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Fills the vector X with the value ALPHA.
+ * @param [in] N The number of elements in vector X.
+ * @param [in] ALPHA The value to fill the vector.
+ * @param [out] X Vector with N elements.
+ * @param [in] INCX Stride between consecutive elements of X.
+ */
+void
+BLAS(fill)(const int N, const BLAS_T ALPHA, BLAS_T *X, const int INCX)
+{
+    for (int i = 0; i < N; ++i) {
+        X[i * INCX] = ALPHA;
+    }
+}
+
+/**
+ * @brief Computes the dot product of two vectors.
+ * @param [in] N The number of elements in vectors X and Y.
+ * @param [in] X Vector with N elements.
+ * @param [in] INCX Stride between consecutive elements of X.
+ * @param [in] Y Vector with N elements.
+ * @param [in] INCY Stride between consecutive elements of Y.
+ * @return The resulting dot product.
+ */
+BLAS_T
+BLAS(dot)(const int N, const BLAS_T *X, const int INCX, const BLAS_T *Y,
+          const int INCY)
+{
+#ifdef USE_CBLAS
+    return CBLAS(dot)(N, X, INCX, Y, INCY);
+#else
+    BLAS_T dot = 0;
+    for (int i = 0; i < N; ++i) {
+        dot += X[i * INCX] * Y[i * INCY];
+    }
+    return dot;
+#endif
+}
+
+/**
+ * @brief Multiplies vector X by the vector Y and stores the result in vector Y.
+ * @param [in] N The number of elements in vectors X and Y.
+ * @param [in] X Vector with N elements.
+ * @param [in] INCX Stride between consecutive elements of X.
+ * @param [in,out] Y Vector with N elements.
+ * @param [in] INCY Stride between consecutive elements of Y.
+ */
+void
+BLAS(mul)(const int N, const BLAS_T *X, const int INCX, BLAS_T *Y,
+          const int INCY)
+{
+    for (int i = 0; i < N; ++i) {
+        Y[i * INCY] *= X[i * INCX];
+    }
+}
+
+/**
+ * @brief Returns the sum of the vector X.
+ * @param [in] X Vector with N elements.
+ * @param [in] N The number of elements in vector X.
+ * @return The resulting sum.
+ */
+BLAS_T
+BLAS(sum)(const BLAS_T *X, const int N)
+{
+    BLAS_T sum = 0;
+    for (int i = 0; i < N; ++i) {
+        sum += X[i];
+    }
+    return sum;
+}
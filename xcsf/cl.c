@@ -26,6 +26,7 @@
 #include "condition.h"
 #include "ea.h"
 #include "loss.h"
+#include "pool.h"
 #include "prediction.h"
 #include "utils.h"
 
@@ -46,7 +47,7 @@ cl_init(const struct XCSF *xcsf, struct Cl *c, const double size,
     c->exp = 0;
     c->size = size;
     c->time = time;
-    c->prediction = calloc(xcsf->y_dim, sizeof(double));
+    c->prediction = pool_calloc(xcsf->pool, xcsf->y_dim, sizeof(double));
     c->action = 0;
     c->m = false;
     c->age = 0;
@@ -83,7 +84,7 @@ cl_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 void
 cl_init_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 {
-    dest->prediction = calloc(xcsf->y_dim, sizeof(double));
+    dest->prediction = pool_calloc(xcsf->pool, xcsf->y_dim, sizeof(double));
     dest->fit = src->fit;
     dest->err = src->err;
     dest->num = src->num;
@@ -214,19 +215,34 @@ cl_update_fit(const struct XCSF *xcsf, struct Cl *c, const double acc_sum,
     c->fit += xcsf->BETA * ((acc * c->num) / acc_sum - c->fit);
 }
 
+/**
+ * @brief Allocates a classifier from the pool.
+ * @details Only the population index is initialised, to show that the
+ * classifier is not yet in the population.
+ * @param [in] xcsf The XCSF data structure.
+ * @return Pointer to the new classifier.
+ */
+struct Cl *
+cl_alloc(const struct XCSF *xcsf)
+{
+    struct Cl *c = pool_malloc(xcsf->pool, sizeof(struct Cl));
+    c->slot = -1;
+    return c;
+}
+
 /**
  * @brief Frees the memory used by a classifier.
  * @param [in] xcsf The XCSF data structure.
- * @param [in] c The classifier to free.
+ * @param [in] c The classifier to free; must have come from cl_alloc().
  */
 void
 cl_free(const struct XCSF *xcsf, struct Cl *c)
 {
-    free(c->prediction);
+    pool_free(xcsf->pool, c->prediction);
     cond_free(xcsf, c);
     act_free(xcsf, c);
     pred_free(xcsf, c);
-    free(c);
+    pool_free(xcsf->pool, c);
 }
 
 /**
@@ -256,7 +272,21 @@ cl_print(const struct XCSF *xcsf, const struct Cl *c, const bool print_cond,
 bool
 cl_match(const struct XCSF *xcsf, struct Cl *c, const double *x)
 {
-    c->m = cond_match(xcsf, c, x);
+    return cl_match_set(xcsf, c, cond_match(xcsf, c, x));
+}
+
+/**
+ * @brief Records the outcome of testing a classifier against an input.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier that was tested for matching.
+ * @param [in] m Whether the classifier matched the input.
+ * @return Whether the classifier matches the input.
+ */
+bool
+cl_match_set(const struct XCSF *xcsf, struct Cl *c, const bool m)
+{
+    (void) xcsf;
+    c->m = m;
     if (c->m) {
         ++(c->mtotal);
     }
@@ -461,7 +491,7 @@ cl_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     s += fread(&c->m, sizeof(bool), 1, fp);
     s += fread(&c->age, sizeof(int), 1, fp);
     s += fread(&c->mtotal, sizeof(int), 1, fp);
-    c->prediction = malloc(sizeof(double) * xcsf->y_dim);
+    c->prediction = pool_malloc(xcsf->pool, sizeof(double) * xcsf->y_dim);
     s += fread(c->prediction, sizeof(double), xcsf->y_dim, fp);
     s += fread(&c->action, sizeof(int), 1, fp);
     action_set(xcsf, c);
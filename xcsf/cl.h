@@ -37,6 +37,9 @@ cl_m(const struct XCSF *xcsf, const struct Cl *c);
 bool
 cl_match(const struct XCSF *xcsf, struct Cl *c, const double *x);
 
+bool
+cl_match_set(const struct XCSF *xcsf, struct Cl *c, const bool m);
+
 bool
 cl_mutate(const struct XCSF *xcsf, const struct Cl *c);
 
@@ -80,6 +83,9 @@ cl_cover(const struct XCSF *xcsf, struct Cl *c, const double *x,
 void
 cl_free(const struct XCSF *xcsf, struct Cl *c);
 
+struct Cl *
+cl_alloc(const struct XCSF *xcsf);
+
 void
 cl_init(const struct XCSF *xcsf, struct Cl *c, const double size,
         const int time);
@@ -23,107 +23,58 @@
 
 #include "clset.h"
 #include "cl.h"
+#include "clset_del.h"
+#include "clset_soa.h"
+#include "clset_stats.h"
 #include "utils.h"
 
 #define MAX_COVER (1000000) //!< Maximum number of covering attempts
+#define CLSET_INIT_CAPACITY (16) //!< Initial number of classifiers allocated
 
 /**
- * @brief Finds a rule in the population that never matches an input.
- * @param [in] xcsf The XCSF data structure.
- * @param [out] del A pointer to the classifier to be deleted, if one is found.
- * @param [out] delprev A pointer to the rule previous to the one being deleted.
- */
-static void
-clset_pset_never_match(const struct XCSF *xcsf, struct Clist **del,
-                       struct Clist **delprev)
-{
-    struct Clist *prev = NULL;
-    struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        if (iter->cl->mtotal == 0 && iter->cl->age > xcsf->M_PROBATION) {
-            *del = iter;
-            *delprev = prev;
-            break;
-        }
-        prev = iter;
-        iter = iter->next;
-    }
-}
-
-/**
- * @brief Selects a classifier from the population for deletion via roulette.
- * @details If compaction is enabled and the average system error is below E0,
- * two classifiers are selected using roulette wheel selection with the
- * deletion vote and the rule with the largest condition + prediction size is
- * chosen. For fixed-length representations, the effect is the same as one
- * roulette spin.
+ * @brief Deletes a single classifier from the population set.
+ * @details Macro-classifiers are removed by moving the last rule in the
+ * population into the vacated slot.
  * @param [in] xcsf The XCSF data structure.
- * @param [out] del A pointer to the rule to be deleted.
- * @param [out] delprev A pointer to the rule previous to the one being deleted.
  */
 static void
-clset_pset_roulette(const struct XCSF *xcsf, struct Clist **del,
-                    struct Clist **delprev)
-{
-    const double avg_fit = clset_total_fit(&xcsf->pset) / xcsf->pset.num;
-    double total_vote = 0;
-    struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        total_vote += cl_del_vote(xcsf, iter->cl, avg_fit);
-        iter = iter->next;
-    }
-    double delsize = 0;
-    const int n_spins = (xcsf->COMPACTION && xcsf->error < xcsf->E0) ? 2 : 1;
-    for (int i = 0; i < n_spins; ++i) {
-        // perform a single roulette spin with the deletion vote
-        iter = xcsf->pset.list;
-        struct Clist *prev = NULL;
-        const double p = rand_uniform(0, total_vote);
-        double sum = cl_del_vote(xcsf, iter->cl, avg_fit);
-        while (p > sum) {
-            prev = iter;
-            iter = iter->next;
-            sum += cl_del_vote(xcsf, iter->cl, avg_fit);
-        }
-        // select the rule for deletion if it is the largest sized winner
-        const double s =
-            cl_cond_size(xcsf, iter->cl) + cl_pred_size(xcsf, iter->cl);
-        if (*del == NULL || s > delsize) {
-            *del = iter;
-            *delprev = prev;
-            delsize = s;
-        }
-    }
+clset_pset_del(struct XCSF *xcsf)
+{
+    struct Set *pset = &xcsf->pset;
+    const int del = clset_del_select(xcsf);
+    struct Cl *c = pset->cl[del];
+    // decrement numerosity
+    --(c->num);
+    --(pset->num);
+    // remove macro-classifiers as necessary
+    if (c->num == 0) {
+        clset_add(&xcsf->kset, c);
+        clset_stats_remove(xcsf, c);
+        --(pset->size);
+        pset->cl[del] = pset->cl[pset->size];
+        pset->cl[del]->slot = del;
+        clset_soa_update(xcsf, del);
+    }
+    clset_del_update(xcsf, del, c);
 }
 
 /**
- * @brief Deletes a single classifier from the population set.
- * @param [in] xcsf The XCSF data structure.
+ * @brief Ensures a set has room for at least n classifiers.
+ * @details The capacity grows geometrically so that adding a classifier has
+ * amortised constant cost.
+ * @param [in] set The set to reserve space.
+ * @param [in] n The minimum number of classifiers the set must hold.
  */
 static void
-clset_pset_del(struct XCSF *xcsf)
+clset_reserve(struct Set *set, const int n)
 {
-    struct Clist *del = NULL;
-    struct Clist *delprev = NULL;
-    // select any rules that never match
-    clset_pset_never_match(xcsf, &del, &delprev);
-    // if none found, select a rule using roulette wheel
-    if (del == NULL) {
-        clset_pset_roulette(xcsf, &del, &delprev);
-    }
-    // decrement numerosity
-    --(del->cl->num);
-    --(xcsf->pset.num);
-    // remove macro-classifiers as necessary
-    if (del->cl->num == 0) {
-        clset_add(&xcsf->kset, del->cl);
-        --(xcsf->pset.size);
-        if (delprev == NULL) {
-            xcsf->pset.list = del->next;
-        } else {
-            delprev->next = del->next;
+    if (n > set->capacity) {
+        int capacity = (set->capacity < 1) ? CLSET_INIT_CAPACITY : set->capacity;
+        while (capacity < n) {
+            capacity *= 2;
         }
-        free(del);
+        set->cl = realloc(set->cl, sizeof(struct Cl *) * capacity);
+        set->capacity = capacity;
     }
 }
 
@@ -137,10 +88,8 @@ static bool
 clset_action_coverage(const struct XCSF *xcsf, bool *act_covered)
 {
     memset(act_covered, 0, sizeof(bool) * xcsf->n_actions);
-    const struct Clist *iter = xcsf->mset.list;
-    while (iter != NULL) {
-        act_covered[iter->cl->action] = true;
-        iter = iter->next;
+    for (int i = 0; i < xcsf->mset.size; ++i) {
+        act_covered[xcsf->mset.cl[i]->action] = true;
     }
     for (int i = 0; i < xcsf->n_actions; ++i) {
         if (!act_covered[i]) {
@@ -159,17 +108,17 @@ static void
 clset_cover(struct XCSF *xcsf, const double *x)
 {
     int attempts = 0;
-    bool *act_covered = malloc(sizeof(bool) * xcsf->n_actions);
+    bool act_covered[xcsf->n_actions];
     bool covered = clset_action_coverage(xcsf, act_covered);
     while (!covered) {
         covered = true;
         for (int i = 0; i < xcsf->n_actions; ++i) {
             if (!act_covered[i]) {
                 // create a new classifier with matching condition and action
-                struct Cl *new = malloc(sizeof(struct Cl));
+                struct Cl *new = cl_alloc(xcsf);
                 cl_init(xcsf, new, (xcsf->mset.num) + 1, xcsf->time);
                 cl_cover(xcsf, new, x, i);
-                clset_add(&xcsf->pset, new);
+                clset_pset_add(xcsf, new);
                 clset_add(&xcsf->mset, new);
             }
         }
@@ -193,7 +142,6 @@ clset_cover(struct XCSF *xcsf, const double *x)
             exit(EXIT_FAILURE);
         }
     }
-    free(act_covered);
 }
 
 /**
@@ -207,17 +155,13 @@ clset_update_fit(const struct XCSF *xcsf, const struct Set *set)
     double acc_sum = 0;
     double accs[set->size];
     // calculate accuracies
-    const struct Clist *iter = set->list;
-    for (int i = 0; iter != NULL && i < set->size; ++i) {
-        accs[i] = cl_acc(xcsf, iter->cl);
-        acc_sum += accs[i] * iter->cl->num;
-        iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        accs[i] = cl_acc(xcsf, set->cl[i]);
+        acc_sum += accs[i] * set->cl[i]->num;
     }
     // update fitnesses
-    iter = set->list;
-    for (int i = 0; iter != NULL && i < set->size; ++i) {
-        cl_update_fit(xcsf, iter->cl, acc_sum, accs[i]);
-        iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        cl_update_fit(xcsf, set->cl[i], acc_sum, accs[i]);
     }
 }
 
@@ -231,31 +175,30 @@ clset_subsumption(struct XCSF *xcsf, struct Set *set)
 {
     // find the most general subsumer in the set
     struct Cl *s = NULL;
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        struct Cl *c = iter->cl;
+    for (int i = 0; i < set->size; ++i) {
+        struct Cl *c = set->cl[i];
         if (cl_subsumer(xcsf, c) && (s == NULL || cl_general(xcsf, c, s))) {
             s = c;
         }
-        iter = iter->next;
     }
     // subsume the more specific classifiers in the set
     if (s != NULL) {
         bool subsumed = false;
-        iter = set->list;
-        while (iter != NULL) {
-            struct Cl *c = iter->cl;
+        for (int i = 0; i < set->size; ++i) {
+            struct Cl *c = set->cl[i];
             if (c != NULL && s != c && cl_general(xcsf, s, c)) {
                 s->num += c->num;
                 c->num = 0;
                 clset_add(&xcsf->kset, c);
+                clset_stats_remove(xcsf, c);
                 subsumed = true;
             }
-            iter = iter->next;
         }
         if (subsumed) {
             clset_validate(set);
             clset_validate(&xcsf->pset);
+            clset_soa_refresh(xcsf);
+            clset_del_invalidate(xcsf);
         }
     }
 }
@@ -269,10 +212,8 @@ static double
 clset_total_time(const struct Set *set)
 {
     double sum = 0;
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        sum += iter->cl->time * iter->cl->num;
-        iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        sum += set->cl[i]->time * set->cl[i]->num;
     }
     return sum;
 }
@@ -312,10 +253,10 @@ clset_pset_init(struct XCSF *xcsf)
     }
     if (xcsf->POP_INIT) {
         while (xcsf->pset.num < xcsf->POP_SIZE) {
-            struct Cl *new = malloc(sizeof(struct Cl));
+            struct Cl *new = cl_alloc(xcsf);
             cl_init(xcsf, new, xcsf->POP_SIZE, 0);
             cl_rand(xcsf, new);
-            clset_add(&xcsf->pset, new);
+            clset_pset_add(xcsf, new);
         }
     }
 }
@@ -327,7 +268,19 @@ clset_pset_init(struct XCSF *xcsf)
 void
 clset_init(struct Set *set)
 {
-    set->list = NULL;
+    set->cl = NULL;
+    set->size = 0;
+    set->num = 0;
+    set->capacity = 0;
+}
+
+/**
+ * @brief Empties the set, but keeps its memory for reuse.
+ * @param [in] set The set to be emptied.
+ */
+void
+clset_clear(struct Set *set)
+{
     set->size = 0;
     set->num = 0;
 }
@@ -339,60 +292,112 @@ clset_init(struct Set *set)
 void
 clset_pset_enforce_limit(struct XCSF *xcsf)
 {
+    if (xcsf->pset.num > xcsf->POP_SIZE) {
+        clset_del_prepare(xcsf);
+    }
     while (xcsf->pset.num > xcsf->POP_SIZE) {
         clset_pset_del(xcsf);
     }
 }
 
 /**
- * @brief Constructs the match set - forward propagates conditions and actions.
- * @details Processes the matching conditions and actions for each classifier
- * in the population. If a classifier matches, it is added to the match set.
+ * @brief Constructs the match set by testing each rule individually.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] x The input state.
- * @param [in] cover Whether to check action set coverage.
  */
-void
-clset_match(struct XCSF *xcsf, const double *x, const bool cover)
+static void
+clset_match_each(struct XCSF *xcsf, const double *x)
 {
+    const struct Set *pset = &xcsf->pset;
 #ifdef PARALLEL_MATCH
-    // prepare for parallel processing of matching conditions
-    struct Clist *blist[xcsf->pset.size];
-    struct Clist *iter = xcsf->pset.list;
-    for (int i = 0; iter != NULL && i < xcsf->pset.size; ++i) {
-        blist[i] = iter;
-        iter = iter->next;
-    }
     // process conditions and actions setting m flags in parallel
     #pragma omp parallel for
-    for (int i = 0; i < xcsf->pset.size; ++i) {
-        cl_match(xcsf, blist[i]->cl, x);
-        cl_action(xcsf, blist[i]->cl, x);
+    for (int i = 0; i < pset->size; ++i) {
+        cl_match(xcsf, pset->cl[i], x);
+        cl_action(xcsf, pset->cl[i], x);
     }
     // build match set list in series
-    for (int i = 0; i < xcsf->pset.size; ++i) {
-        if (cl_m(xcsf, blist[i]->cl)) {
-            clset_add(&xcsf->mset, blist[i]->cl);
+    for (int i = 0; i < pset->size; ++i) {
+        if (cl_m(xcsf, pset->cl[i])) {
+            clset_add(&xcsf->mset, pset->cl[i]);
         }
+        clset_del_aged(xcsf, pset->cl[i], 1, pset->cl[i]->m);
     }
 #else
     // process conditions and actions and build match set list in series
-    struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        if (cl_match(xcsf, iter->cl, x)) {
-            clset_add(&xcsf->mset, iter->cl);
-            cl_action(xcsf, iter->cl, x);
+    for (int i = 0; i < pset->size; ++i) {
+        if (cl_match(xcsf, pset->cl[i], x)) {
+            clset_add(&xcsf->mset, pset->cl[i]);
+            cl_action(xcsf, pset->cl[i], x);
         }
-        iter = iter->next;
+        clset_del_aged(xcsf, pset->cl[i], 1, pset->cl[i]->m);
     }
 #endif
+}
+
+/**
+ * @brief Constructs the match set using the SoA batch matcher.
+ * @details Produces the same match set as testing each rule individually.
+ * Only the rules whose bits are set are added to the match set and have
+ * their actions processed; every rule still records the outcome since the
+ * match counts and experience of non-matching rules are also updated.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input state.
+ */
+static void
+clset_match_batch(struct XCSF *xcsf, const double *x)
+{
+    const struct Set *pset = &xcsf->pset;
+    const uint64_t *bitmap = clset_soa_match(xcsf, x);
+    // record the match outcome of every rule
+    for (int i = 0; i < pset->size; ++i) {
+        cl_match_set(xcsf, pset->cl[i], clset_soa_bit(bitmap, i));
+        clset_del_aged(xcsf, pset->cl[i], 1, pset->cl[i]->m);
+    }
+    // build match set list from the set bits in series
+    const int n_words = clset_soa_words(pset->size);
+    for (int i = 0; i < n_words; ++i) {
+        uint64_t word = bitmap[i];
+        for (int j = i * 64; word != 0; ++j, word >>= 1) {
+            if (word & 1) {
+                clset_add(&xcsf->mset, pset->cl[j]);
+            }
+        }
+    }
+    // process the actions of the matching rules
+#ifdef PARALLEL_MATCH
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < xcsf->mset.size; ++i) {
+        cl_action(xcsf, xcsf->mset.cl[i], x);
+    }
+}
+
+/**
+ * @brief Constructs the match set - forward propagates conditions and actions.
+ * @details Processes the matching conditions and actions for each classifier
+ * in the population. If a classifier matches, it is added to the match set.
+ * Hyperrectangle, hyperellipsoid and ternary conditions are tested in
+ * batches using the population-wide SoA store.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input state.
+ * @param [in] cover Whether to check action set coverage.
+ */
+void
+clset_match(struct XCSF *xcsf, const double *x, const bool cover)
+{
+    if (clset_soa_enabled(xcsf)) {
+        clset_match_batch(xcsf, x);
+    } else {
+        clset_match_each(xcsf, x);
+    }
     // perform covering if all actions are not represented
     if (cover && (xcsf->n_actions > 1 || xcsf->mset.size < 1)) {
         clset_cover(xcsf, x);
     }
     // update statistics
     xcsf->mset_size += (xcsf->mset.size - xcsf->mset_size) * xcsf->BETA;
-    xcsf->mfrac += (clset_mfrac(xcsf) - xcsf->mfrac) * xcsf->BETA;
+    xcsf->mfrac += (clset_stats_mfrac(xcsf) - xcsf->mfrac) * xcsf->BETA;
 }
 
 /**
@@ -403,12 +408,10 @@ clset_match(struct XCSF *xcsf, const double *x, const bool cover)
 void
 clset_action(struct XCSF *xcsf, const int action)
 {
-    const struct Clist *iter = xcsf->mset.list;
-    while (iter != NULL) {
-        if (iter->cl->action == action) {
-            clset_add(&xcsf->aset, iter->cl);
+    for (int i = 0; i < xcsf->mset.size; ++i) {
+        if (xcsf->mset.cl[i]->action == action) {
+            clset_add(&xcsf->aset, xcsf->mset.cl[i]);
         }
-        iter = iter->next;
     }
     // update statistics
     xcsf->aset_size += (xcsf->aset.size - xcsf->aset_size) * xcsf->BETA;
@@ -422,20 +425,29 @@ clset_action(struct XCSF *xcsf, const int action)
 void
 clset_add(struct Set *set, struct Cl *c)
 {
-    if (set->list == NULL) {
-        set->list = malloc(sizeof(struct Clist));
-        set->list->cl = c;
-        set->list->next = NULL;
-    } else {
-        struct Clist *new = malloc(sizeof(struct Clist));
-        new->cl = c;
-        new->next = set->list;
-        set->list = new;
-    }
+    clset_reserve(set, set->size + 1);
+    set->cl[set->size] = c;
     ++(set->size);
     set->num += c->num;
 }
 
+/**
+ * @brief Adds a classifier to the population set.
+ * @details Rules entering the population should be added with this function
+ * rather than clset_add() so that the running statistics are kept in step.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier to add.
+ */
+void
+clset_pset_add(struct XCSF *xcsf, struct Cl *c)
+{
+    clset_add(&xcsf->pset, c);
+    c->slot = xcsf->pset.size - 1;
+    clset_stats_add(xcsf, c);
+    clset_soa_update(xcsf, c->slot);
+    clset_del_touch(xcsf, c);
+}
+
 /**
  * @brief Provides reinforcement to the set and performs set subsumption.
  * @param [in] xcsf The XCSF data structure.
@@ -449,24 +461,15 @@ clset_update(struct XCSF *xcsf, struct Set *set, const double *x,
              const double *y, const bool cur)
 {
 #ifdef PARALLEL_UPDATE
-    struct Clist *blist[set->size];
-    struct Clist *iter = set->list;
-    for (int i = 0; iter != NULL && i < set->size; ++i) {
-        blist[i] = iter;
-        iter = iter->next;
-    }
     #pragma omp parallel for
+#endif
     for (int i = 0; i < set->size; ++i) {
-        cl_update(xcsf, blist[i]->cl, x, y, set->num, cur);
-    }
-#else
-    struct Clist *iter = set->list;
-    while (iter != NULL) {
-        cl_update(xcsf, iter->cl, x, y, set->num, cur);
-        iter = iter->next;
+        cl_update(xcsf, set->cl[i], x, y, set->num, cur);
     }
-#endif
     clset_update_fit(xcsf, set);
+    for (int i = 0; i < set->size; ++i) {
+        clset_del_touch(xcsf, set->cl[i]);
+    }
     if (xcsf->SET_SUBSUMPTION) {
         clset_subsumption(xcsf, set);
     }
@@ -479,28 +482,17 @@ clset_update(struct XCSF *xcsf, struct Set *set, const double *x,
 void
 clset_validate(struct Set *set)
 {
-    set->size = 0;
+    int size = 0;
     set->num = 0;
-    struct Clist *prev = NULL;
-    struct Clist *iter = set->list;
-    while (iter != NULL) {
-        if (iter->cl == NULL || iter->cl->num == 0) {
-            if (prev == NULL) {
-                set->list = iter->next;
-                free(iter);
-                iter = set->list;
-            } else {
-                prev->next = iter->next;
-                free(iter);
-                iter = prev->next;
-            }
-        } else {
-            ++(set->size);
-            set->num += iter->cl->num;
-            prev = iter;
-            iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        struct Cl *c = set->cl[i];
+        if (c != NULL && c->num > 0) {
+            set->cl[size] = c;
+            ++size;
+            set->num += c->num;
         }
     }
+    set->size = size;
 }
 
 /**
@@ -529,10 +521,8 @@ clset_print(const struct XCSF *xcsf, const struct Set *set,
 void
 clset_set_times(const struct XCSF *xcsf, const struct Set *set)
 {
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        iter->cl->time = xcsf->time;
-        iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        set->cl[i]->time = xcsf->time;
     }
 }
 
@@ -545,10 +535,8 @@ double
 clset_total_fit(const struct Set *set)
 {
     double sum = 0;
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        sum += iter->cl->fit;
-        iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        sum += set->cl[i]->fit;
     }
     return sum;
 }
@@ -571,14 +559,8 @@ clset_mean_time(const struct Set *set)
 void
 clset_free(struct Set *set)
 {
-    struct Clist *iter = set->list;
-    while (iter != NULL) {
-        set->list = iter->next;
-        free(iter);
-        iter = set->list;
-    }
-    set->size = 0;
-    set->num = 0;
+    free(set->cl);
+    clset_init(set);
 }
 
 /**
@@ -589,15 +571,25 @@ clset_free(struct Set *set)
 void
 clset_kill(const struct XCSF *xcsf, struct Set *set)
 {
-    struct Clist *iter = set->list;
-    while (iter != NULL) {
-        cl_free(xcsf, iter->cl);
-        set->list = iter->next;
-        free(iter);
-        iter = set->list;
+    for (int i = 0; i < set->size; ++i) {
+        cl_free(xcsf, set->cl[i]);
     }
-    set->size = 0;
-    set->num = 0;
+    clset_free(set);
+}
+
+/**
+ * @brief Frees the classifiers and empties the set, but keeps its memory for
+ * reuse.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] set The set to purge.
+ */
+void
+clset_purge(const struct XCSF *xcsf, struct Set *set)
+{
+    for (int i = 0; i < set->size; ++i) {
+        cl_free(xcsf, set->cl[i]);
+    }
+    clset_clear(set);
 }
 
 /**
@@ -612,10 +604,8 @@ clset_pset_save(const struct XCSF *xcsf, FILE *fp)
     size_t s = 0;
     s += fwrite(&xcsf->pset.size, sizeof(int), 1, fp);
     s += fwrite(&xcsf->pset.num, sizeof(int), 1, fp);
-    const struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        s += cl_save(xcsf, iter->cl, fp);
-        iter = iter->next;
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        s += cl_save(xcsf, xcsf->pset.cl[i], fp);
     }
     return s;
 }
@@ -635,8 +625,9 @@ clset_pset_load(struct XCSF *xcsf, FILE *fp)
     s += fread(&size, sizeof(int), 1, fp);
     s += fread(&num, sizeof(int), 1, fp);
     clset_init(&xcsf->pset);
+    clset_reserve(&xcsf->pset, size);
     for (int i = 0; i < size; ++i) {
-        struct Cl *c = malloc(sizeof(struct Cl));
+        struct Cl *c = cl_alloc(xcsf);
         s += cl_load(xcsf, c, fp);
         clset_add(&xcsf->pset, c);
     }
@@ -652,15 +643,14 @@ clset_pset_load(struct XCSF *xcsf, FILE *fp)
 double
 clset_mean_cond_size(const struct XCSF *xcsf, const struct Set *set)
 {
+    if (set == &xcsf->pset) {
+        return clset_stats_cond_size(xcsf) / set->size;
+    }
     double sum = 0;
-    int cnt = 0;
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        sum += cl_cond_size(xcsf, iter->cl);
-        ++cnt;
-        iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        sum += cl_cond_size(xcsf, set->cl[i]);
     }
-    return sum / cnt;
+    return sum / set->size;
 }
 
 /**
@@ -672,15 +662,14 @@ clset_mean_cond_size(const struct XCSF *xcsf, const struct Set *set)
 double
 clset_mean_pred_size(const struct XCSF *xcsf, const struct Set *set)
 {
+    if (set == &xcsf->pset) {
+        return clset_stats_pred_size(xcsf) / set->size;
+    }
     double sum = 0;
-    int cnt = 0;
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        sum += cl_pred_size(xcsf, iter->cl);
-        ++cnt;
-        iter = iter->next;
+    for (int i = 0; i < set->size; ++i) {
+        sum += cl_pred_size(xcsf, set->cl[i]);
     }
-    return sum / cnt;
+    return sum / set->size;
 }
 
 /**
@@ -692,30 +681,27 @@ clset_mean_pred_size(const struct XCSF *xcsf, const struct Set *set)
 double
 clset_mfrac(const struct XCSF *xcsf)
 {
+    const struct Set *pset = &xcsf->pset;
     double mfrac = 0;
     // most general rule below E0
-    const struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        const double e = iter->cl->err;
-        if (e < xcsf->E0 && iter->cl->exp * xcsf->BETA > 1) {
-            const double m = cl_mfrac(xcsf, iter->cl);
+    for (int i = 0; i < pset->size; ++i) {
+        const struct Cl *c = pset->cl[i];
+        if (c->err < xcsf->E0 && c->exp * xcsf->BETA > 1) {
+            const double m = cl_mfrac(xcsf, c);
             if (m > mfrac) {
                 mfrac = m;
             }
         }
-        iter = iter->next;
     }
     // lowest error rule
     if (mfrac == 0) {
         double error = DBL_MAX;
-        iter = xcsf->pset.list;
-        while (iter != NULL) {
-            const double e = iter->cl->err;
-            if (e < error && iter->cl->exp * xcsf->BETA > 1) {
-                mfrac = cl_mfrac(xcsf, iter->cl);
-                error = e;
+        for (int i = 0; i < pset->size; ++i) {
+            const struct Cl *c = pset->cl[i];
+            if (c->err < error && c->exp * xcsf->BETA > 1) {
+                mfrac = cl_mfrac(xcsf, c);
+                error = c->err;
             }
-            iter = iter->next;
         }
     }
     return mfrac;
@@ -737,14 +723,12 @@ clset_json_export(const struct XCSF *xcsf, const struct Set *set,
 {
     cJSON *json = cJSON_CreateObject();
     cJSON *classifiers = cJSON_AddArrayToObject(json, "classifiers");
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        char *str = cl_json_export(xcsf, iter->cl, return_cond, return_act,
+    for (int i = 0; i < set->size; ++i) {
+        char *str = cl_json_export(xcsf, set->cl[i], return_cond, return_act,
                                    return_pred);
         cJSON *classifier = cJSON_Parse(str);
         cJSON_AddItemToArray(classifiers, classifier);
         free(str);
-        iter = iter->next;
     }
     char *string = cJSON_Print(json);
     cJSON_Delete(json);
@@ -759,9 +743,9 @@ clset_json_export(const struct XCSF *xcsf, const struct Set *set,
 void
 clset_json_insert_cl(struct XCSF *xcsf, const cJSON *json)
 {
-    struct Cl *new = malloc(sizeof(struct Cl));
+    struct Cl *new = cl_alloc(xcsf);
     cl_json_import(xcsf, new, json);
-    clset_add(&xcsf->pset, new);
+    clset_pset_add(xcsf, new);
     clset_pset_enforce_limit(xcsf);
 }
 
@@ -776,14 +760,10 @@ clset_json_insert(struct XCSF *xcsf, const char *json_str)
     cJSON *json = cJSON_Parse(json_str);
     utils_json_parse_check(json);
     if (json->child != NULL && cJSON_IsArray(json->child)) {
-        cJSON *tail = json->child->child; // insert inverted for consistency
-        tail->prev = NULL; // this should have been set by cJSON!
-        while (tail->next != NULL) {
-            tail = tail->next;
-        }
-        while (tail != NULL) {
-            clset_json_insert_cl(xcsf, tail);
-            tail = tail->prev;
+        const cJSON *iter = json->child->child;
+        while (iter != NULL) {
+            clset_json_insert_cl(xcsf, iter);
+            iter = iter->next;
         }
     }
     cJSON_Delete(json);
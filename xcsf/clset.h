@@ -52,6 +52,12 @@ clset_action(struct XCSF *xcsf, const int action);
 void
 clset_add(struct Set *set, struct Cl *c);
 
+void
+clset_pset_add(struct XCSF *xcsf, struct Cl *c);
+
+void
+clset_clear(struct Set *set);
+
 void
 clset_free(struct Set *set);
 
@@ -61,6 +67,9 @@ clset_init(struct Set *set);
 void
 clset_kill(const struct XCSF *xcsf, struct Set *set);
 
+void
+clset_purge(const struct XCSF *xcsf, struct Set *set);
+
 void
 clset_match(struct XCSF *xcsf, const double *x, const bool cover);
 
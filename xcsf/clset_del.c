@@ -0,0 +1,505 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_del.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Deletion vote tree for selecting rules to remove from the population.
+ * @details The trees are built when the population first exceeds its limit
+ * and are then updated in logarithmic time as each rule is updated, added or
+ * deleted, so that enforcing the population limit does not require a pass
+ * over the population. A full rebuild only takes place after the population
+ * has been replaced or modified in place, or the mean fitness has drifted out
+ * of the range for which the vote forms were determined.
+ */
+
+#include "clset_del.h"
+#include "cl.h"
+#include "clset.h"
+#include "utils.h"
+
+#define DEL_BAND (0.05) //!< Relative range of mean fitness before a rebuild
+
+/**
+ * @brief Returns the number of bitmap words needed to hold n slots.
+ * @param [in] n The number of slots.
+ * @return The number of words.
+ */
+static int
+clset_del_words(const int n)
+{
+    return (n + 63) / 64;
+}
+
+/**
+ * @brief Sets or clears the bit for a slot in a bitmap.
+ * @param [in] bitmap The bitmap to modify.
+ * @param [in] i The slot.
+ * @param [in] on Whether to set the bit.
+ * @return Whether the bit was previously set.
+ */
+static bool
+clset_del_bit(uint64_t *bitmap, const int i, const bool on)
+{
+    const uint64_t mask = (uint64_t) 1 << (i & 63);
+    const bool was = (bitmap[i >> 6] & mask) != 0;
+    if (on) {
+        bitmap[i >> 6] |= mask;
+    } else {
+        bitmap[i >> 6] &= ~mask;
+    }
+    return was;
+}
+
+/**
+ * @brief Adds a value to a slot of a Fenwick tree.
+ * @param [in] tree The Fenwick tree.
+ * @param [in] n The number of slots in the tree.
+ * @param [in] i The slot.
+ * @param [in] v The value to add.
+ */
+static void
+clset_del_tree_add(double *tree, const int n, const int i, const double v)
+{
+    for (int k = i + 1; k <= n; k += k & -k) {
+        tree[k] += v;
+    }
+}
+
+/**
+ * @brief Returns the sum of the first n slots in a Fenwick tree.
+ * @param [in] tree The Fenwick tree.
+ * @param [in] n The number of slots to sum.
+ * @return The sum.
+ */
+static double
+clset_del_tree_sum(const double *tree, const int n)
+{
+    double sum = 0;
+    for (int k = n; k > 0; k -= k & -k) {
+        sum += tree[k];
+    }
+    return sum;
+}
+
+/**
+ * @brief Calculates the deletion vote of a classifier in split form.
+ * @details Equivalent to cl_del_vote() with the vote given by c + d * avg_fit.
+ * Rules whose vote form could change for a mean fitness in [lo, hi] are
+ * classified with the given mean and reported as being in the band.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] del The deletion vote tree.
+ * @param [in] cl The classifier.
+ * @param [in] avg_fit The population mean fitness.
+ * @param [out] c The vote independent of the mean fitness.
+ * @param [out] d The vote per unit of mean fitness.
+ * @return Whether the vote form depends on the mean fitness.
+ */
+static bool
+clset_del_vote(const struct XCSF *xcsf, const struct SetDel *del,
+               const struct Cl *cl, const double avg_fit, double *c, double *d)
+{
+    *c = cl->size * cl->num;
+    *d = 0;
+    if (cl->exp <= xcsf->THETA_DEL) {
+        return false;
+    }
+    bool band = false;
+    bool low = cl->fit < xcsf->DELTA * del->lo * cl->num;
+    if (!low && cl->fit < xcsf->DELTA * del->hi * cl->num) {
+        band = true;
+        low = cl->fit < xcsf->DELTA * avg_fit * cl->num;
+    }
+    if (low) {
+        *d = cl->size * cl->num / (cl->fit / cl->num);
+        *c = 0;
+    }
+    return band;
+}
+
+/**
+ * @brief Sets the votes and flags of a slot from a classifier.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] del The deletion vote tree.
+ * @param [in] i The slot.
+ * @param [in] cl The classifier now occupying the slot.
+ * @param [in] avg_fit The population mean fitness.
+ */
+static void
+clset_del_set(const struct XCSF *xcsf, struct SetDel *del, const int i,
+              const struct Cl *cl, const double avg_fit)
+{
+    double c = 0;
+    double d = 0;
+    const bool band = clset_del_vote(xcsf, del, cl, avg_fit, &c, &d);
+    clset_del_bit(del->band, i, band);
+    const bool never = cl->mtotal == 0 && cl->age > xcsf->M_PROBATION;
+    del->n_probation += never - clset_del_bit(del->probation, i, never);
+    if (c != del->c[i]) {
+        clset_del_tree_add(del->tc, del->n, i, c - del->c[i]);
+        del->c[i] = c;
+    }
+    if (d != del->d[i]) {
+        clset_del_tree_add(del->td, del->n, i, d - del->d[i]);
+        del->d[i] = d;
+    }
+    del->fit_sum += cl->fit - del->f[i];
+    del->f[i] = cl->fit;
+}
+
+/**
+ * @brief Empties a slot.
+ * @param [in] del The deletion vote tree.
+ * @param [in] i The slot.
+ */
+static void
+clset_del_clear(struct SetDel *del, const int i)
+{
+    clset_del_bit(del->band, i, false);
+    del->n_probation -= clset_del_bit(del->probation, i, false);
+    clset_del_tree_add(del->tc, del->n, i, -del->c[i]);
+    clset_del_tree_add(del->td, del->n, i, -del->d[i]);
+    del->fit_sum -= del->f[i];
+    del->c[i] = 0;
+    del->d[i] = 0;
+    del->f[i] = 0;
+}
+
+/**
+ * @brief Ensures the tree has room for at least n slots.
+ * @details The capacity grows geometrically so that rules can be appended
+ * without frequent rebuilds.
+ * @param [in] del The deletion vote tree.
+ * @param [in] n The minimum number of slots.
+ */
+static void
+clset_del_reserve(struct SetDel *del, const int n)
+{
+    if (n > del->capacity) {
+        int capacity = (del->capacity > 0) ? del->capacity : 64;
+        while (capacity < n) {
+            capacity *= 2;
+        }
+        const int words = clset_del_words(capacity);
+        del->tc = realloc(del->tc, sizeof(double) * (capacity + 1));
+        del->td = realloc(del->td, sizeof(double) * (capacity + 1));
+        del->c = realloc(del->c, sizeof(double) * capacity);
+        del->d = realloc(del->d, sizeof(double) * capacity);
+        del->f = realloc(del->f, sizeof(double) * capacity);
+        del->band = realloc(del->band, sizeof(uint64_t) * words);
+        del->probation = realloc(del->probation, sizeof(uint64_t) * words);
+        del->capacity = capacity;
+    }
+}
+
+/**
+ * @brief Appends an empty slot to the trees.
+ * @details The new node covers a range of existing slots whose sum is found
+ * from two prefix sums, so appending takes logarithmic time.
+ * @param [in] del The deletion vote tree.
+ */
+static void
+clset_del_append(struct SetDel *del)
+{
+    const int k = del->n + 1;
+    const int first = k - (k & -k);
+    del->tc[k] = clset_del_tree_sum(del->tc, k - 1) -
+        clset_del_tree_sum(del->tc, first);
+    del->td[k] = clset_del_tree_sum(del->td, k - 1) -
+        clset_del_tree_sum(del->td, first);
+    del->c[del->n] = 0;
+    del->d[del->n] = 0;
+    del->f[del->n] = 0;
+    clset_del_bit(del->band, del->n, false);
+    clset_del_bit(del->probation, del->n, false);
+    del->n = k;
+    if (del->top * 2 <= k) {
+        del->top *= 2;
+    }
+}
+
+/**
+ * @brief Rebuilds the trees from the current population.
+ * @details The trees are constructed in linear time by pushing each slot's
+ * value to its parent.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] del The deletion vote tree.
+ */
+static void
+clset_del_build(const struct XCSF *xcsf, struct SetDel *del)
+{
+    const struct Set *pset = &xcsf->pset;
+    const int n = pset->size;
+    clset_del_reserve(del, n);
+    del->n = n;
+    del->top = 1;
+    while (del->top * 2 <= n) {
+        del->top *= 2;
+    }
+    del->fit_sum = clset_total_fit(pset);
+    del->delta = xcsf->DELTA;
+    del->theta_del = xcsf->THETA_DEL;
+    del->m_probation = xcsf->M_PROBATION;
+    del->valid = true;
+    const double avg_fit = del->fit_sum / pset->num;
+    del->lo = avg_fit * (1 - DEL_BAND);
+    del->hi = avg_fit * (1 + DEL_BAND);
+    memset(del->band, 0, sizeof(uint64_t) * clset_del_words(n));
+    memset(del->probation, 0, sizeof(uint64_t) * clset_del_words(n));
+    del->n_probation = 0;
+    del->tc[0] = 0;
+    del->td[0] = 0;
+    for (int i = 0; i < n; ++i) {
+        struct Cl *cl = pset->cl[i];
+        cl->slot = i;
+        del->f[i] = cl->fit;
+        const bool band =
+            clset_del_vote(xcsf, del, cl, avg_fit, &del->c[i], &del->d[i]);
+        clset_del_bit(del->band, i, band);
+        if (cl->mtotal == 0 && cl->age > xcsf->M_PROBATION) {
+            clset_del_bit(del->probation, i, true);
+            ++(del->n_probation);
+        }
+        del->tc[i + 1] = del->c[i];
+        del->td[i + 1] = del->d[i];
+    }
+    for (int k = 1; k <= n; ++k) {
+        const int parent = k + (k & -k);
+        if (parent <= n) {
+            del->tc[parent] += del->tc[k];
+            del->td[parent] += del->td[k];
+        }
+    }
+}
+
+/**
+ * @brief Returns the first slot set in a bitmap.
+ * @param [in] bitmap The bitmap to search.
+ * @param [in] n The number of slots.
+ * @return The slot, or -1 if none are set.
+ */
+static int
+clset_del_first(const uint64_t *bitmap, const int n)
+{
+    const int words = clset_del_words(n);
+    for (int w = 0; w < words; ++w) {
+        if (bitmap[w] != 0) {
+            int b = 0;
+            while (((bitmap[w] >> b) & 1) == 0) {
+                ++b;
+            }
+            return w * 64 + b;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Performs a single roulette spin with the deletion vote.
+ * @details Descends the trees to find the first slot at which the cumulative
+ * vote reaches the spin, as a linear walk through the population would.
+ * @param [in] del The deletion vote tree.
+ * @param [in] size The number of rules in the population.
+ * @param [in] avg_fit The population mean fitness.
+ * @param [in] p The spin in [0, total vote].
+ * @return The selected slot.
+ */
+static int
+clset_del_spin(const struct SetDel *del, const int size, const double avg_fit,
+               const double p)
+{
+    int pos = 0;
+    double rem = p;
+    for (int step = del->top; step > 0; step /= 2) {
+        const int k = pos + step;
+        if (k <= del->n) {
+            const double v = del->tc[k] + del->td[k] * avg_fit;
+            if (v < rem) {
+                pos = k;
+                rem -= v;
+            }
+        }
+    }
+    return (pos < size) ? pos : size - 1;
+}
+
+/**
+ * @brief Ensures the deletion vote tree is ready for selecting rules.
+ * @details Must be called before selecting rules for deletion. The tree is
+ * built on first use and rebuilt if it has been invalidated or the deletion
+ * parameters have changed; otherwise it is already in step with the
+ * population.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_del_prepare(struct XCSF *xcsf)
+{
+    if (xcsf->del == NULL) {
+        xcsf->del = calloc(1, sizeof(struct SetDel));
+    }
+    struct SetDel *del = xcsf->del;
+    if (!del->valid || del->delta != xcsf->DELTA ||
+        del->theta_del != xcsf->THETA_DEL ||
+        del->m_probation != xcsf->M_PROBATION) {
+        clset_del_build(xcsf, del);
+    }
+}
+
+/**
+ * @brief Selects a classifier from the population for deletion.
+ * @details Rules that never match an input after their probation period are
+ * selected first. Otherwise, if compaction is enabled and the average system
+ * error is below E0, two classifiers are selected using roulette wheel
+ * selection with the deletion vote and the rule with the largest condition +
+ * prediction size is chosen. For fixed-length representations, the effect is
+ * the same as one roulette spin.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The population index of the rule to be deleted.
+ */
+int
+clset_del_select(struct XCSF *xcsf)
+{
+    struct SetDel *del = xcsf->del;
+    const struct Set *pset = &xcsf->pset;
+    if (del->n_probation > 0) {
+        return clset_del_first(del->probation, del->n);
+    }
+    double avg_fit = del->fit_sum / pset->num;
+    if (avg_fit < del->lo || avg_fit > del->hi) {
+        clset_del_build(xcsf, del);
+        avg_fit = del->fit_sum / pset->num;
+    } else {
+        const int words = clset_del_words(del->n);
+        for (int w = 0; w < words; ++w) {
+            const uint64_t word = del->band[w];
+            for (int b = 0; b < 64 && (word >> b) != 0; ++b) {
+                if ((word >> b) & 1) {
+                    const int i = w * 64 + b;
+                    clset_del_set(xcsf, del, i, pset->cl[i], avg_fit);
+                }
+            }
+        }
+    }
+    const double total_vote = clset_del_tree_sum(del->tc, del->n) +
+        clset_del_tree_sum(del->td, del->n) * avg_fit;
+    int sel = -1;
+    double delsize = 0;
+    const int n_spins = (xcsf->COMPACTION && xcsf->error < xcsf->E0) ? 2 : 1;
+    for (int i = 0; i < n_spins; ++i) {
+        const double p = rand_uniform(0, total_vote);
+        const int j = clset_del_spin(del, pset->size, avg_fit, p);
+        // select the rule for deletion if it is the largest sized winner
+        const double s =
+            cl_cond_size(xcsf, pset->cl[j]) + cl_pred_size(xcsf, pset->cl[j]);
+        if (sel < 0 || s > delsize) {
+            sel = j;
+            delsize = s;
+        }
+    }
+    return sel;
+}
+
+/**
+ * @brief Updates the tree after a rule has been deleted.
+ * @details If the rule's numerosity fell to zero, the last rule in the
+ * population is expected to have been moved into the vacated slot.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] slot The slot of the deleted rule.
+ * @param [in] c The deleted rule.
+ */
+void
+clset_del_update(struct XCSF *xcsf, const int slot, const struct Cl *c)
+{
+    struct SetDel *del = xcsf->del;
+    const struct Set *pset = &xcsf->pset;
+    const double avg_fit = del->fit_sum / pset->num;
+    if (c->num > 0) {
+        clset_del_set(xcsf, del, slot, c, avg_fit);
+        return;
+    }
+    clset_del_clear(del, pset->size);
+    if (slot < pset->size) {
+        clset_del_set(xcsf, del, slot, pset->cl[slot], avg_fit);
+    }
+}
+
+/**
+ * @brief Updates the tree after a classifier in the population has changed.
+ * @details Must be called whenever a rule is added to the population or the
+ * numerosity, experience, fitness or set size of a rule in the population is
+ * modified. A rule added at the end of the population is appended to the
+ * trees. Rules that are no longer in the population are ignored.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier that has changed.
+ */
+void
+clset_del_touch(struct XCSF *xcsf, const struct Cl *c)
+{
+    struct SetDel *del = xcsf->del;
+    const struct Set *pset = &xcsf->pset;
+    if (del == NULL || !del->valid || c->num < 1) {
+        return;
+    }
+    const int slot = c->slot;
+    if (slot < 0 || slot >= pset->size || pset->cl[slot] != c ||
+        slot > del->n) {
+        clset_del_invalidate(xcsf);
+        return;
+    }
+    if (slot == del->n) {
+        if (slot >= del->capacity) {
+            clset_del_invalidate(xcsf);
+            return;
+        }
+        clset_del_append(del);
+    }
+    clset_del_set(xcsf, del, slot, c, del->fit_sum / pset->num);
+}
+
+/**
+ * @brief Marks the deletion vote tree as needing to be rebuilt.
+ * @details Must be called whenever the population is replaced, reordered or
+ * modified in place other than through clset_del_touch().
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_del_invalidate(const struct XCSF *xcsf)
+{
+    if (xcsf->del != NULL) {
+        xcsf->del->valid = false;
+    }
+}
+
+/**
+ * @brief Frees the deletion vote tree.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_del_free(struct XCSF *xcsf)
+{
+    if (xcsf->del != NULL) {
+        free(xcsf->del->tc);
+        free(xcsf->del->td);
+        free(xcsf->del->c);
+        free(xcsf->del->d);
+        free(xcsf->del->f);
+        free(xcsf->del->band);
+        free(xcsf->del->probation);
+        free(xcsf->del);
+        xcsf->del = NULL;
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_del.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Deletion vote tree for selecting rules to remove from the population.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+#include <stdint.h>
+
+/**
+ * @brief Fenwick trees of the deletion votes of the population.
+ * @details The vote of a rule is either independent of the population mean
+ * fitness or proportional to it, so the votes are split across two trees and
+ * combined with the current mean when spinning the roulette wheel, which
+ * then takes logarithmic time. Slot i mirrors pset.cl[i]. Which of the two
+ * forms applies depends on the mean fitness; rules close enough to the
+ * threshold for this to change as rules are deleted are flagged and
+ * reclassified before each spin, and the trees are rebuilt if the mean
+ * leaves the range for which the remaining classes are known to hold. Rules
+ * that have never matched an input after their probation period are kept in
+ * a bitmap so that they can be deleted first without scanning the
+ * population. Once built, the trees are kept in step as rules are updated,
+ * added and deleted, and are only rebuilt after being invalidated.
+ */
+struct SetDel {
+    double *tc; //!< Fenwick tree of votes independent of the mean fitness
+    double *td; //!< Fenwick tree of votes per unit of mean fitness
+    double *c; //!< Vote of each slot independent of the mean fitness
+    double *d; //!< Vote of each slot per unit of mean fitness
+    double *f; //!< Fitness of the rule in each slot
+    uint64_t *band; //!< Slots whose vote form depends on the mean fitness
+    uint64_t *probation; //!< Slots holding rules that never matched an input
+    int n_probation; //!< Number of slots set in the probation bitmap
+    int n; //!< Number of slots in the trees
+    int top; //!< Largest power of two not exceeding the number of slots
+    int capacity; //!< Number of slots allocated
+    double fit_sum; //!< Sum of the fitnesses in the population
+    double lo; //!< Lowest mean fitness for which the vote forms are valid
+    double hi; //!< Highest mean fitness for which the vote forms are valid
+    double delta; //!< DELTA used to calculate the votes
+    int theta_del; //!< THETA_DEL used to calculate the votes
+    int m_probation; //!< M_PROBATION used to flag rules that never matched
+    bool valid; //!< Whether the trees are in step with the population
+};
+
+void
+clset_del_prepare(struct XCSF *xcsf);
+
+int
+clset_del_select(struct XCSF *xcsf);
+
+void
+clset_del_update(struct XCSF *xcsf, const int slot, const struct Cl *c);
+
+void
+clset_del_touch(struct XCSF *xcsf, const struct Cl *c);
+
+void
+clset_del_invalidate(const struct XCSF *xcsf);
+
+void
+clset_del_free(struct XCSF *xcsf);
+
+/**
+ * @brief Updates the tree after a classifier has been tested for matching.
+ * @details A rule that has not matched any input is flagged for deletion once
+ * its age passes the probation period, and the flag is cleared as soon as a
+ * flagged rule matches an input.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier in the population.
+ * @param [in] n The number of inputs the classifier was just tested against.
+ * @param [in] m The number of those inputs the classifier matched.
+ */
+static inline void
+clset_del_aged(struct XCSF *xcsf, const struct Cl *c, const int n, const int m)
+{
+    const bool was_never = c->mtotal == m && c->age - n > xcsf->M_PROBATION;
+    const bool never = c->mtotal == 0 && c->age > xcsf->M_PROBATION;
+    if (never != was_never) {
+        clset_del_touch(xcsf, c);
+    }
+}
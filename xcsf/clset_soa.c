@@ -0,0 +1,672 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_soa.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Structure-of-arrays store for batch matching conditions.
+ * @details The interval matching kernels are written as simple loops over
+ * contiguous slots so that they are auto-vectorised by the compiler; building
+ * with NATIVE_OPT enables the widest vector instructions available on the
+ * host. Ternary conditions are matched word-parallel from their packed masks
+ * against an input binarised once per call.
+ */
+
+#include "clset_soa.h"
+#include "cond_ellipsoid.h"
+#include "cond_rectangle.h"
+#include "cond_ternary.h"
+#include "condition.h"
+
+#define SOA_BLOCK (64) //!< Number of slots tested per bitmap word
+#define SOA_ALIGN (64) //!< Byte alignment of the bound blocks
+#define SOA_BINS (16) //!< Number of index bins per dimension
+#define SOA_SPARSE (8) //!< Candidates below which slots are tested one by one
+
+/**
+ * @brief Returns whether the population conditions can be batch matched.
+ * @details Supports ternary conditions and hyperrectangles and hyperellipsoids
+ * with fixed bounds; when the centers are updated towards the inputs (eta > 0)
+ * the rules are matched individually.
+ * @param [in] xcsf The XCSF data structure.
+ * @return Whether the SoA store is used for matching.
+ */
+bool
+clset_soa_enabled(const struct XCSF *xcsf)
+{
+    switch (xcsf->cond->type) {
+        case COND_TYPE_HYPERRECTANGLE_UBR:
+        case COND_TYPE_TERNARY:
+            return true;
+        case COND_TYPE_HYPERRECTANGLE_CSR:
+        case COND_TYPE_HYPERELLIPSOID:
+            return xcsf->cond->eta == 0;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Ensures the store has room for at least n slots.
+ * @details Growing the store changes the dimension and index strides so all
+ * slots are marked as stale and refilled by the caller.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] soa The SoA store.
+ * @param [in] n The number of slots required.
+ */
+static void
+clset_soa_reserve(const struct XCSF *xcsf, struct SetSoa *soa, const int n)
+{
+    if (n <= soa->capacity) {
+        return;
+    }
+    int capacity = (soa->capacity > 0) ? soa->capacity : SOA_BLOCK;
+    while (capacity < n) {
+        capacity *= 2;
+    }
+    const size_t len = (size_t) capacity * xcsf->x_dim;
+    free(soa->mem);
+    soa->mem = malloc(sizeof(double) * len * 2 + SOA_ALIGN);
+    const uintptr_t addr = (uintptr_t) soa->mem;
+    const uintptr_t mask = ~(uintptr_t) (SOA_ALIGN - 1);
+    soa->b1 = (double *) ((addr + SOA_ALIGN - 1) & mask);
+    soa->b2 = soa->b1 + len;
+    free(soa->index);
+    soa->index = calloc((size_t) xcsf->x_dim * SOA_BINS * capacity / SOA_BLOCK,
+                        sizeof(uint64_t));
+    soa->owner = realloc(soa->owner, sizeof(struct Cl *) * capacity);
+    soa->capacity = capacity;
+    soa->size = 0;
+    soa->valid = false;
+}
+
+/**
+ * @brief Ensures the match bitmap has room for at least n rules.
+ * @param [in] soa The SoA store.
+ * @param [in] n The number of rules to be matched.
+ */
+static void
+clset_soa_reserve_bitmap(struct SetSoa *soa, const int n)
+{
+    const int n_blocks = (n + SOA_BLOCK - 1) / SOA_BLOCK;
+    if (n_blocks > soa->n_blocks) {
+        soa->bitmap = realloc(soa->bitmap, sizeof(uint64_t) * n_blocks);
+        soa->n_blocks = n_blocks;
+    }
+}
+
+/**
+ * @brief Returns the index bin containing a value.
+ * @details Values outside [min, max] are placed in the first or last bin.
+ * The mapping is monotonic, so every value in an interval falls within the
+ * bins of its end points.
+ * @param [in] soa The SoA store.
+ * @param [in] v The value to locate.
+ * @return The bin number.
+ */
+static int
+clset_soa_bin(const struct SetSoa *soa, const double v)
+{
+    if (!(v > soa->min)) {
+        return 0;
+    }
+    if (v >= soa->max) {
+        return SOA_BINS - 1;
+    }
+    const int bin = (int) ((v - soa->min) / (soa->max - soa->min) * SOA_BINS);
+    return (bin < SOA_BINS) ? bin : SOA_BINS - 1;
+}
+
+/**
+ * @brief Records the bins overlapped by a slot's interval along a dimension.
+ * @param [in] soa The SoA store.
+ * @param [in] slot The slot to index.
+ * @param [in] dim The dimension.
+ * @param [in] lower The lower bound of the interval.
+ * @param [in] upper The upper bound of the interval.
+ */
+static void
+clset_soa_index(struct SetSoa *soa, const int slot, const int dim,
+                const double lower, const double upper)
+{
+    int first = 0;
+    int last = SOA_BINS - 1;
+    if (!isnan(lower) && !isnan(upper)) {
+        first = clset_soa_bin(soa, lower);
+        last = clset_soa_bin(soa, upper);
+    }
+    const int n_words = soa->capacity / SOA_BLOCK;
+    const uint64_t bit = (uint64_t) 1 << (slot & 63);
+    uint64_t *row = &soa->index[(size_t) dim * SOA_BINS * n_words];
+    for (int i = 0; i < SOA_BINS; ++i) {
+        if (i >= first && i <= last) {
+            row[i * n_words + (slot >> 6)] |= bit;
+        } else {
+            row[i * n_words + (slot >> 6)] &= ~bit;
+        }
+    }
+}
+
+/**
+ * @brief Copies the bounds of a classifier condition into a store slot.
+ * @param [in] soa The SoA store.
+ * @param [in] slot The slot to write.
+ * @param [in] c The classifier whose condition is copied.
+ */
+static void
+clset_soa_copy(struct SetSoa *soa, const int slot, const struct Cl *c)
+{
+    const int cap = soa->capacity;
+    if (soa->type == COND_TYPE_HYPERELLIPSOID) {
+        const struct CondEllipsoid *cond = c->cond;
+        for (int i = 0; i < soa->x_dim; ++i) {
+            soa->b1[i * cap + slot] = cond->center[i];
+            soa->b2[i * cap + slot] = cond->spread[i];
+            const double r = fabs(cond->spread[i]);
+            clset_soa_index(soa, slot, i, cond->center[i] - r,
+                            cond->center[i] + r);
+        }
+    } else if (soa->type == COND_TYPE_HYPERRECTANGLE_CSR) {
+        const struct CondRectangle *cond = c->cond;
+        for (int i = 0; i < soa->x_dim; ++i) {
+            soa->b1[i * cap + slot] = cond->b1[i];
+            soa->b2[i * cap + slot] = cond->b2[i];
+            const double r = fabs(cond->b2[i]);
+            clset_soa_index(soa, slot, i, cond->b1[i] - r, cond->b1[i] + r);
+        }
+    } else { // ubr
+        const struct CondRectangle *cond = c->cond;
+        for (int i = 0; i < soa->x_dim; ++i) {
+            soa->b1[i * cap + slot] = fmin(cond->b1[i], cond->b2[i]);
+            soa->b2[i * cap + slot] = fmax(cond->b1[i], cond->b2[i]);
+            clset_soa_index(soa, slot, i, soa->b1[i * cap + slot],
+                            soa->b2[i * cap + slot]);
+        }
+    }
+    soa->owner[slot] = c;
+}
+
+/**
+ * @brief Returns whether the store was built for the current configuration.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] soa The SoA store.
+ * @return Whether the stored bounds have the current type and shape.
+ */
+static bool
+clset_soa_current(const struct XCSF *xcsf, const struct SetSoa *soa)
+{
+    return soa->type == xcsf->cond->type && soa->x_dim == xcsf->x_dim &&
+        soa->min == xcsf->cond->min && soa->max == xcsf->cond->max;
+}
+
+/**
+ * @brief Rebuilds the store from the current population.
+ * @details Only called after the store has been invalidated; while it is
+ * valid the population hooks keep each slot in step with its rule.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] soa The SoA store.
+ */
+static void
+clset_soa_sync(const struct XCSF *xcsf, struct SetSoa *soa)
+{
+    const struct Set *pset = &xcsf->pset;
+    if (!clset_soa_current(xcsf, soa)) {
+        free(soa->mem);
+        soa->mem = NULL;
+        soa->capacity = 0;
+        soa->type = xcsf->cond->type;
+        soa->x_dim = xcsf->x_dim;
+        soa->min = xcsf->cond->min;
+        soa->max = xcsf->cond->max;
+        soa->valid = false;
+    }
+    if (soa->valid) {
+        return;
+    }
+    clset_soa_reserve(xcsf, soa, pset->size);
+    for (int i = 0; i < pset->size; ++i) {
+        clset_soa_copy(soa, i, pset->cl[i]);
+    }
+    soa->size = pset->size;
+    soa->valid = true;
+}
+
+/**
+ * @brief Returns the store if it is being kept in step with the population.
+ * @details A valid store is invalidated if it can no longer be maintained,
+ * e.g., because batch matching has been disabled, so that it is rebuilt
+ * when next used.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The SoA store, or NULL if it does not need updating.
+ */
+static struct SetSoa *
+clset_soa_tracked(struct XCSF *xcsf)
+{
+    struct SetSoa *soa = xcsf->soa;
+    if (soa == NULL || !soa->valid || soa->type == COND_TYPE_TERNARY) {
+        return NULL;
+    }
+    if (!clset_soa_enabled(xcsf) || !clset_soa_current(xcsf, soa) ||
+        xcsf->pset.size > soa->capacity) {
+        clset_soa_invalidate(xcsf);
+        return NULL;
+    }
+    return soa;
+}
+
+/**
+ * @brief Updates the store after the rule at one population index changed.
+ * @details Must be called whenever a rule is placed at index slot of the
+ * population, or the population shrinks, so that matching does not need to
+ * scan the whole population for changes. Growing beyond the allocated
+ * capacity invalidates the store, which is then rebuilt once when next used.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] slot The population index that changed.
+ */
+void
+clset_soa_update(struct XCSF *xcsf, const int slot)
+{
+    struct SetSoa *soa = clset_soa_tracked(xcsf);
+    if (soa != NULL) {
+        if (slot < xcsf->pset.size) {
+            clset_soa_copy(soa, slot, xcsf->pset.cl[slot]);
+        }
+        soa->size = xcsf->pset.size;
+    }
+}
+
+/**
+ * @brief Updates the store after the population has been compacted.
+ * @details Rules removed by subsumption are only freed at the end of the
+ * trial, so comparing the owner of each slot with the rule now at that index
+ * finds the slots that moved.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_soa_refresh(struct XCSF *xcsf)
+{
+    struct SetSoa *soa = clset_soa_tracked(xcsf);
+    if (soa != NULL) {
+        const struct Set *pset = &xcsf->pset;
+        for (int i = 0; i < pset->size; ++i) {
+            if (soa->owner[i] != pset->cl[i]) {
+                clset_soa_copy(soa, i, pset->cl[i]);
+            }
+        }
+        soa->size = pset->size;
+    }
+}
+
+/**
+ * @brief Updates the CSR hyperrectangle distances along one dimension.
+ * @param [in] b1 The centers of the rules in the block.
+ * @param [in] b2 The spreads of the rules in the block.
+ * @param [in] x The input value for this dimension.
+ * @param [in,out] dist The running maximum relative distances.
+ * @param [in] n The number of rules in the block.
+ */
+static void
+clset_soa_dist_csr(const double *b1, const double *b2, const double x,
+                   double *dist, const int n)
+{
+    for (int i = 0; i < n; ++i) {
+        const double d = fabs((x - b1[i]) / b2[i]);
+        dist[i] = (d > dist[i]) ? d : dist[i];
+    }
+}
+
+/**
+ * @brief Updates the UBR hyperrectangle distances along one dimension.
+ * @details The distance is set to one for any rule whose interval does not
+ * contain the input.
+ * @param [in] b1 The lower bounds of the rules in the block.
+ * @param [in] b2 The upper bounds of the rules in the block.
+ * @param [in] x The input value for this dimension.
+ * @param [in,out] dist The running distances.
+ * @param [in] n The number of rules in the block.
+ */
+static void
+clset_soa_dist_ubr(const double *b1, const double *b2, const double x,
+                   double *dist, const int n)
+{
+    for (int i = 0; i < n; ++i) {
+        dist[i] = ((x < b1[i]) | (x > b2[i])) ? 1 : dist[i];
+    }
+}
+
+/**
+ * @brief Updates the hyperellipsoid distances along one dimension.
+ * @param [in] b1 The centers of the rules in the block.
+ * @param [in] b2 The spreads of the rules in the block.
+ * @param [in] x The input value for this dimension.
+ * @param [in,out] dist The running sum of squared relative distances.
+ * @param [in] n The number of rules in the block.
+ */
+static void
+clset_soa_dist_ellipsoid(const double *b1, const double *b2, const double x,
+                         double *dist, const int n)
+{
+    for (int i = 0; i < n; ++i) {
+        const double d = (x - b1[i]) / b2[i];
+        dist[i] += d * d;
+    }
+}
+
+/**
+ * @brief Matches a block of up to 64 consecutive slots against an input.
+ * @details Distances are accumulated one dimension at a time and never
+ * decrease, so the block is abandoned as soon as no rule can still match.
+ * @param [in] soa The SoA store.
+ * @param [in] x The input state.
+ * @param [in] start The first slot in the block.
+ * @param [in] n The number of slots in the block.
+ * @return Bitmap word of the rules matching the input.
+ */
+static uint64_t
+clset_soa_match_block(const struct SetSoa *soa, const double *x,
+                      const int start, const int n)
+{
+    double dist[SOA_BLOCK] = { 0 };
+    for (int i = 0; i < soa->x_dim; ++i) {
+        const double *b1 = &soa->b1[i * soa->capacity + start];
+        const double *b2 = &soa->b2[i * soa->capacity + start];
+        switch (soa->type) {
+            case COND_TYPE_HYPERRECTANGLE_CSR:
+                clset_soa_dist_csr(b1, b2, x[i], dist, n);
+                break;
+            case COND_TYPE_HYPERRECTANGLE_UBR:
+                clset_soa_dist_ubr(b1, b2, x[i], dist, n);
+                break;
+            default:
+                clset_soa_dist_ellipsoid(b1, b2, x[i], dist, n);
+                break;
+        }
+        int alive = 0;
+        for (int j = 0; j < n; ++j) {
+            alive |= (dist[j] < 1);
+        }
+        if (!alive) {
+            return 0;
+        }
+    }
+    uint64_t word = 0;
+    for (int j = 0; j < n; ++j) {
+        word |= (uint64_t) (dist[j] < 1) << j;
+    }
+    return word;
+}
+
+/**
+ * @brief Matches a single slot against an input.
+ * @details Performs the same operations as clset_soa_match_block() for one
+ * rule, reading its bounds with a stride of one block per dimension.
+ * @param [in] soa The SoA store.
+ * @param [in] x The input state.
+ * @param [in] slot The slot to test.
+ * @return Whether the rule matches the input.
+ */
+static bool
+clset_soa_match_slot(const struct SetSoa *soa, const double *x, const int slot)
+{
+    double dist = 0;
+    for (int i = 0; i < soa->x_dim; ++i) {
+        const double b1 = soa->b1[i * soa->capacity + slot];
+        const double b2 = soa->b2[i * soa->capacity + slot];
+        switch (soa->type) {
+            case COND_TYPE_HYPERRECTANGLE_CSR:
+                clset_soa_dist_csr(&b1, &b2, x[i], &dist, 1);
+                break;
+            case COND_TYPE_HYPERRECTANGLE_UBR:
+                clset_soa_dist_ubr(&b1, &b2, x[i], &dist, 1);
+                break;
+            default:
+                clset_soa_dist_ellipsoid(&b1, &b2, x[i], &dist, 1);
+                break;
+        }
+        if (!(dist < 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the candidate slots that may match an input.
+ * @details Intersects the index bins containing the input along every
+ * dimension. All slots are candidates if the input contains a NaN.
+ * @param [in] soa The SoA store.
+ * @param [in] x The input state.
+ * @param [out] candidates Bitmap of candidate slots.
+ * @param [in] n_blocks The number of bitmap words to compute.
+ */
+static void
+clset_soa_candidates(const struct SetSoa *soa, const double *x,
+                     uint64_t *candidates, const int n_blocks)
+{
+    for (int i = 0; i < soa->x_dim; ++i) {
+        if (isnan(x[i])) {
+            for (int j = 0; j < n_blocks; ++j) {
+                candidates[j] = ~(uint64_t) 0;
+            }
+            return;
+        }
+    }
+    const int n_words = soa->capacity / SOA_BLOCK;
+    for (int i = 0; i < soa->x_dim; ++i) {
+        const int bin = i * SOA_BINS + clset_soa_bin(soa, x[i]);
+        const uint64_t *row = &soa->index[(size_t) bin * n_words];
+        if (i == 0) {
+            memcpy(candidates, row, sizeof(uint64_t) * n_blocks);
+        } else {
+            for (int j = 0; j < n_blocks; ++j) {
+                candidates[j] &= row[j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Matches the hyperrectangles or hyperellipsoids in the population.
+ * @details Only rules within the index bins of the input are tested. Blocks
+ * with few candidates are tested one rule at a time and the rest with the
+ * vectorised block kernel. The store must already be synchronised with the
+ * population.
+ * @param [in] soa The SoA store.
+ * @param [in] x The input state.
+ * @param [out] bitmap The match results, one bit per slot.
+ */
+static void
+clset_soa_match_interval(const struct SetSoa *soa, const double *x,
+                         uint64_t *bitmap)
+{
+    const int n_blocks = (soa->size + SOA_BLOCK - 1) / SOA_BLOCK;
+    clset_soa_candidates(soa, x, bitmap, n_blocks);
+#ifdef PARALLEL_MATCH
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < n_blocks; ++i) {
+        const int start = i * SOA_BLOCK;
+        const int n = (soa->size - start < SOA_BLOCK) ? soa->size - start
+                                                      : SOA_BLOCK;
+        uint64_t candidates = bitmap[i];
+        if (n < SOA_BLOCK) {
+            candidates &= ((uint64_t) 1 << n) - 1;
+        }
+        int n_candidates = 0;
+        for (uint64_t w = candidates; w != 0; w &= w - 1) {
+            ++n_candidates;
+        }
+        if (n_candidates == 0) {
+            bitmap[i] = 0;
+        } else if (n_candidates < SOA_SPARSE) {
+            uint64_t word = 0;
+            for (int j = 0; j < n; ++j) {
+                if (((candidates >> j) & 1) &&
+                    clset_soa_match_slot(soa, x, start + j)) {
+                    word |= (uint64_t) 1 << j;
+                }
+            }
+            bitmap[i] = word;
+        } else {
+            const uint64_t word = clset_soa_match_block(soa, x, start, n);
+            bitmap[i] = candidates & word;
+        }
+    }
+}
+
+/**
+ * @brief Matches the ternary conditions in the population.
+ * @details The input is binarised once and compared with each rule's packed
+ * masks a machine word at a time.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input state.
+ * @param [out] bitmap The match results, one bit per rule.
+ */
+static void
+clset_soa_match_ternary(const struct XCSF *xcsf, const double *x,
+                        uint64_t *bitmap)
+{
+    const struct Set *pset = &xcsf->pset;
+    uint64_t bits[(xcsf->x_dim * xcsf->cond->bits + 63) / 64];
+    cond_ternary_binarise(xcsf, x, bits);
+    const int n_blocks = (pset->size + SOA_BLOCK - 1) / SOA_BLOCK;
+#ifdef PARALLEL_MATCH
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < n_blocks; ++i) {
+        const int start = i * SOA_BLOCK;
+        const int n = (pset->size - start < SOA_BLOCK) ? pset->size - start
+                                                       : SOA_BLOCK;
+        uint64_t word = 0;
+        for (int j = 0; j < n; ++j) {
+            if (cond_ternary_match_bits(pset->cl[start + j], bits)) {
+                word |= (uint64_t) 1 << j;
+            }
+        }
+        bitmap[i] = word;
+    }
+}
+
+/**
+ * @brief Creates the store if needed and rebuilds it if it is invalid.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The SoA store.
+ */
+static struct SetSoa *
+clset_soa_prepare(struct XCSF *xcsf)
+{
+    if (xcsf->soa == NULL) {
+        xcsf->soa = calloc(1, sizeof(struct SetSoa));
+    }
+    if (xcsf->cond->type != COND_TYPE_TERNARY) {
+        clset_soa_sync(xcsf, xcsf->soa);
+    }
+    return xcsf->soa;
+}
+
+/**
+ * @brief Tests every rule in the population against one input.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] soa The synchronised SoA store.
+ * @param [in] x The input state.
+ * @param [out] bitmap The match results, one bit per rule.
+ */
+static void
+clset_soa_match_into(const struct XCSF *xcsf, const struct SetSoa *soa,
+                     const double *x, uint64_t *bitmap)
+{
+    if (xcsf->cond->type == COND_TYPE_TERNARY) {
+        clset_soa_match_ternary(xcsf, x, bitmap);
+    } else {
+        clset_soa_match_interval(soa, x, bitmap);
+    }
+}
+
+/**
+ * @brief Tests every rule in the population against an input.
+ * @details The store is created on first use and rebuilt if it has been
+ * invalidated; otherwise it is already in step with the population.
+ * Classifier match flags are not modified.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input state.
+ * @return Bitmap with bit i set if pset.cl[i] matches the input.
+ */
+const uint64_t *
+clset_soa_match(struct XCSF *xcsf, const double *x)
+{
+    struct SetSoa *soa = clset_soa_prepare(xcsf);
+    clset_soa_reserve_bitmap(soa, xcsf->pset.size);
+    clset_soa_match_into(xcsf, soa, x, soa->bitmap);
+    return soa->bitmap;
+}
+
+/**
+ * @brief Tests every rule in the population against several inputs.
+ * @details The store is synchronised once and the inputs are then matched
+ * concurrently, each writing only to its own bitmap. Classifier match flags
+ * are not modified.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input states.
+ * @param [in] n_rows The number of input states.
+ * @param [out] bitmaps One bitmap of clset_soa_words() words for each input.
+ */
+void
+clset_soa_match_rows(struct XCSF *xcsf, const double *x, const int n_rows,
+                     uint64_t *bitmaps)
+{
+    const struct SetSoa *soa = clset_soa_prepare(xcsf);
+    const int n_words = clset_soa_words(xcsf->pset.size);
+#ifdef PARALLEL_MATCH
+    #pragma omp parallel for
+#endif
+    for (int r = 0; r < n_rows; ++r) {
+        clset_soa_match_into(xcsf, soa, &x[r * xcsf->x_dim],
+                             &bitmaps[r * n_words]);
+    }
+}
+
+/**
+ * @brief Marks all slots as stale.
+ * @details Must be called whenever the population is replaced wholesale, since
+ * rules may then be allocated at the addresses of rules previously stored.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_soa_invalidate(struct XCSF *xcsf)
+{
+    if (xcsf->soa != NULL) {
+        xcsf->soa->size = 0;
+        xcsf->soa->valid = false;
+    }
+}
+
+/**
+ * @brief Frees the SoA store.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_soa_free(struct XCSF *xcsf)
+{
+    if (xcsf->soa != NULL) {
+        free(xcsf->soa->mem);
+        free(xcsf->soa->index);
+        free(xcsf->soa->owner);
+        free(xcsf->soa->bitmap);
+        free(xcsf->soa);
+        xcsf->soa = NULL;
+    }
+}
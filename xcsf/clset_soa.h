@@ -0,0 +1,103 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_soa.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Structure-of-arrays store for batch matching conditions.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+#include <stdint.h>
+
+/**
+ * @brief Population-wide structure-of-arrays condition store.
+ * @details Holds the bounds of every hyperrectangle or hyperellipsoid in the
+ * population in dimension-major blocks so that one input dimension can be
+ * compared against many rules with contiguous vector loads. Slot i mirrors
+ * the condition of pset.cl[i] and is updated by the population hooks
+ * whenever the rule in that position changes. A grid index records, for each
+ * dimension and each of a fixed number of bins spanning [cond->min,
+ * cond->max], which slots have an interval overlapping that bin; intersecting
+ * the bins containing an input yields a small set of candidate rules to test
+ * exactly. Ternary conditions
+ * are already packed and are matched directly from the population, so only
+ * the bitmap is used.
+ */
+struct SetSoa {
+    void *mem; //!< Allocation holding both bound arrays
+    double *b1; //!< Centers (CSR, ellipsoid) or lower bounds (UBR)
+    double *b2; //!< Spreads (CSR, ellipsoid) or upper bounds (UBR)
+    uint64_t *index; //!< Slot bitmaps for each bin of each dimension
+    const struct Cl **owner; //!< Classifier whose bounds occupy each slot
+    uint64_t *bitmap; //!< Match results, one bit per slot
+    int n_blocks; //!< Number of bitmap words allocated
+    int size; //!< Number of slots holding valid bounds
+    int capacity; //!< Number of slots allocated per dimension
+    int type; //!< Condition type of the stored bounds
+    int x_dim; //!< Number of input dimensions stored
+    bool valid; //!< Whether the slots are in step with the population
+    double min; //!< Minimum value of the indexed range
+    double max; //!< Maximum value of the indexed range
+};
+
+bool
+clset_soa_enabled(const struct XCSF *xcsf);
+
+const uint64_t *
+clset_soa_match(struct XCSF *xcsf, const double *x);
+
+void
+clset_soa_match_rows(struct XCSF *xcsf, const double *x, const int n_rows,
+                     uint64_t *bitmaps);
+
+void
+clset_soa_free(struct XCSF *xcsf);
+
+void
+clset_soa_invalidate(struct XCSF *xcsf);
+
+void
+clset_soa_refresh(struct XCSF *xcsf);
+
+void
+clset_soa_update(struct XCSF *xcsf, const int slot);
+
+/**
+ * @brief Returns whether a slot matched the last input tested.
+ * @param [in] bitmap Match bitmap returned by clset_soa_match().
+ * @param [in] i The population index of the classifier.
+ * @return Whether the classifier matched.
+ */
+static inline bool
+clset_soa_bit(const uint64_t *bitmap, const int i)
+{
+    return (bitmap[i >> 6] >> (i & 63)) & 1;
+}
+
+/**
+ * @brief Returns the number of bitmap words needed to hold n match results.
+ * @param [in] n The number of rules.
+ * @return The number of words.
+ */
+static inline int
+clset_soa_words(const int n)
+{
+    return (n + 63) / 64;
+}
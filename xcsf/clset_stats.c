@@ -0,0 +1,284 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_stats.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Running statistics of the population set.
+ * @details Every rule in the population is tested against each input, so
+ * the ages of the rules present when the candidates are chosen all advance
+ * together. A rule with mtotal m and age a can reach at most (m + k) / (a + k)
+ * after k more inputs, while the leader with mtotal n and age b retains at
+ * least n / (b + k). Rules that cannot reach the leader's lower bound within
+ * the window are therefore safe to ignore until the next full scan, and the
+ * reported match fraction is identical to clset_mfrac().
+ */
+
+#include "clset_stats.h"
+#include "cl.h"
+#include "clset.h"
+
+#define STATS_WINDOW (32) //!< Number of inputs between full scans
+#define STATS_INIT_CAPACITY (16) //!< Initial number of candidates allocated
+
+/**
+ * @brief Returns whether a rule is considered when measuring generality.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier.
+ * @return Whether the rule is experienced and has error below E0.
+ */
+static bool
+clset_stats_eligible(const struct XCSF *xcsf, const struct Cl *c)
+{
+    return c->err < xcsf->E0 && c->exp * xcsf->BETA > 1;
+}
+
+/**
+ * @brief Appends a rule to the candidates.
+ * @param [in] stats The population statistics.
+ * @param [in] c The classifier.
+ */
+static void
+clset_stats_push(struct SetStats *stats, const struct Cl *c)
+{
+    if (stats->n_cand >= stats->capacity) {
+        stats->capacity = (stats->capacity < 1) ? STATS_INIT_CAPACITY
+                                                : stats->capacity * 2;
+        stats->cand =
+            realloc(stats->cand, sizeof(struct Cl *) * stats->capacity);
+    }
+    stats->cand[stats->n_cand] = c;
+    ++(stats->n_cand);
+}
+
+/**
+ * @brief Finds the generality leader and its candidates with a full scan.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] stats The population statistics.
+ * @return The fraction of inputs matched by the leader.
+ */
+static double
+clset_stats_refresh(const struct XCSF *xcsf, struct SetStats *stats)
+{
+    const struct Set *pset = &xcsf->pset;
+    const struct Cl *leader = NULL;
+    double mfrac = 0;
+    for (int i = 0; i < pset->size; ++i) {
+        const struct Cl *c = pset->cl[i];
+        if (clset_stats_eligible(xcsf, c)) {
+            const double m = cl_mfrac(xcsf, c);
+            if (m > mfrac) {
+                mfrac = m;
+                leader = c;
+            }
+        }
+    }
+    stats->n_cand = 0;
+    stats->valid = false;
+    if (leader == NULL) {
+        return clset_mfrac(xcsf); // use the lowest error rule
+    }
+    const double bound = (double) leader->mtotal / (leader->age + STATS_WINDOW);
+    for (int i = 0; i < pset->size; ++i) {
+        const struct Cl *c = pset->cl[i];
+        if (c != leader &&
+            (double) (c->mtotal + STATS_WINDOW) / (c->age + STATS_WINDOW) >=
+                bound) {
+            clset_stats_push(stats, c);
+        }
+    }
+    stats->leader = leader;
+    stats->age = leader->age;
+    stats->valid = true;
+    return mfrac;
+}
+
+/**
+ * @brief Calculates the total condition and prediction sizes.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [out] cond_size The total condition size.
+ * @param [out] pred_size The total prediction size.
+ */
+static void
+clset_stats_sizes(const struct XCSF *xcsf, double *cond_size,
+                  double *pred_size)
+{
+    const struct Set *pset = &xcsf->pset;
+    *cond_size = 0;
+    *pred_size = 0;
+    for (int i = 0; i < pset->size; ++i) {
+        *cond_size += cl_cond_size(xcsf, pset->cl[i]);
+        *pred_size += cl_pred_size(xcsf, pset->cl[i]);
+    }
+}
+
+/**
+ * @brief Returns the fraction of inputs matched by the most general rule with
+ * error below E0. If no rules below E0, the lowest error rule is used.
+ * @details Equivalent to clset_mfrac() but only examines the candidates for
+ * the leader between full scans.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The fraction of inputs matched.
+ */
+double
+clset_stats_mfrac(struct XCSF *xcsf)
+{
+    struct SetStats *stats = xcsf->stats;
+    if (stats == NULL) {
+        return clset_mfrac(xcsf);
+    }
+    if (!stats->valid || stats->leader->age - stats->age > STATS_WINDOW ||
+        !clset_stats_eligible(xcsf, stats->leader)) {
+        return clset_stats_refresh(xcsf, stats);
+    }
+    double mfrac = cl_mfrac(xcsf, stats->leader);
+    for (int i = 0; i < stats->n_cand; ++i) {
+        const struct Cl *c = stats->cand[i];
+        if (clset_stats_eligible(xcsf, c)) {
+            const double m = cl_mfrac(xcsf, c);
+            if (m > mfrac) {
+                mfrac = m;
+            }
+        }
+    }
+    return mfrac;
+}
+
+/**
+ * @brief Returns the total condition size of the population.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The sum of the condition sizes.
+ */
+double
+clset_stats_cond_size(const struct XCSF *xcsf)
+{
+    struct SetStats *stats = xcsf->stats;
+    if (stats == NULL) {
+        double cond_size = 0;
+        double pred_size = 0;
+        clset_stats_sizes(xcsf, &cond_size, &pred_size);
+        return cond_size;
+    }
+    if (!stats->sizes_valid) {
+        clset_stats_sizes(xcsf, &stats->cond_size, &stats->pred_size);
+        stats->sizes_valid = true;
+    }
+    return stats->cond_size;
+}
+
+/**
+ * @brief Returns the total prediction size of the population.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The sum of the prediction sizes.
+ */
+double
+clset_stats_pred_size(const struct XCSF *xcsf)
+{
+    struct SetStats *stats = xcsf->stats;
+    if (stats == NULL) {
+        double cond_size = 0;
+        double pred_size = 0;
+        clset_stats_sizes(xcsf, &cond_size, &pred_size);
+        return pred_size;
+    }
+    if (!stats->sizes_valid) {
+        clset_stats_sizes(xcsf, &stats->cond_size, &stats->pred_size);
+        stats->sizes_valid = true;
+    }
+    return stats->pred_size;
+}
+
+/**
+ * @brief Records a rule added to the population.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier added.
+ */
+void
+clset_stats_add(const struct XCSF *xcsf, const struct Cl *c)
+{
+    struct SetStats *stats = xcsf->stats;
+    if (stats == NULL) {
+        return;
+    }
+    if (stats->sizes_valid) {
+        stats->cond_size += cl_cond_size(xcsf, c);
+        stats->pred_size += cl_pred_size(xcsf, c);
+    }
+    if (stats->valid) {
+        clset_stats_push(stats, c);
+    }
+}
+
+/**
+ * @brief Records a rule removed from the population.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier removed.
+ */
+void
+clset_stats_remove(const struct XCSF *xcsf, const struct Cl *c)
+{
+    struct SetStats *stats = xcsf->stats;
+    if (stats == NULL) {
+        return;
+    }
+    if (stats->sizes_valid) {
+        stats->cond_size -= cl_cond_size(xcsf, c);
+        stats->pred_size -= cl_pred_size(xcsf, c);
+    }
+    if (stats->valid) {
+        if (c == stats->leader) {
+            stats->valid = false;
+            return;
+        }
+        for (int i = 0; i < stats->n_cand; ++i) {
+            if (stats->cand[i] == c) {
+                --(stats->n_cand);
+                stats->cand[i] = stats->cand[stats->n_cand];
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Discards the statistics so that they are recalculated when next used.
+ * @details Must be called whenever the population is replaced wholesale or
+ * its rules are modified other than by the usual update.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_stats_invalidate(const struct XCSF *xcsf)
+{
+    if (xcsf->stats != NULL) {
+        xcsf->stats->valid = false;
+        xcsf->stats->sizes_valid = false;
+    }
+}
+
+/**
+ * @brief Frees the population statistics.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+clset_stats_free(struct XCSF *xcsf)
+{
+    if (xcsf->stats != NULL) {
+        free(xcsf->stats->cand);
+        free(xcsf->stats);
+        xcsf->stats = NULL;
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_stats.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Running statistics of the population set.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+
+/**
+ * @brief Population statistics maintained as rules are added and removed.
+ * @details Holds the total condition and prediction sizes of the population
+ * and the rules that can become the generality leader, i.e., the most
+ * general rule with error below E0 used to calculate mfrac. After a full scan
+ * identifies the leader, only rules whose match fraction could overtake it
+ * within the next window of inputs are kept as candidates, together with
+ * any rules added since, so that each trial examines the candidates rather
+ * than the whole population. The statistics are recalculated from scratch
+ * when the window ends, when the leader no longer qualifies or leaves the
+ * population, and after the population is replaced or modified in place.
+ */
+struct SetStats {
+    const struct Cl **cand; //!< Rules that may overtake the leader
+    const struct Cl *leader; //!< Most general rule with error below E0
+    int n_cand; //!< Number of candidate rules
+    int capacity; //!< Number of candidate rules allocated
+    int age; //!< Age of the leader when the candidates were chosen
+    bool valid; //!< Whether the leader and candidates are valid
+    bool sizes_valid; //!< Whether the size totals are valid
+    double cond_size; //!< Total condition size of the population
+    double pred_size; //!< Total prediction size of the population
+};
+
+double
+clset_stats_mfrac(struct XCSF *xcsf);
+
+double
+clset_stats_cond_size(const struct XCSF *xcsf);
+
+double
+clset_stats_pred_size(const struct XCSF *xcsf);
+
+void
+clset_stats_add(const struct XCSF *xcsf, const struct Cl *c);
+
+void
+clset_stats_remove(const struct XCSF *xcsf, const struct Cl *c);
+
+void
+clset_stats_invalidate(const struct XCSF *xcsf);
+
+void
+clset_stats_free(struct XCSF *xcsf);
@@ -120,6 +120,40 @@ cond_dgp_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
     return false;
 }
 
+/**
+ * @brief Calculates whether a dynamical GP graph condition matches each of
+ * many inputs.
+ * @details Only valid when the graph is reset before each input. The graph
+ * is updated for all of the inputs together with graph_update_batch() and
+ * is left in the state reached by the last input, as if cond_dgp_match()
+ * had been called for each input in turn.
+ * @param [in] xcsf XCSF data structure.
+ * @param [in] c Classifier whose condition to match.
+ * @param [in] x The input states, one row after another.
+ * @param [in] n The number of input states.
+ * @param [out] match Bitset with bit r set if input r is matched.
+ */
+void
+cond_dgp_match_batch(const struct XCSF *xcsf, const struct Cl *c,
+                     const double *x, const int n, uint64_t *match)
+{
+    (void) xcsf;
+    const struct CondDGP *cond = c->cond;
+    const struct Graph *dgp = &cond->dgp;
+    if (n < 1) {
+        return;
+    }
+    double *states = malloc(sizeof(double) * n * dgp->n);
+    graph_update_batch(dgp, x, n, states);
+    for (int r = 0; r < n; ++r) {
+        if (states[r * dgp->n] > 0.5) {
+            match[r >> 6] |= (uint64_t) 1 << (r & 63);
+        }
+    }
+    memcpy(dgp->state, &states[(n - 1) * dgp->n], sizeof(double) * dgp->n);
+    free(states);
+}
+
 /**
  * @brief Mutates a dynamical GP graph condition with the self-adaptive rates.
  * @param [in] xcsf XCSF data structure.
@@ -23,10 +23,11 @@
 
 #include "cond_ellipsoid.h"
 #include "ea.h"
+#include "pool.h"
 #include "sam.h"
 #include "utils.h"
 
-#define N_MU (1) //!< Number of hyperellipsoid mutation rates
+#define N_MU (COND_ELLIPSOID_N_MU) //!< Number of mutation rates
 
 /**
  * @brief Self-adaptation method for mutating hyperellipsoids.
@@ -64,10 +65,11 @@ cond_ellipsoid_dist(const struct XCSF *xcsf, const struct Cl *c,
 void
 cond_ellipsoid_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct CondEllipsoid *new = malloc(sizeof(struct CondEllipsoid));
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
-    new->mu = malloc(sizeof(double) * N_MU);
+    struct CondEllipsoid *new =
+        pool_malloc(xcsf->pool, sizeof(struct CondEllipsoid));
+    new->center = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->spread = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     const double spread_max = fabs(xcsf->cond->max - xcsf->cond->min);
     for (int i = 0; i < xcsf->x_dim; ++i) {
         new->center[i] = rand_uniform(xcsf->cond->min, xcsf->cond->max);
@@ -85,12 +87,11 @@ cond_ellipsoid_init(const struct XCSF *xcsf, struct Cl *c)
 void
 cond_ellipsoid_free(const struct XCSF *xcsf, const struct Cl *c)
 {
-    (void) xcsf;
     const struct CondEllipsoid *cond = c->cond;
-    free(cond->center);
-    free(cond->spread);
-    free(cond->mu);
-    free(c->cond);
+    pool_free(xcsf->pool, cond->center);
+    pool_free(xcsf->pool, cond->spread);
+    pool_free(xcsf->pool, cond->mu);
+    pool_free(xcsf->pool, c->cond);
 }
 
 /**
@@ -103,11 +104,12 @@ void
 cond_ellipsoid_copy(const struct XCSF *xcsf, struct Cl *dest,
                     const struct Cl *src)
 {
-    struct CondEllipsoid *new = malloc(sizeof(struct CondEllipsoid));
+    struct CondEllipsoid *new =
+        pool_malloc(xcsf->pool, sizeof(struct CondEllipsoid));
     const struct CondEllipsoid *src_cond = src->cond;
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
-    new->mu = malloc(sizeof(double) * N_MU);
+    new->center = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->spread = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     memcpy(new->center, src_cond->center, sizeof(double) * xcsf->x_dim);
     memcpy(new->spread, src_cond->spread, sizeof(double) * xcsf->x_dim);
     memcpy(new->mu, src_cond->mu, sizeof(double) * N_MU);
@@ -320,10 +322,11 @@ size_t
 cond_ellipsoid_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
     size_t s = 0;
-    struct CondEllipsoid *new = malloc(sizeof(struct CondEllipsoid));
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
-    new->mu = malloc(sizeof(double) * N_MU);
+    struct CondEllipsoid *new =
+        pool_malloc(xcsf->pool, sizeof(struct CondEllipsoid));
+    new->center = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->spread = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     s += fread(new->center, sizeof(double), xcsf->x_dim, fp);
     s += fread(new->spread, sizeof(double), xcsf->x_dim, fp);
     s += fread(new->mu, sizeof(double), N_MU, fp);
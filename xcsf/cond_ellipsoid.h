@@ -26,6 +26,8 @@
 #include "condition.h"
 #include "xcsf.h"
 
+#define COND_ELLIPSOID_N_MU (1) //!< Number of hyperellipsoid mutation rates
+
 /**
  * @brief Hyperellipsoid condition data structure.
  */
@@ -112,14 +112,43 @@ cond_gp_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
 bool
 cond_gp_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
-    struct CondGP *cond = c->cond;
-    cond->gp.pos = 0;
+    const struct CondGP *cond = c->cond;
     if (tree_eval(&cond->gp, xcsf->cond->targs, x) > 0.5) {
         return true;
     }
     return false;
 }
 
+/**
+ * @brief Calculates whether a GP tree condition matches each of many inputs.
+ * @details The tree is evaluated a match word of inputs at a time with
+ * tree_eval_batch(), giving the same result as cond_gp_match() per input.
+ * @param [in] xcsf XCSF data structure.
+ * @param [in] c Classifier whose condition to match.
+ * @param [in] x The input states, one row after another.
+ * @param [in] n The number of input states.
+ * @param [out] match Bitset with bit r set if input r is matched.
+ */
+void
+cond_gp_match_batch(const struct XCSF *xcsf, const struct Cl *c,
+                    const double *x, const int n, uint64_t *match)
+{
+    const struct CondGP *cond = c->cond;
+    double out[64];
+    for (int row = 0; row < n; row += 64) {
+        const int len = (n - row < 64) ? n - row : 64;
+        tree_eval_batch(&cond->gp, xcsf->cond->targs, &x[row * xcsf->x_dim],
+                        len, out);
+        uint64_t word = 0;
+        for (int r = 0; r < len; ++r) {
+            if (out[r] > 0.5) {
+                word |= (uint64_t) 1 << r;
+            }
+        }
+        match[row >> 6] = word;
+    }
+}
+
 /**
  * @brief Mutates a tree-GP condition with the self-adaptive rate.
  * @param [in] xcsf XCSF data structure.
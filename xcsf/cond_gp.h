@@ -54,6 +54,10 @@ cond_gp_general(const struct XCSF *xcsf, const struct Cl *c1,
 bool
 cond_gp_match(const struct XCSF *xcsf, const struct Cl *c, const double *x);
 
+void
+cond_gp_match_batch(const struct XCSF *xcsf, const struct Cl *c,
+                    const double *x, const int n, uint64_t *match);
+
 bool
 cond_gp_mutate(const struct XCSF *xcsf, const struct Cl *c);
 
@@ -23,10 +23,11 @@
 
 #include "cond_rectangle.h"
 #include "ea.h"
+#include "pool.h"
 #include "sam.h"
 #include "utils.h"
 
-#define N_MU (1) //!< Number of hyperrectangle mutation rates
+#define N_MU (COND_RECTANGLE_N_MU) //!< Number of mutation rates
 
 /**
  * @brief Self-adaptation method for mutating hyperrectangles.
@@ -65,9 +66,10 @@ cond_rectangle_dist(const struct XCSF *xcsf, const struct Cl *c,
 void
 cond_rectangle_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct CondRectangle *new = malloc(sizeof(struct CondRectangle));
-    new->b1 = malloc(sizeof(double) * xcsf->x_dim);
-    new->b2 = malloc(sizeof(double) * xcsf->x_dim);
+    struct CondRectangle *new =
+        pool_malloc(xcsf->pool, sizeof(struct CondRectangle));
+    new->b1 = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->b2 = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
     const double spread_max = fabs(xcsf->cond->max - xcsf->cond->min);
     for (int i = 0; i < xcsf->x_dim; ++i) {
         new->b1[i] = rand_uniform(xcsf->cond->min, xcsf->cond->max);
@@ -79,7 +81,7 @@ cond_rectangle_init(const struct XCSF *xcsf, struct Cl *c)
             new->b2[i] = rand_uniform(xcsf->cond->spread_min, spread_max);
         }
     }
-    new->mu = malloc(sizeof(double) * N_MU);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     sam_init(new->mu, N_MU, MU_TYPE);
     c->cond = new;
 }
@@ -92,12 +94,11 @@ cond_rectangle_init(const struct XCSF *xcsf, struct Cl *c)
 void
 cond_rectangle_free(const struct XCSF *xcsf, const struct Cl *c)
 {
-    (void) xcsf;
     const struct CondRectangle *cond = c->cond;
-    free(cond->b1);
-    free(cond->b2);
-    free(cond->mu);
-    free(c->cond);
+    pool_free(xcsf->pool, cond->b1);
+    pool_free(xcsf->pool, cond->b2);
+    pool_free(xcsf->pool, cond->mu);
+    pool_free(xcsf->pool, c->cond);
 }
 
 /**
@@ -110,11 +111,12 @@ void
 cond_rectangle_copy(const struct XCSF *xcsf, struct Cl *dest,
                     const struct Cl *src)
 {
-    struct CondRectangle *new = malloc(sizeof(struct CondRectangle));
+    struct CondRectangle *new =
+        pool_malloc(xcsf->pool, sizeof(struct CondRectangle));
     const struct CondRectangle *src_cond = src->cond;
-    new->b1 = malloc(sizeof(double) * xcsf->x_dim);
-    new->b2 = malloc(sizeof(double) * xcsf->x_dim);
-    new->mu = malloc(sizeof(double) * N_MU);
+    new->b1 = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->b2 = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     memcpy(new->b1, src_cond->b1, sizeof(double) * xcsf->x_dim);
     memcpy(new->b2, src_cond->b2, sizeof(double) * xcsf->x_dim);
     memcpy(new->mu, src_cond->mu, sizeof(double) * N_MU);
@@ -355,10 +357,11 @@ size_t
 cond_rectangle_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
     size_t s = 0;
-    struct CondRectangle *new = malloc(sizeof(struct CondRectangle));
-    new->b1 = malloc(sizeof(double) * xcsf->x_dim);
-    new->b2 = malloc(sizeof(double) * xcsf->x_dim);
-    new->mu = malloc(sizeof(double) * N_MU);
+    struct CondRectangle *new =
+        pool_malloc(xcsf->pool, sizeof(struct CondRectangle));
+    new->b1 = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->b2 = pool_malloc(xcsf->pool, sizeof(double) * xcsf->x_dim);
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     s += fread(new->b1, sizeof(double), xcsf->x_dim, fp);
     s += fread(new->b2, sizeof(double), xcsf->x_dim, fp);
     s += fread(new->mu, sizeof(double), N_MU, fp);
@@ -26,6 +26,8 @@
 #include "condition.h"
 #include "xcsf.h"
 
+#define COND_RECTANGLE_N_MU (1) //!< Number of hyperrectangle mutation rates
+
 /**
  * @brief Hyperrectangle condition data structure.
  */
@@ -19,11 +19,12 @@
  * @copyright The Authors.
  * @date 2019--2022.
  * @brief Ternary condition functions.
- * @details Binarises inputs.
+ * @details Binarises inputs and stores the bitstring as packed 64-bit masks.
  */
 
 #include "cond_ternary.h"
 #include "ea.h"
+#include "pool.h"
 #include "sam.h"
 #include "utils.h"
 
@@ -35,6 +36,63 @@
  */
 static const int MU_TYPE[N_MU] = { SAM_LOG_NORMAL };
 
+/**
+ * @brief Returns the ternary symbol at a position in the bitstring.
+ * @param [in] cond The ternary condition.
+ * @param [in] i The position in the bitstring.
+ * @return The symbol '0', '1', or DONT_CARE.
+ */
+static char
+cond_ternary_get(const struct CondTernary *cond, const int i)
+{
+    const uint64_t bit = (uint64_t) 1 << (i & 63);
+    if (!(cond->care[i >> 6] & bit)) {
+        return DONT_CARE;
+    }
+    return (cond->value[i >> 6] & bit) ? '1' : '0';
+}
+
+/**
+ * @brief Sets the ternary symbol at a position in the bitstring.
+ * @param [in] cond The ternary condition.
+ * @param [in] i The position in the bitstring.
+ * @param [in] s The symbol '0', '1', or DONT_CARE.
+ */
+static void
+cond_ternary_set(const struct CondTernary *cond, const int i, const char s)
+{
+    const uint64_t bit = (uint64_t) 1 << (i & 63);
+    if (s == DONT_CARE) {
+        cond->care[i >> 6] &= ~bit;
+        cond->value[i >> 6] &= ~bit;
+    } else if (s == '1') {
+        cond->care[i >> 6] |= bit;
+        cond->value[i >> 6] |= bit;
+    } else {
+        cond->care[i >> 6] |= bit;
+        cond->value[i >> 6] &= ~bit;
+    }
+}
+
+/**
+ * @brief Allocates an empty ternary condition of a given length.
+ * @param [in] xcsf XCSF data structure.
+ * @param [in] length The length of the bitstring.
+ * @return The new ternary condition with all positions set to '0'.
+ */
+static struct CondTernary *
+cond_ternary_alloc(const struct XCSF *xcsf, const int length)
+{
+    struct CondTernary *new =
+        pool_malloc(xcsf->pool, sizeof(struct CondTernary));
+    new->length = length;
+    new->n_words = (length + 63) / 64;
+    new->care = pool_calloc(xcsf->pool, new->n_words, sizeof(uint64_t));
+    new->value = pool_calloc(xcsf->pool, new->n_words, sizeof(uint64_t));
+    new->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
+    return new;
+}
+
 /**
  * @brief Randomises a ternary condition.
  * @param [in] xcsf The XCSF data structure.
@@ -46,15 +104,69 @@ cond_ternary_rand(const struct XCSF *xcsf, const struct Cl *c)
     const struct CondTernary *cond = c->cond;
     for (int i = 0; i < cond->length; ++i) {
         if (rand_uniform(0, 1) < xcsf->cond->p_dontcare) {
-            cond->string[i] = DONT_CARE;
+            cond_ternary_set(cond, i, DONT_CARE);
         } else if (rand_uniform(0, 1) < 0.5) {
-            cond->string[i] = '0';
+            cond_ternary_set(cond, i, '0');
         } else {
-            cond->string[i] = '1';
+            cond_ternary_set(cond, i, '1');
+        }
+    }
+}
+
+/**
+ * @brief Binarises an input into a packed bitstring.
+ * @details Each input dimension is converted to the same bits as
+ * float_to_binary(), with the first bit of the first dimension stored in the
+ * least significant bit of the first word.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input state to binarise.
+ * @param [out] bits The packed bitstring (ceil(x_dim * bits / 64) words).
+ */
+void
+cond_ternary_binarise(const struct XCSF *xcsf, const double *x,
+                      uint64_t *bits)
+{
+    const int n_bits = xcsf->cond->bits;
+    const int n_words = (xcsf->x_dim * n_bits + 63) / 64;
+    memset(bits, 0, sizeof(uint64_t) * n_words);
+    for (int i = 0; i < xcsf->x_dim; ++i) {
+        const int start = i * n_bits;
+        if (x[i] >= 1) {
+            for (int j = 0; j < n_bits; ++j) {
+                const int k = start + j;
+                bits[k >> 6] |= (uint64_t) 1 << (k & 63);
+            }
+        } else if (x[i] > 0) {
+            int a = (int) (x[i] * pow(2, n_bits));
+            for (int j = n_bits - 1; j >= 0; --j) {
+                if (a % 2 == 1) {
+                    const int k = start + j;
+                    bits[k >> 6] |= (uint64_t) 1 << (k & 63);
+                }
+                a /= 2;
+            }
         }
     }
 }
 
+/**
+ * @brief Calculates whether a ternary condition matches a binarised input.
+ * @param [in] c The classifier whose condition to match.
+ * @param [in] bits The packed input from cond_ternary_binarise().
+ * @return Whether the condition matches the input.
+ */
+bool
+cond_ternary_match_bits(const struct Cl *c, const uint64_t *bits)
+{
+    const struct CondTernary *cond = c->cond;
+    for (int i = 0; i < cond->n_words; ++i) {
+        if ((bits[i] ^ cond->value[i]) & cond->care[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * @brief Creates and initialises a ternary bitstring condition.
  * @param [in] xcsf The XCSF data structure.
@@ -63,11 +175,8 @@ cond_ternary_rand(const struct XCSF *xcsf, const struct Cl *c)
 void
 cond_ternary_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct CondTernary *new = malloc(sizeof(struct CondTernary));
-    new->length = xcsf->x_dim * xcsf->cond->bits;
-    new->string = malloc(sizeof(char) * new->length);
-    new->tmp_input = malloc(sizeof(char) * xcsf->cond->bits);
-    new->mu = malloc(sizeof(double) * N_MU);
+    const int length = xcsf->x_dim * xcsf->cond->bits;
+    struct CondTernary *new = cond_ternary_alloc(xcsf, length);
     sam_init(new->mu, N_MU, MU_TYPE);
     c->cond = new;
     cond_ternary_rand(xcsf, c);
@@ -81,12 +190,11 @@ cond_ternary_init(const struct XCSF *xcsf, struct Cl *c)
 void
 cond_ternary_free(const struct XCSF *xcsf, const struct Cl *c)
 {
-    (void) xcsf;
     const struct CondTernary *cond = c->cond;
-    free(cond->string);
-    free(cond->tmp_input);
-    free(cond->mu);
-    free(c->cond);
+    pool_free(xcsf->pool, cond->care);
+    pool_free(xcsf->pool, cond->value);
+    pool_free(xcsf->pool, cond->mu);
+    pool_free(xcsf->pool, c->cond);
 }
 
 /**
@@ -99,13 +207,10 @@ void
 cond_ternary_copy(const struct XCSF *xcsf, struct Cl *dest,
                   const struct Cl *src)
 {
-    struct CondTernary *new = malloc(sizeof(struct CondTernary));
     const struct CondTernary *src_cond = src->cond;
-    new->length = src_cond->length;
-    new->string = malloc(sizeof(char) * src_cond->length);
-    new->tmp_input = malloc(sizeof(char) * xcsf->cond->bits);
-    new->mu = malloc(sizeof(double) * N_MU);
-    memcpy(new->string, src_cond->string, sizeof(char) * src_cond->length);
+    struct CondTernary *new = cond_ternary_alloc(xcsf, src_cond->length);
+    memcpy(new->care, src_cond->care, sizeof(uint64_t) * src_cond->n_words);
+    memcpy(new->value, src_cond->value, sizeof(uint64_t) * src_cond->n_words);
     memcpy(new->mu, src_cond->mu, sizeof(double) * N_MU);
     dest->cond = new;
 }
@@ -120,15 +225,15 @@ void
 cond_ternary_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     const struct CondTernary *cond = c->cond;
-    const int bits = xcsf->cond->bits;
-    for (int i = 0; i < xcsf->x_dim; ++i) {
-        float_to_binary(x[i], cond->tmp_input, bits);
-        for (int j = 0; j < bits; ++j) {
-            if (rand_uniform(0, 1) < xcsf->cond->p_dontcare) {
-                cond->string[i * bits + j] = DONT_CARE;
-            } else {
-                cond->string[i * bits + j] = cond->tmp_input[j];
-            }
+    uint64_t bits[cond->n_words];
+    cond_ternary_binarise(xcsf, x, bits);
+    for (int i = 0; i < cond->length; ++i) {
+        if (rand_uniform(0, 1) < xcsf->cond->p_dontcare) {
+            cond_ternary_set(cond, i, DONT_CARE);
+        } else if ((bits[i >> 6] >> (i & 63)) & 1) {
+            cond_ternary_set(cond, i, '1');
+        } else {
+            cond_ternary_set(cond, i, '0');
         }
     }
 }
@@ -152,6 +257,8 @@ cond_ternary_update(const struct XCSF *xcsf, const struct Cl *c,
 
 /**
  * @brief Calculates whether a ternary condition matches an input.
+ * @details When matching a whole population the input is binarised once and
+ * cond_ternary_match_bits() is used instead.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier whose condition to match.
  * @param [in] x The input state.
@@ -161,17 +268,9 @@ bool
 cond_ternary_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     const struct CondTernary *cond = c->cond;
-    const int bits = xcsf->cond->bits;
-    for (int i = 0; i < xcsf->x_dim; ++i) {
-        float_to_binary(x[i], cond->tmp_input, bits);
-        for (int j = 0; j < bits; ++j) {
-            const char s = cond->string[i * bits + j];
-            if (s != DONT_CARE && s != cond->tmp_input[j]) {
-                return false;
-            }
-        }
-    }
-    return true;
+    uint64_t bits[cond->n_words];
+    cond_ternary_binarise(xcsf, x, bits);
+    return cond_ternary_match_bits(c, bits);
 }
 
 /**
@@ -191,9 +290,15 @@ cond_ternary_crossover(const struct XCSF *xcsf, const struct Cl *c1,
     if (rand_uniform(0, 1) < xcsf->ea->p_crossover) {
         for (int i = 0; i < cond1->length; ++i) {
             if (rand_uniform(0, 1) < 0.5) {
-                const char tmp = cond1->string[i];
-                cond1->string[i] = cond2->string[i];
-                cond2->string[i] = tmp;
+                // swap the care and value bits
+                const int w = i >> 6;
+                const uint64_t bit = (uint64_t) 1 << (i & 63);
+                const uint64_t care = (cond1->care[w] ^ cond2->care[w]) & bit;
+                const uint64_t val = (cond1->value[w] ^ cond2->value[w]) & bit;
+                cond1->care[w] ^= care;
+                cond2->care[w] ^= care;
+                cond1->value[w] ^= val;
+                cond2->value[w] ^= val;
                 changed = true;
             }
         }
@@ -216,10 +321,11 @@ cond_ternary_mutate(const struct XCSF *xcsf, const struct Cl *c)
     bool changed = false;
     for (int i = 0; i < cond->length; ++i) {
         if (rand_uniform(0, 1) < cond->mu[0]) {
-            if (cond->string[i] == DONT_CARE) {
-                cond->string[i] = (rand_uniform(0, 1) < 0.5) ? '0' : '1';
+            if (cond_ternary_get(cond, i) == DONT_CARE) {
+                cond_ternary_set(cond, i,
+                                 (rand_uniform(0, 1) < 0.5) ? '0' : '1');
             } else {
-                cond->string[i] = DONT_CARE;
+                cond_ternary_set(cond, i, DONT_CARE);
             }
             changed = true;
         }
@@ -242,12 +348,13 @@ cond_ternary_general(const struct XCSF *xcsf, const struct Cl *c1,
     const struct CondTernary *cond1 = c1->cond;
     const struct CondTernary *cond2 = c2->cond;
     bool general = false;
-    for (int i = 0; i < cond1->length; ++i) {
-        if (cond1->string[i] != DONT_CARE &&
-            cond1->string[i] != cond2->string[i]) {
+    for (int i = 0; i < cond1->n_words; ++i) {
+        const uint64_t diff = cond1->value[i] ^ cond2->value[i];
+        // c1 cares about a position that c2 ignores or sets differently
+        if (cond1->care[i] & (~cond2->care[i] | diff)) {
             return false;
         }
-        if (cond1->string[i] != cond2->string[i]) {
+        if ((cond1->care[i] ^ cond2->care[i]) | diff) {
             general = true;
         }
     }
@@ -283,6 +390,7 @@ cond_ternary_size(const struct XCSF *xcsf, const struct Cl *c)
 
 /**
  * @brief Writes a ternary condition to a file.
+ * @details The bitstring is written as one symbol per position.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier whose condition is to be written.
  * @param [in] fp Pointer to the file to be written.
@@ -294,8 +402,12 @@ cond_ternary_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
     (void) xcsf;
     size_t s = 0;
     const struct CondTernary *cond = c->cond;
+    char string[cond->length];
+    for (int i = 0; i < cond->length; ++i) {
+        string[i] = cond_ternary_get(cond, i);
+    }
     s += fwrite(&cond->length, sizeof(int), 1, fp);
-    s += fwrite(cond->string, sizeof(char), cond->length, fp);
+    s += fwrite(string, sizeof(char), cond->length, fp);
     s += fwrite(cond->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -311,18 +423,19 @@ size_t
 cond_ternary_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
     size_t s = 0;
-    struct CondTernary *new = malloc(sizeof(struct CondTernary));
-    new->length = 0;
-    s += fread(&new->length, sizeof(int), 1, fp);
-    if (new->length < 1) {
+    int length = 0;
+    s += fread(&length, sizeof(int), 1, fp);
+    if (length < 1) {
         printf("cond_ternary_load(): read error\n");
-        new->length = 1;
         exit(EXIT_FAILURE);
     }
-    new->string = malloc(sizeof(char) * new->length);
-    s += fread(new->string, sizeof(char), new->length, fp);
-    new->tmp_input = malloc(sizeof(char) * xcsf->cond->bits);
-    new->mu = malloc(sizeof(double) * N_MU);
+    struct CondTernary *new = cond_ternary_alloc(xcsf, length);
+    char *string = malloc(sizeof(char) * length);
+    s += fread(string, sizeof(char), length, fp);
+    for (int i = 0; i < length; ++i) {
+        cond_ternary_set(new, i, string[i]);
+    }
+    free(string);
     s += fread(new->mu, sizeof(double), N_MU, fp);
     c->cond = new;
     return s;
@@ -342,7 +455,9 @@ cond_ternary_json_export(const struct XCSF *xcsf, const struct Cl *c)
     cJSON *json = cJSON_CreateObject();
     cJSON_AddStringToObject(json, "type", "ternary");
     char buff[cond->length + 1];
-    memcpy(buff, cond->string, sizeof(char) * cond->length);
+    for (int i = 0; i < cond->length; ++i) {
+        buff[i] = cond_ternary_get(cond, i);
+    }
     buff[cond->length] = '\0';
     cJSON_AddStringToObject(json, "string", buff);
     cJSON *mutation = cJSON_CreateDoubleArray(cond->mu, N_MU);
@@ -372,7 +487,11 @@ cond_ternary_json_import(const struct XCSF *xcsf, struct Cl *c,
                 printf("Import error: string terminated early\n");
                 exit(EXIT_FAILURE);
             }
-            cond->string[i] = bit;
+            if (bit != '0' && bit != '1' && bit != DONT_CARE) {
+                printf("Import error: invalid ternary symbol: %c\n", bit);
+                exit(EXIT_FAILURE);
+            }
+            cond_ternary_set(cond, i, bit);
         }
     }
     sam_json_import(cond->mu, N_MU, json);
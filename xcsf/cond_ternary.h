@@ -25,15 +25,19 @@
 
 #include "condition.h"
 #include "xcsf.h"
+#include <stdint.h>
 
 /**
  * @brief Ternary condition data structure.
+ * @details Position i of the bitstring is stored in bit (i % 64) of word
+ * (i / 64) of each mask; value bits are zero wherever care bits are zero.
  */
 struct CondTernary {
-    char *string; //!< Ternary bitstring
+    uint64_t *care; //!< Bits set where the bitstring is not don't care
+    uint64_t *value; //!< Bits set where the bitstring is '1'
     int length; //!< Length of the bitstring
+    int n_words; //!< Number of 64-bit words in each mask
     double *mu; //!< Mutation rates
-    char *tmp_input; //!< Temporary storage for float conversion
 };
 
 void
@@ -53,6 +57,9 @@ bool
 cond_ternary_general(const struct XCSF *xcsf, const struct Cl *c1,
                      const struct Cl *c2);
 
+bool
+cond_ternary_match_bits(const struct Cl *c, const uint64_t *bits);
+
 bool
 cond_ternary_match(const struct XCSF *xcsf, const struct Cl *c,
                    const double *x);
@@ -64,6 +71,10 @@ void
 cond_ternary_copy(const struct XCSF *xcsf, struct Cl *dest,
                   const struct Cl *src);
 
+void
+cond_ternary_binarise(const struct XCSF *xcsf, const double *x,
+                      uint64_t *bits);
+
 void
 cond_ternary_cover(const struct XCSF *xcsf, const struct Cl *c,
                    const double *x);
@@ -21,6 +21,7 @@
  * @brief Interface for classifier conditions.
  */
 
+#include "clset_soa.h"
 #include "cond_dgp.h"
 #include "cond_dummy.h"
 #include "cond_ellipsoid.h"
@@ -377,6 +378,7 @@ cond_param_free(struct XCSF *xcsf)
 void
 cond_param_set_eta(struct XCSF *xcsf, const double a)
 {
+    const double orig = xcsf->cond->eta;
     if (a < 0) {
         printf("Warning: tried to set COND ETA too small\n");
         xcsf->cond->eta = 0;
@@ -386,6 +388,10 @@ cond_param_set_eta(struct XCSF *xcsf, const double a)
     } else {
         xcsf->cond->eta = a;
     }
+    if (xcsf->cond->eta != orig) {
+        // centers may have moved while the SoA store was not in use
+        clset_soa_invalidate(xcsf);
+    }
 }
 
 void
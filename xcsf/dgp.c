@@ -28,8 +28,8 @@
 #define FUZZY_NOT (0) //!< Fuzzy NOT function
 #define FUZZY_CFMQVS_AND (1) //!< Fuzzy AND (CFMQVS) function
 #define FUZZY_CFMQVS_OR (2) //!< Fuzzy OR (CFMQVS) function
-#define NUM_FUNC (3) //!< Number of selectable node functions
 #define N_MU (3) //!< Number of DGP graph mutation rates
+#define DGP_LANES (16) //!< Number of samples updated together in a batch
 
 #define STRING_FUZZY_NOT ("Fuzzy NOT\0") //!< Fuzzy NOT
 #define STRING_FUZZY_CFMQVS_AND ("Fuzzy AND\0") //!< Fuzzy AND
@@ -72,7 +72,7 @@ graph_mutate_functions(struct Graph *dgp)
     for (int i = 0; i < dgp->n; ++i) {
         if (rand_uniform(0, 1) < dgp->mu[0]) {
             const int orig = dgp->function[i];
-            dgp->function[i] = rand_uniform_int(0, NUM_FUNC);
+            dgp->function[i] = rand_uniform_int(0, DGP_NUM_FUNC);
             if (orig != dgp->function[i]) {
                 mod = true;
             }
@@ -118,41 +118,6 @@ graph_mutate_cycles(struct Graph *dgp)
     return true;
 }
 
-/**
- * @brief Returns the result from applying a specified activation function.
- * @param [in] function The activation function to apply.
- * @param [in] inputs The input to the activation function.
- * @param [in] K The number of inputs to the activation function.
- * @return The result from applying the activation function.
- */
-static double
-node_activate(int function, const double *inputs, const int K)
-{
-    double state = 0;
-    switch (function) {
-        case FUZZY_NOT:
-            state = 1 - inputs[0];
-            break;
-        case FUZZY_CFMQVS_AND:
-            state = inputs[0];
-            for (int i = 1; i < K; ++i) {
-                state *= inputs[i];
-            }
-            break;
-        case FUZZY_CFMQVS_OR:
-            state = inputs[0];
-            for (int i = 1; i < K; ++i) {
-                state += inputs[i];
-            }
-            break;
-        default: // Invalid function
-            printf("Error updating node: Invalid function: %d\n", function);
-            exit(EXIT_FAILURE);
-    }
-    state = clamp(state, 0, 1);
-    return state;
-}
-
 /**
  * @brief Returns the name of a specified node function.
  * @param [in] function The node function.
@@ -195,26 +160,163 @@ function_int(const char *function)
 }
 
 /**
- * @brief Performs a synchronous update.
- * @param [in] dgp The DGP graph to update.
- * @param [in] inputs The inputs to the graph.
+ * @brief Allocates the arrays of a DGP graph.
+ * @param [in] dgp The DGP graph whose sizes have been set.
  */
 static void
-synchronous_update(const struct Graph *dgp, const double *inputs)
+graph_malloc(struct Graph *dgp)
 {
-    for (int i = 0; i < dgp->n; ++i) {
+    dgp->state = malloc(sizeof(double) * dgp->n);
+    dgp->initial_state = malloc(sizeof(double) * dgp->n);
+    dgp->tmp_state = malloc(sizeof(double) * dgp->n);
+    dgp->tmp_input = malloc(sizeof(double) * (dgp->n + dgp->klen));
+    dgp->function = malloc(sizeof(int) * dgp->n);
+    dgp->connectivity = malloc(sizeof(int) * dgp->klen);
+    dgp->order = malloc(sizeof(int) * dgp->n);
+    dgp->gather = malloc(sizeof(int) * dgp->klen);
+    dgp->used = malloc(sizeof(int) * dgp->klen);
+    dgp->mu = malloc(sizeof(double) * N_MU);
+}
+
+/**
+ * @brief Builds the tables used to update a DGP graph.
+ * @details Must be called whenever the node functions or connectivity are
+ * altered. Nodes are sorted by function so that each function is applied by
+ * a single loop, and their connections are stored input-major as positions
+ * within the node states followed by the external inputs actually used.
+ * @param [in] dgp The DGP graph.
+ */
+static void
+graph_compile(struct Graph *dgp)
+{
+    int j = 0;
+    for (int f = 0; f < DGP_NUM_FUNC; ++f) {
+        dgp->group[f] = j;
+        for (int i = 0; i < dgp->n; ++i) {
+            if (dgp->function[i] == f) {
+                dgp->order[j] = i;
+                ++j;
+            }
+        }
+    }
+    dgp->group[DGP_NUM_FUNC] = j;
+    if (j != dgp->n) {
+        printf("Error updating node: Invalid function\n");
+        exit(EXIT_FAILURE);
+    }
+    dgp->n_used = 0;
+    for (j = 0; j < dgp->n; ++j) {
         for (int k = 0; k < dgp->max_k; ++k) {
-            const int c = dgp->connectivity[i * dgp->max_k + k];
+            const int c = dgp->connectivity[dgp->order[j] * dgp->max_k + k];
+            int pos = c - dgp->n_inputs;
             if (c < dgp->n_inputs) { // external input
-                dgp->tmp_input[k] = inputs[c];
-            } else { // another node within the graph
-                dgp->tmp_input[k] = dgp->state[c - dgp->n_inputs];
+                int u = 0;
+                while (u < dgp->n_used && dgp->used[u] != c) {
+                    ++u;
+                }
+                if (u == dgp->n_used) {
+                    dgp->used[u] = c;
+                    ++(dgp->n_used);
+                }
+                pos = dgp->n + u;
+            }
+            dgp->gather[k * dgp->n + j] = pos;
+        }
+    }
+}
+
+/**
+ * @brief Performs a synchronous update.
+ * @param [in] dgp The DGP graph to update.
+ * @param [in,out] src The node states followed by the external inputs used.
+ * @return Whether any node changed state.
+ */
+static bool
+synchronous_update(const struct Graph *dgp, double *src)
+{
+    const int n = dgp->n;
+    const int *g = dgp->gather;
+    const int not_end = dgp->group[FUZZY_NOT + 1];
+    const int and_end = dgp->group[FUZZY_CFMQVS_AND + 1];
+    double *next = dgp->tmp_state;
+    for (int j = 0; j < not_end; ++j) {
+        next[j] = 1 - src[g[j]];
+    }
+    for (int j = not_end; j < n; ++j) {
+        next[j] = src[g[j]];
+    }
+    for (int k = 1; k < dgp->max_k; ++k) {
+        const int *gk = &g[k * n];
+        for (int j = not_end; j < and_end; ++j) {
+            next[j] *= src[gk[j]];
+        }
+        for (int j = and_end; j < n; ++j) {
+            next[j] += src[gk[j]];
+        }
+    }
+    bool changed = false;
+    for (int j = 0; j < n; ++j) {
+        const double state = clamp(next[j], 0, 1);
+        double *dest = &src[dgp->order[j]];
+        if (*dest != state) {
+            *dest = state;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief Performs a synchronous update of many samples.
+ * @param [in] dgp The DGP graph to update.
+ * @param [in,out] src Each sample's node states followed by external inputs,
+ * interleaved DGP_LANES samples at a time.
+ * @param [out] next Temporary storage for DGP_LANES states of each node.
+ * @param [in] lanes The number of samples.
+ * @return Whether any node changed state.
+ */
+static bool
+synchronous_update_lanes(const struct Graph *dgp, double *restrict src,
+                         double *restrict next, const int lanes)
+{
+    const int n = dgp->n;
+    const int *g = dgp->gather;
+    const int not_end = dgp->group[FUZZY_NOT + 1];
+    const int and_end = dgp->group[FUZZY_CFMQVS_AND + 1];
+    for (int j = 0; j < n; ++j) {
+        const double *in = &src[g[j] * DGP_LANES];
+        double *out = &next[j * DGP_LANES];
+        if (j < not_end) {
+            for (int l = 0; l < lanes; ++l) {
+                out[l] = 1 - in[l];
             }
+            continue;
+        }
+        memcpy(out, in, sizeof(double) * lanes);
+        for (int k = 1; k < dgp->max_k; ++k) {
+            in = &src[g[k * n + j] * DGP_LANES];
+            if (j < and_end) {
+                for (int l = 0; l < lanes; ++l) {
+                    out[l] *= in[l];
+                }
+            } else {
+                for (int l = 0; l < lanes; ++l) {
+                    out[l] += in[l];
+                }
+            }
+        }
+    }
+    bool changed = false;
+    for (int j = 0; j < n; ++j) {
+        const double *out = &next[j * DGP_LANES];
+        double *dest = &src[dgp->order[j] * DGP_LANES];
+        for (int l = 0; l < lanes; ++l) {
+            const double state = clamp(out[l], 0, 1);
+            changed |= (dest[l] != state);
+            dest[l] = state;
         }
-        dgp->tmp_state[i] =
-            node_activate(dgp->function[i], dgp->tmp_input, dgp->max_k);
     }
-    memcpy(dgp->state, dgp->tmp_state, sizeof(double) * dgp->n);
+    return changed;
 }
 
 /**
@@ -232,13 +334,7 @@ graph_init(struct Graph *dgp, const struct ArgsDGP *args)
     dgp->max_k = args->max_k;
     dgp->evolve_cycles = args->evolve_cycles;
     dgp->klen = dgp->n * dgp->max_k;
-    dgp->state = malloc(sizeof(double) * dgp->n);
-    dgp->initial_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_input = malloc(sizeof(double) * dgp->max_k);
-    dgp->function = malloc(sizeof(int) * dgp->n);
-    dgp->connectivity = malloc(sizeof(int) * dgp->klen);
-    dgp->mu = malloc(sizeof(double) * N_MU);
+    graph_malloc(dgp);
     sam_init(dgp->mu, N_MU, MU_TYPE);
 }
 
@@ -262,6 +358,11 @@ graph_copy(struct Graph *dest, const struct Graph *src)
     memcpy(dest->function, src->function, sizeof(int) * src->n);
     memcpy(dest->connectivity, src->connectivity, sizeof(int) * src->klen);
     memcpy(dest->mu, src->mu, sizeof(double) * N_MU);
+    memcpy(dest->order, src->order, sizeof(int) * src->n);
+    memcpy(dest->gather, src->gather, sizeof(int) * src->klen);
+    memcpy(dest->used, src->used, sizeof(int) * src->n_used);
+    memcpy(dest->group, src->group, sizeof(int) * (DGP_NUM_FUNC + 1));
+    dest->n_used = src->n_used;
 }
 
 /**
@@ -299,17 +400,19 @@ graph_rand(struct Graph *dgp)
         dgp->t = rand_uniform_int(1, dgp->max_t);
     }
     for (int i = 0; i < dgp->n; ++i) {
-        dgp->function[i] = rand_uniform_int(0, NUM_FUNC);
+        dgp->function[i] = rand_uniform_int(0, DGP_NUM_FUNC);
         dgp->initial_state[i] = rand_uniform(0, 1);
         dgp->state[i] = rand_uniform(0, 1);
     }
     for (int i = 0; i < dgp->klen; ++i) {
         dgp->connectivity[i] = random_connection(dgp->n, dgp->n_inputs);
     }
+    graph_compile(dgp);
 }
 
 /**
  * @brief Updates a DGP graph T cycles.
+ * @details Stops early once the states reach a fixed point.
  * @param [in] dgp The DGP graph to update.
  * @param [in] inputs The inputs to the graph.
  * @param [in] reset Whether to reset states to initial values.
@@ -320,9 +423,64 @@ graph_update(const struct Graph *dgp, const double *inputs, const bool reset)
     if (reset) {
         graph_reset(dgp);
     }
+    double *src = dgp->tmp_input;
+    memcpy(src, dgp->state, sizeof(double) * dgp->n);
+    for (int u = 0; u < dgp->n_used; ++u) {
+        src[dgp->n + u] = inputs[dgp->used[u]];
+    }
     for (int t = 0; t < dgp->t; ++t) {
-        synchronous_update(dgp, inputs);
+        if (!synchronous_update(dgp, src)) {
+            break;
+        }
     }
+    memcpy(dgp->state, src, sizeof(double) * dgp->n);
+}
+
+/**
+ * @brief Updates a DGP graph T cycles from its initial states for each of
+ * many samples.
+ * @details Samples are updated DGP_LANES at a time so that each node
+ * function is applied across the samples together. The graph's own states
+ * are left unchanged.
+ * @param [in] dgp The DGP graph to update.
+ * @param [in] inputs The inputs of each sample, one after another.
+ * @param [in] n_samples The number of samples.
+ * @param [out] states The resulting node states of each sample.
+ */
+void
+graph_update_batch(const struct Graph *dgp, const double *inputs,
+                   const int n_samples, double *states)
+{
+    const int n = dgp->n;
+    double *src = malloc(sizeof(double) * (n + dgp->n_used) * DGP_LANES);
+    double *next = malloc(sizeof(double) * n * DGP_LANES);
+    for (int s = 0; s < n_samples; s += DGP_LANES) {
+        const int lanes =
+            (n_samples - s < DGP_LANES) ? n_samples - s : DGP_LANES;
+        for (int i = 0; i < n; ++i) {
+            for (int l = 0; l < lanes; ++l) {
+                src[i * DGP_LANES + l] = dgp->initial_state[i];
+            }
+        }
+        for (int u = 0; u < dgp->n_used; ++u) {
+            double *dest = &src[(n + u) * DGP_LANES];
+            for (int l = 0; l < lanes; ++l) {
+                dest[l] = inputs[(s + l) * dgp->n_inputs + dgp->used[u]];
+            }
+        }
+        for (int t = 0; t < dgp->t; ++t) {
+            if (!synchronous_update_lanes(dgp, src, next, lanes)) {
+                break;
+            }
+        }
+        for (int l = 0; l < lanes; ++l) {
+            for (int i = 0; i < n; ++i) {
+                states[(s + l) * n + i] = src[i * DGP_LANES + l];
+            }
+        }
+    }
+    free(src);
+    free(next);
 }
 
 /**
@@ -491,13 +649,7 @@ graph_json_import(struct Graph *dgp, const struct ArgsDGP *args,
     dgp->max_k = args->max_k;
     dgp->evolve_cycles = args->evolve_cycles;
     dgp->klen = dgp->n * dgp->max_k;
-    dgp->state = malloc(sizeof(double) * dgp->n);
-    dgp->initial_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_input = malloc(sizeof(double) * dgp->max_k);
-    dgp->function = malloc(sizeof(int) * dgp->n);
-    dgp->connectivity = malloc(sizeof(int) * dgp->klen);
-    dgp->mu = malloc(sizeof(double) * N_MU);
+    graph_malloc(dgp);
     graph_rand(dgp);
     const cJSON *t = cJSON_GetObjectItem(json, "t");
     if (t != NULL) {
@@ -513,6 +665,7 @@ graph_json_import(struct Graph *dgp, const struct ArgsDGP *args,
     graph_json_import_functions(dgp, json);
     graph_json_import_connectivity(dgp, json);
     sam_json_import(dgp->mu, N_MU, json);
+    graph_compile(dgp);
 }
 
 /**
@@ -528,6 +681,9 @@ graph_free(const struct Graph *dgp)
     free(dgp->tmp_state);
     free(dgp->tmp_input);
     free(dgp->function);
+    free(dgp->order);
+    free(dgp->gather);
+    free(dgp->used);
     free(dgp->mu);
 }
 
@@ -550,6 +706,9 @@ graph_mutate(struct Graph *dgp)
     if (dgp->evolve_cycles && graph_mutate_cycles(dgp)) {
         mod = true;
     }
+    if (mod) {
+        graph_compile(dgp);
+    }
     return mod;
 }
 
@@ -599,18 +758,13 @@ graph_load(struct Graph *dgp, FILE *fp)
         dgp->klen = 1;
         exit(EXIT_FAILURE);
     }
-    dgp->state = malloc(sizeof(double) * dgp->n);
-    dgp->initial_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_input = malloc(sizeof(double) * dgp->max_k);
-    dgp->function = malloc(sizeof(int) * dgp->n);
-    dgp->connectivity = malloc(sizeof(int) * dgp->klen);
-    dgp->mu = malloc(sizeof(double) * N_MU);
+    graph_malloc(dgp);
     s += fread(dgp->state, sizeof(double), dgp->n, fp);
     s += fread(dgp->initial_state, sizeof(double), dgp->n, fp);
     s += fread(dgp->function, sizeof(int), dgp->n, fp);
     s += fread(dgp->connectivity, sizeof(int), dgp->klen, fp);
     s += fread(dgp->mu, sizeof(double), N_MU, fp);
+    graph_compile(dgp);
     return s;
 }
 
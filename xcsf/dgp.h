@@ -25,6 +25,8 @@
 
 #include "xcsf.h"
 
+#define DGP_NUM_FUNC (3) //!< Number of selectable node functions
+
 /**
  * @brief Parameters for initialising DGP graphs.
  */
@@ -43,10 +45,15 @@ struct Graph {
     bool evolve_cycles; //!< Whether to evolve the number of update cycles
     double *initial_state; //!< Initial node states
     double *state; //!< Current state of each node
-    double *tmp_input; //!< Temporary storage for updating the graph
+    double *tmp_input; //!< Node states followed by the inputs used
     double *tmp_state; //!< Temporary storage for synchronous update
     int *connectivity; //!< Connectivity map
     int *function; //!< Node activation functions
+    int *order; //!< Nodes sorted by activation function
+    int *gather; //!< Input-major positions in tmp_input of sorted node inputs
+    int *used; //!< External inputs read by the graph
+    int n_used; //!< Number of external inputs read by the graph
+    int group[DGP_NUM_FUNC + 1]; //!< Start of each function's sorted nodes
     int klen; //!< Length of connectivity map
     int max_k; //!< Maximum number of connections a node may have
     int max_t; //!< Maximum number of update cycles
@@ -96,6 +103,10 @@ graph_reset(const struct Graph *dgp);
 void
 graph_update(const struct Graph *dgp, const double *inputs, const bool reset);
 
+void
+graph_update_batch(const struct Graph *dgp, const double *inputs,
+                   const int n_samples, double *states);
+
 void
 graph_args_init(struct ArgsDGP *args);
 
@@ -24,6 +24,7 @@
 #include "ea.h"
 #include "cl.h"
 #include "clset.h"
+#include "clset_del.h"
 #include "utils.h"
 
 /**
@@ -71,30 +72,35 @@ ea_subsume(struct XCSF *xcsf, struct Cl *c, struct Cl *c1p, struct Cl *c2p,
     if (cl_subsumer(xcsf, c1p) && cl_general(xcsf, c1p, c)) {
         ++(c1p->num);
         ++(xcsf->pset.num);
+        clset_del_touch(xcsf, c1p);
         cl_free(xcsf, c);
     } else if (cl_subsumer(xcsf, c2p) && cl_general(xcsf, c2p, c)) {
         ++(c2p->num);
         ++(xcsf->pset.num);
+        clset_del_touch(xcsf, c2p);
         cl_free(xcsf, c);
     }
     // attempt to find a random subsumer from the set
     else {
-        struct Clist *candidates[set->size];
+        int candidates[set->size];
         int choices = 0;
-        for (struct Clist *iter = set->list; iter != NULL; iter = iter->next) {
-            if (cl_subsumer(xcsf, iter->cl) && cl_general(xcsf, iter->cl, c)) {
-                candidates[choices] = iter;
+        for (int i = 0; i < set->size; ++i) {
+            if (cl_subsumer(xcsf, set->cl[i]) &&
+                cl_general(xcsf, set->cl[i], c)) {
+                candidates[choices] = i;
                 ++choices;
             }
         }
         if (choices > 0) { // found
-            ++(candidates[rand_uniform_int(0, choices)]->cl->num);
+            struct Cl *s = set->cl[candidates[rand_uniform_int(0, choices)]];
+            ++(s->num);
             ++(xcsf->pset.num);
+            clset_del_touch(xcsf, s);
             cl_free(xcsf, c);
         }
         // if no subsumers are found the offspring is added to the population
         else {
-            clset_add(&xcsf->pset, c);
+            clset_pset_add(xcsf, c);
         }
     }
 }
@@ -116,11 +122,12 @@ ea_add(struct XCSF *xcsf, const struct Set *set, struct Cl *c1p, struct Cl *c2p,
     if (!cmod && !mmod) {
         ++(c1p->num);
         ++(xcsf->pset.num);
+        clset_del_touch(xcsf, c1p);
         cl_free(xcsf, c1);
     } else if (xcsf->ea->subsumption) {
         ea_subsume(xcsf, c1, c1p, c2p, set);
     } else {
-        clset_add(&xcsf->pset, c1);
+        clset_pset_add(xcsf, c1);
     }
 }
 
@@ -137,13 +144,13 @@ ea_select_rw(const struct XCSF *xcsf, const struct Set *set,
 {
     (void) xcsf;
     const double p = rand_uniform(0, fit_sum);
-    const struct Clist *iter = set->list;
-    double sum = iter->cl->fit;
-    while (p > sum) {
-        iter = iter->next;
-        sum += iter->cl->fit;
+    int i = 0;
+    double sum = set->cl[i]->fit;
+    while (p > sum && i < set->size - 1) {
+        ++i;
+        sum += set->cl[i]->fit;
     }
-    return iter->cl;
+    return set->cl[i];
 }
 
 /**
@@ -157,13 +164,11 @@ ea_select_tournament(const struct XCSF *xcsf, const struct Set *set)
 {
     struct Cl *winner = NULL;
     while (winner == NULL) {
-        const struct Clist *iter = set->list;
-        while (iter != NULL) {
+        for (int i = 0; i < set->size; ++i) {
             if ((rand_uniform(0, 1) < xcsf->ea->select_size) &&
-                (winner == NULL || iter->cl->fit > winner->fit)) {
-                winner = iter->cl;
+                (winner == NULL || set->cl[i]->fit > winner->fit)) {
+                winner = set->cl[i];
             }
-            iter = iter->next;
         }
     }
     return winner;
@@ -190,8 +195,41 @@ ea_select(const struct XCSF *xcsf, const struct Set *set, struct Cl **c1p,
     }
 }
 
+/**
+ * @brief Creates a pair of offspring by copying and varying two parents.
+ * @details Only reads the parents and may therefore be run concurrently for
+ * several pairs, each drawing from its own thread's random number stream.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c1p First parent classifier.
+ * @param [in] c2p Second parent classifier.
+ * @param [out] c1 The first offspring classifier created.
+ * @param [out] c2 The second offspring classifier created.
+ * @param [out] cmod Whether crossover modified the offspring.
+ * @param [out] m1mod Whether mutation modified the first offspring.
+ * @param [out] m2mod Whether mutation modified the second offspring.
+ */
+static void
+ea_vary(const struct XCSF *xcsf, const struct Cl *c1p, const struct Cl *c2p,
+        struct Cl **c1, struct Cl **c2, bool *cmod, bool *m1mod, bool *m2mod)
+{
+    // create copies of parents
+    *c1 = cl_alloc(xcsf);
+    *c2 = cl_alloc(xcsf);
+    cl_init(xcsf, *c1, c1p->size, c1p->time);
+    cl_init(xcsf, *c2, c2p->size, c2p->time);
+    cl_copy(xcsf, *c1, c1p);
+    cl_copy(xcsf, *c2, c2p);
+    // apply evolutionary operators to offspring
+    *cmod = cl_crossover(xcsf, *c1, *c2);
+    *m1mod = cl_mutate(xcsf, *c1);
+    *m2mod = cl_mutate(xcsf, *c2);
+}
+
 /**
  * @brief Executes the evolutionary algorithm (EA).
+ * @details Offspring pairs are first created and varied independently, in
+ * parallel when PARALLEL_EA is defined, and then initialised and inserted
+ * into the population serially in the order they were created.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] set The set in which to run the EA.
  */
@@ -208,23 +246,25 @@ ea(struct XCSF *xcsf, const struct Set *set)
     struct Cl *c2p = NULL;
     ea_select(xcsf, set, &c1p, &c2p);
     // create offspring
-    for (int i = 0; i * 2 < xcsf->ea->lambda; ++i) {
-        // create copies of parents
-        struct Cl *c1 = malloc(sizeof(struct Cl));
-        struct Cl *c2 = malloc(sizeof(struct Cl));
-        cl_init(xcsf, c1, c1p->size, c1p->time);
-        cl_init(xcsf, c2, c2p->size, c2p->time);
-        cl_copy(xcsf, c1, c1p);
-        cl_copy(xcsf, c2, c2p);
-        // apply evolutionary operators to offspring
-        const bool cmod = cl_crossover(xcsf, c1, c2);
-        const bool m1mod = cl_mutate(xcsf, c1);
-        const bool m2mod = cl_mutate(xcsf, c2);
+    const int n_pairs = (xcsf->ea->lambda + 1) / 2;
+    struct Cl *c1[n_pairs];
+    struct Cl *c2[n_pairs];
+    bool cmod[n_pairs];
+    bool m1mod[n_pairs];
+    bool m2mod[n_pairs];
+#ifdef PARALLEL_EA
+    #pragma omp parallel for schedule(static) if (n_pairs > 1)
+#endif
+    for (int i = 0; i < n_pairs; ++i) {
+        ea_vary(xcsf, c1p, c2p, &c1[i], &c2[i], &cmod[i], &m1mod[i],
+                &m2mod[i]);
+    }
+    for (int i = 0; i < n_pairs; ++i) {
         // initialise parameters
-        ea_init_offspring(xcsf, c1p, c2p, c1, c2, cmod);
+        ea_init_offspring(xcsf, c1p, c2p, c1[i], c2[i], cmod[i]);
         // add to population
-        ea_add(xcsf, set, c1p, c2p, c1, cmod, m1mod);
-        ea_add(xcsf, set, c2p, c1p, c2, cmod, m2mod);
+        ea_add(xcsf, set, c1p, c2p, c1[i], cmod[i], m1mod[i]);
+        ea_add(xcsf, set, c2p, c1p, c2[i], cmod[i], m2mod[i]);
     }
     clset_pset_enforce_limit(xcsf);
 }
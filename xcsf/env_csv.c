@@ -23,84 +23,370 @@
 
 #include "env_csv.h"
 #include "param.h"
+#include "utils.h"
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+#ifdef PARALLEL
+    #include <omp.h>
+#endif
 
-#define MAX_ROWS (100000) //!< Maximum number of instances
-#define MAX_COLS (200) //!< Maximum line length
 #define MAX_NAME (200) //!< Maximum file name length
-#define DELIM (",") //!< File delimiter
+#define DELIM (',') //!< File delimiter
+#define CSV_CHUNK (1 << 20) //!< Bytes of text parsed by each task
+#define CSV_SIDECAR (2) //!< Binary sidecar layout version
+
+static const char CSV_MAGIC[8] = "XCSFCSV"; //!< Binary sidecar signature
+static const uint32_t CSV_ENDIAN = 0x01020304; //!< Byte order mark
 
 /**
- * @brief Returns the number of samples in a csv file.
- * @param [in] fin The csv file.
- * @return The number of samples.
+ * @brief Header of the binary sidecar holding a parsed csv file.
+ * @details The header is followed by the samples as row-major doubles. The
+ * size and modification time of the csv file that was parsed are recorded so
+ * that the sidecar is only used while the csv file is unchanged.
  */
-static int
-env_csv_samples(FILE *fin)
+struct CsvSidecar {
+    char magic[8]; //!< File signature
+    uint32_t version; //!< Sidecar layout version
+    uint32_t endian; //!< Byte order mark
+    int32_t n_samples; //!< Number of samples
+    int32_t n_dim; //!< Number of dimensions
+    int64_t csv_size; //!< Size of the csv file in bytes
+    int64_t csv_sec; //!< Modification time of the csv file in seconds
+    int64_t csv_nsec; //!< Nanoseconds part of the modification time
+};
+
+/**
+ * @brief Returns whether a character is a space or tab.
+ * @param [in] c The character.
+ * @return Whether the character is blank.
+ */
+static bool
+env_csv_space(const char c)
 {
-    int n_samples = 0;
-    char line[MAX_COLS];
-    while (fgets(line, MAX_COLS, fin) != NULL) {
-        ++n_samples;
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * @brief Returns whether a line contains only whitespace.
+ * @param [in] s Start of the line.
+ * @param [in] end End of the line.
+ * @return Whether the line is blank.
+ */
+static bool
+env_csv_blank(const char *s, const char *end)
+{
+    for (; s < end; ++s) {
+        if (!env_csv_space(*s) && *s != '\r' && *s != '\n') {
+            return false;
+        }
     }
-    return n_samples;
+    return true;
+}
+
+/**
+ * @brief Returns the end of the line starting at a position.
+ * @param [in] s Start of the line.
+ * @param [in] end End of the text.
+ * @return Pointer to the newline, or the end of the text.
+ */
+static const char *
+env_csv_eol(const char *s, const char *end)
+{
+    const char *eol = memchr(s, '\n', (size_t) (end - s));
+    return (eol != NULL) ? eol : end;
 }
 
 /**
  * @brief Returns the number of dimensions in a csv file.
- * @param [in] fin The csv file.
+ * @details Counts the non-empty fields of the first non-blank line.
+ * @param [in] s Start of the text.
+ * @param [in] end End of the text.
  * @return The number of dimensions.
  */
 static int
-env_csv_dim(FILE *fin)
+env_csv_dim(const char *s, const char *end)
 {
-    rewind(fin);
-    int n_dim = 0;
-    char line[MAX_COLS];
-    char *saveptr = NULL;
-    if (fgets(line, MAX_COLS, fin) != NULL) {
-        const char *ptok = strtok_r(line, DELIM, &saveptr);
-        while (ptok != NULL) {
-            if (strnlen(ptok, MAX_COLS) > 0) {
-                ++n_dim;
+    while (s < end) {
+        const char *eol = env_csv_eol(s, end);
+        if (!env_csv_blank(s, eol)) {
+            int n_dim = 0;
+            bool field = false;
+            for (; s < eol; ++s) {
+                if (*s == DELIM) {
+                    field = false;
+                } else if (!field && !env_csv_space(*s) && *s != '\r') {
+                    field = true;
+                    ++n_dim;
+                }
             }
-            ptok = strtok_r(NULL, DELIM, &saveptr);
+            return n_dim;
         }
+        s = eol + 1;
     }
-    return n_dim;
+    return 0;
 }
 
 /**
- * @brief Reads the data from a csv file.
- * @param [in] fin The csv file.
- * @param [out] data The read data.
- * @param [in] n_samples The number of samples.
+ * @brief Returns the number of samples in a block of complete lines.
+ * @param [in] s Start of the block.
+ * @param [in] end End of the block.
+ * @return The number of non-blank lines.
+ */
+static int
+env_csv_samples(const char *s, const char *end)
+{
+    int n_samples = 0;
+    while (s < end) {
+        const char *eol = env_csv_eol(s, end);
+        if (!env_csv_blank(s, eol)) {
+            ++n_samples;
+        }
+        s = eol + 1;
+    }
+    return n_samples;
+}
+
+/**
+ * @brief Parses the samples in a block of complete lines.
+ * @details Each field is read with strtod() directly from the text; the
+ * caller guarantees that the block ends with a newline or a terminating
+ * null character so that no number runs past the end.
+ * @param [in] s Start of the block.
+ * @param [in] end End of the block.
+ * @param [out] data The parsed samples.
  * @param [in] n_dim The number of dimensions.
+ * @param [in] filename The name of the csv file, used in error messages.
  */
 static void
-env_csv_read_data(FILE *fin, double **data, const int n_samples,
-                  const int n_dim)
+env_csv_parse(const char *s, const char *end, double *data, const int n_dim,
+              const char *filename)
 {
-    rewind(fin);
-    *data = malloc(sizeof(double) * n_dim * n_samples);
-    char line[MAX_COLS];
-    const char *str = NULL;
-    char *saveptr = NULL;
     char *endptr = NULL;
-    int i = 0;
-    while (fgets(line, MAX_COLS, fin) != NULL && i < n_samples) {
-        str = strtok_r(line, DELIM, &saveptr);
-        (*data)[i * n_dim] = strtod(str, &endptr);
-        for (int j = 1; j < n_dim; ++j) {
-            str = strtok_r(NULL, DELIM, &saveptr);
-            (*data)[i * n_dim + j] = strtod(str, &endptr);
+    while (s < end) {
+        const char *eol = env_csv_eol(s, end);
+        if (!env_csv_blank(s, eol)) {
+            for (int j = 0; j < n_dim; ++j) {
+                while (s < eol && (env_csv_space(*s) || *s == DELIM)) {
+                    ++s;
+                }
+                if (s == eol || *s == '\r') {
+                    printf("Error reading file: %s. Missing values\n",
+                           filename);
+                    exit(EXIT_FAILURE);
+                }
+                *data++ = strtod(s, &endptr);
+                if (endptr == s) {
+                    // non-numeric fields read as zero
+                    while (s < eol && *s != DELIM) {
+                        ++s;
+                    }
+                } else {
+                    s = endptr;
+                }
+            }
         }
-        ++i;
+        s = eol + 1;
+    }
+}
+
+/**
+ * @brief Parses the text of a csv file.
+ * @details The text is split into chunks of whole lines that are counted
+ * and then parsed in parallel straight into their rows of the data.
+ * @param [in] text The contents of the csv file.
+ * @param [in] len The length of the text.
+ * @param [in] filename The name of the csv file, used in error messages.
+ * @param [out] data The parsed samples.
+ * @param [out] n_samples The number of samples.
+ * @param [out] n_dim The number of dimensions.
+ */
+static void
+env_csv_parse_text(const char *text, const size_t len, const char *filename,
+                   double **data, int *n_samples, int *n_dim)
+{
+    const char *end = text + len;
+    *n_dim = env_csv_dim(text, end);
+    // a final line without a newline is parsed from a terminated copy
+    const char *body_end = end;
+    while (body_end > text && body_end[-1] != '\n') {
+        --body_end;
+    }
+    const size_t tail_len = (size_t) (end - body_end);
+    char *tail = malloc(tail_len + 1);
+    if (tail_len > 0) {
+        memcpy(tail, body_end, tail_len);
+    }
+    tail[tail_len] = '\0';
+    // split into chunks of whole lines
+    const size_t body = (size_t) (body_end - text);
+    const int n_chunks = (int) (body / CSV_CHUNK) + 1;
+    const char **start = malloc(sizeof(const char *) * (n_chunks + 1));
+    int *offset = malloc(sizeof(int) * (n_chunks + 1));
+    start[0] = text;
+    for (int k = 1; k < n_chunks; ++k) {
+        const char *s = text + (size_t) k * CSV_CHUNK;
+        s = (s < start[k - 1]) ? start[k - 1] : s;
+        s = (s < body_end) ? env_csv_eol(s, body_end) + 1 : body_end;
+        start[k] = (s < body_end) ? s : body_end;
+    }
+    start[n_chunks] = body_end;
+#ifdef PARALLEL
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int k = 0; k < n_chunks; ++k) {
+        offset[k + 1] = env_csv_samples(start[k], start[k + 1]);
+    }
+    offset[0] = 0;
+    for (int k = 0; k < n_chunks; ++k) {
+        offset[k + 1] += offset[k];
+    }
+    const int n_tail = env_csv_samples(tail, tail + tail_len);
+    *n_samples = offset[n_chunks] + n_tail;
+    if (*n_samples < 1 || *n_dim < 1) {
+        printf("Error reading file: %s. No samples found\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    *data = malloc(sizeof(double) * *n_dim * *n_samples);
+    const int dim = *n_dim;
+#ifdef PARALLEL
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int k = 0; k < n_chunks; ++k) {
+        env_csv_parse(start[k], start[k + 1], *data + (size_t) offset[k] * dim,
+                      dim, filename);
+    }
+    env_csv_parse(tail, tail + tail_len,
+                  *data + (size_t) offset[n_chunks] * dim, dim, filename);
+    free(tail);
+    free(start);
+    free(offset);
+}
+
+/**
+ * @brief Records the size and modification time of a csv file.
+ * @param [in] filename The name of the csv file.
+ * @param [out] h The sidecar header in which to record the file identity.
+ * @return Whether the file exists.
+ */
+static bool
+env_csv_stat(const char *filename, struct CsvSidecar *h)
+{
+    struct stat st;
+    if (stat(filename, &st) != 0) {
+        return false;
+    }
+    h->csv_size = (int64_t) st.st_size;
+    h->csv_sec = (int64_t) st.st_mtime;
+#if defined(_WIN32)
+    h->csv_nsec = 0;
+#elif defined(__APPLE__)
+    h->csv_nsec = (int64_t) st.st_mtimespec.tv_nsec;
+#else
+    h->csv_nsec = (int64_t) st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+/**
+ * @brief Reads the data from a binary sidecar if it is up to date.
+ * @details The sidecar is only used if the csv file has the same size and
+ * modification time as when the sidecar was written, or no longer exists.
+ * @param [in] csv The identity of the csv file, or NULL if it does not exist.
+ * @param [in] sidecar The name of the binary sidecar.
+ * @param [out] data The read data.
+ * @param [out] n_samples The number of samples.
+ * @param [out] n_dim The number of dimensions.
+ * @return Whether the data was read from the sidecar.
+ */
+static bool
+env_csv_read_sidecar(const struct CsvSidecar *csv, const char *sidecar,
+                     double **data, int *n_samples, int *n_dim)
+{
+    FILE *fin = fopen(sidecar, "rb");
+    if (fin == 0) {
+        return false;
+    }
+    struct CsvSidecar h;
+    if (fread(&h, sizeof(struct CsvSidecar), 1, fin) != 1 ||
+        memcmp(h.magic, CSV_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != CSV_SIDECAR || h.endian != CSV_ENDIAN ||
+        h.n_samples < 1 || h.n_dim < 1 ||
+        (csv != NULL &&
+         (h.csv_size != csv->csv_size || h.csv_sec != csv->csv_sec ||
+          h.csv_nsec != csv->csv_nsec))) {
+        fclose(fin);
+        return false;
+    }
+    const size_t n = (size_t) h.n_samples * h.n_dim;
+    *data = malloc(sizeof(double) * n);
+    if (fread(*data, sizeof(double), n, fin) != n) {
+        free(*data);
+        fclose(fin);
+        return false;
+    }
+    fclose(fin);
+    *n_samples = h.n_samples;
+    *n_dim = h.n_dim;
+    return true;
+}
+
+/**
+ * @brief Writes parsed data to a binary sidecar for faster loading.
+ * @details The sidecar is written to a temporary file that is then renamed,
+ * so that a concurrent reader never sees a partially written sidecar. Nothing
+ * is written if the sidecar cannot be created.
+ * @param [in] csv The identity of the csv file that was parsed.
+ * @param [in] sidecar The name of the binary sidecar.
+ * @param [in] data The parsed data.
+ * @param [in] n_samples The number of samples.
+ * @param [in] n_dim The number of dimensions.
+ */
+static void
+env_csv_write_sidecar(const struct CsvSidecar *csv, const char *sidecar,
+                      const double *data, const int n_samples, const int n_dim)
+{
+    char tmp[MAX_NAME + 32];
+#ifdef _WIN32
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", sidecar, _getpid());
+#else
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", sidecar, (int) getpid());
+#endif
+    FILE *fout = fopen(tmp, "wb");
+    if (fout == 0) {
+        return;
+    }
+    struct CsvSidecar h = *csv;
+    memcpy(h.magic, CSV_MAGIC, sizeof(h.magic));
+    h.version = CSV_SIDECAR;
+    h.endian = CSV_ENDIAN;
+    h.n_samples = n_samples;
+    h.n_dim = n_dim;
+    const size_t n = (size_t) n_samples * n_dim;
+    bool ok = fwrite(&h, sizeof(struct CsvSidecar), 1, fout) == 1 &&
+        fwrite(data, sizeof(double), n, fout) == n;
+    ok = (fclose(fout) == 0) && ok;
+#ifdef _WIN32
+    if (ok) {
+        remove(sidecar); // rename does not replace an existing file
+    }
+#endif
+    if (!ok || rename(tmp, sidecar) != 0) {
+        remove(tmp);
     }
 }
 
 /**
  * @brief Parses a specified csv file.
- * @details Provided a file name will set the data, n_samples, and n_dim.
+ * @details Provided a file name will set the data, n_samples, and n_dim. The
+ * parsed samples are cached in a binary sidecar named after the file with a
+ * .bin suffix, which is loaded instead while the csv file is unchanged.
  * @param [in] filename The name of the csv file to read.
  * @param [out] data A data structure to store the data.
  * @param [out] n_samples The number of samples in the dataset.
@@ -109,20 +395,20 @@ env_csv_read_data(FILE *fin, double **data, const int n_samples,
 static void
 env_csv_read(const char *filename, double **data, int *n_samples, int *n_dim)
 {
-    FILE *fin = fopen(filename, "rt");
-    if (fin == 0) {
-        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
-        exit(EXIT_FAILURE);
-    }
-    *n_samples = env_csv_samples(fin);
-    *n_dim = env_csv_dim(fin);
-    if (*n_samples > 0 && *n_dim > 0) {
-        env_csv_read_data(fin, data, *n_samples, *n_dim);
-        fclose(fin);
-    } else {
-        printf("Error reading file: %s. No samples found\n", filename);
-        fclose(fin);
-        exit(EXIT_FAILURE);
+    char sidecar[MAX_NAME + 4];
+    snprintf(sidecar, sizeof(sidecar), "%s.bin", filename);
+    // the csv file is examined before parsing so that a concurrent change is
+    // detected on the next load rather than recorded as current
+    struct CsvSidecar csv;
+    memset(&csv, 0, sizeof(struct CsvSidecar));
+    const bool exists = env_csv_stat(filename, &csv);
+    if (!env_csv_read_sidecar(exists ? &csv : NULL, sidecar, data, n_samples,
+                              n_dim)) {
+        size_t len = 0;
+        char *text = utils_file_map(filename, &len);
+        env_csv_parse_text(text, len, filename, data, n_samples, n_dim);
+        utils_file_unmap(text, len);
+        env_csv_write_sidecar(&csv, sidecar, *data, *n_samples, *n_dim);
     }
     printf("Loaded: %s: samples=%d, dim=%d\n", filename, *n_samples, *n_dim);
 }
@@ -40,6 +40,7 @@
 #define N_MU (1) //!< Number of tree-GP mutation rates
 #define RET_MIN (-1000) //!< Minimum tree return value
 #define RET_MAX (1000) //!< Maximum tree return value
+#define GP_LANES (16) //!< Number of input rows evaluated together in a batch
 
 /**
  * @brief Self-adaptation method for mutating GP trees.
@@ -109,6 +110,8 @@ tree_rand(struct GPTree *gp, const struct ArgsGPTree *args)
     gp->tree = realloc(gp->tree, sizeof(int) * gp->len);
     gp->mu = malloc(sizeof(double) * N_MU);
     sam_init(gp->mu, N_MU, MU_TYPE);
+    gp->code = NULL;
+    tree_compile(gp);
 }
 
 /**
@@ -120,28 +123,65 @@ tree_free(const struct GPTree *gp)
 {
     free(gp->tree);
     free(gp->mu);
+    free(gp->code);
 }
 
 /**
- * @brief Evaluates a GP tree.
- * @param [in] gp The GP tree to evaluate.
- * @param [in] args Tree GP parameters.
- * @param [in] x The input state.
- * @return The result from evaluating the GP tree.
+ * @brief Writes a GP tree in postfix order.
+ * @param [in] tree The flattened tree in prefix order.
+ * @param [in] pos The position from which to traverse (start at 0).
+ * @param [out] code The tree in postfix order.
+ * @param [in,out] n The number of nodes written.
+ * @return The position after traversal.
  */
-double
-tree_eval(struct GPTree *gp, const struct ArgsGPTree *args, const double *x)
+static int
+tree_postfix(const int *tree, int pos, int *code, int *n)
 {
-    const int node = gp->tree[gp->pos];
-    ++(gp->pos);
-    if (node >= GP_NUM_FUNC + args->n_constants) {
-        return x[node - GP_NUM_FUNC - args->n_constants];
+    const int node = tree[pos];
+    ++pos;
+    if (node < GP_NUM_FUNC) {
+        pos = tree_postfix(tree, tree_postfix(tree, pos, code, n), code, n);
     }
-    if (node >= GP_NUM_FUNC) {
-        return args->constants[node - GP_NUM_FUNC];
+    code[*n] = node;
+    ++(*n);
+    return pos;
+}
+
+/**
+ * @brief Compiles a GP tree into the postfix code used for evaluation.
+ * @details Must be called whenever the tree is altered. Each terminal pushes
+ * one value onto the evaluation stack and each function pops two and pushes
+ * their result.
+ * @param [in] gp The GP tree to compile.
+ */
+void
+tree_compile(struct GPTree *gp)
+{
+    gp->code = realloc(gp->code, sizeof(int) * gp->len);
+    int n = 0;
+    tree_postfix(gp->tree, 0, gp->code, &n);
+    gp->depth = 0;
+    int sp = 0;
+    for (int i = 0; i < gp->len; ++i) {
+        sp += (gp->code[i] >= GP_NUM_FUNC) ? 1 : -1;
+        if (sp > gp->depth) {
+            gp->depth = sp;
+        }
     }
-    const double a = clamp(tree_eval(gp, args, x), RET_MIN, RET_MAX);
-    const double b = clamp(tree_eval(gp, args, x), RET_MIN, RET_MAX);
+}
+
+/**
+ * @brief Applies a node function to two clamped arguments.
+ * @param [in] node Integer representing a function.
+ * @param [in] a The first argument.
+ * @param [in] b The second argument.
+ * @return The result of the function.
+ */
+static inline double
+tree_function(const int node, double a, double b)
+{
+    a = clamp(a, RET_MIN, RET_MAX);
+    b = clamp(b, RET_MIN, RET_MAX);
     switch (node) {
         case ADD:
             return a + b;
@@ -157,6 +197,123 @@ tree_eval(struct GPTree *gp, const struct ArgsGPTree *args, const double *x)
     }
 }
 
+/**
+ * @brief Evaluates a GP tree.
+ * @param [in] gp The GP tree to evaluate.
+ * @param [in] args Tree GP parameters.
+ * @param [in] x The input state.
+ * @return The result from evaluating the GP tree.
+ */
+double
+tree_eval(const struct GPTree *gp, const struct ArgsGPTree *args,
+          const double *x)
+{
+    const int inputs = GP_NUM_FUNC + args->n_constants;
+    double stack[gp->depth];
+    int sp = 0;
+    for (int i = 0; i < gp->len; ++i) {
+        const int node = gp->code[i];
+        if (node >= inputs) {
+            stack[sp] = x[node - inputs];
+            ++sp;
+        } else if (node >= GP_NUM_FUNC) {
+            stack[sp] = args->constants[node - GP_NUM_FUNC];
+            ++sp;
+        } else {
+            --sp;
+            stack[sp - 1] = tree_function(node, stack[sp - 1], stack[sp]);
+        }
+    }
+    return stack[0];
+}
+
+/**
+ * @brief Applies a node function to two clamped arguments in each lane.
+ * @param [in] node Integer representing a function.
+ * @param [in,out] a The first arguments, overwritten with the results.
+ * @param [in] b The second arguments.
+ * @param [in] n The number of lanes.
+ */
+static void
+tree_function_lanes(const int node, double *restrict a,
+                    const double *restrict b, const int n)
+{
+    switch (node) {
+        case ADD:
+            for (int k = 0; k < n; ++k) {
+                a[k] = clamp(a[k], RET_MIN, RET_MAX) +
+                    clamp(b[k], RET_MIN, RET_MAX);
+            }
+            break;
+        case SUB:
+            for (int k = 0; k < n; ++k) {
+                a[k] = clamp(a[k], RET_MIN, RET_MAX) -
+                    clamp(b[k], RET_MIN, RET_MAX);
+            }
+            break;
+        case MUL:
+            for (int k = 0; k < n; ++k) {
+                a[k] = clamp(a[k], RET_MIN, RET_MAX) *
+                    clamp(b[k], RET_MIN, RET_MAX);
+            }
+            break;
+        case DIV:
+            for (int k = 0; k < n; ++k) {
+                const double l = clamp(a[k], RET_MIN, RET_MAX);
+                const double r = clamp(b[k], RET_MIN, RET_MAX);
+                a[k] = (r != 0) ? (l / r) : l;
+            }
+            break;
+        default:
+            printf("tree_eval_batch() invalid function: %d\n", node);
+            exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Evaluates a GP tree on many input states.
+ * @details Rows are evaluated GP_LANES at a time so that each node is
+ * dispatched once per block and applied across the lanes.
+ * @param [in] gp The GP tree to evaluate.
+ * @param [in] args Tree GP parameters.
+ * @param [in] x The input states, one row after another.
+ * @param [in] n The number of input states.
+ * @param [out] out The result from evaluating the GP tree on each state.
+ */
+void
+tree_eval_batch(const struct GPTree *gp, const struct ArgsGPTree *args,
+                const double *x, const int n, double *out)
+{
+    const int inputs = GP_NUM_FUNC + args->n_constants;
+    const int x_dim = args->n_inputs;
+    double stack[gp->depth][GP_LANES];
+    for (int row = 0; row < n; row += GP_LANES) {
+        const int lanes = (n - row < GP_LANES) ? n - row : GP_LANES;
+        const double *xr = &x[row * x_dim];
+        int sp = 0;
+        for (int i = 0; i < gp->len; ++i) {
+            const int node = gp->code[i];
+            if (node >= inputs) {
+                const int f = node - inputs;
+                for (int k = 0; k < lanes; ++k) {
+                    stack[sp][k] = xr[k * x_dim + f];
+                }
+                ++sp;
+            } else if (node >= GP_NUM_FUNC) {
+                const double c = args->constants[node - GP_NUM_FUNC];
+                for (int k = 0; k < lanes; ++k) {
+                    stack[sp][k] = c;
+                }
+                ++sp;
+            } else {
+                --sp;
+                tree_function_lanes(node, stack[sp - 1], stack[sp], lanes);
+            }
+        }
+        memcpy(&out[row], stack[0], sizeof(double) * lanes);
+    }
+}
+
 /**
  * @brief Returns a string representation of a node function.
  * @param [in] node Integer representing a function.
@@ -307,6 +464,9 @@ tree_copy(struct GPTree *dest, const struct GPTree *src)
     dest->pos = src->pos;
     dest->mu = malloc(sizeof(double) * N_MU);
     memcpy(dest->mu, src->mu, sizeof(double) * N_MU);
+    dest->code = malloc(sizeof(int) * src->len);
+    memcpy(dest->code, src->code, sizeof(int) * src->len);
+    dest->depth = src->depth;
 }
 
 /**
@@ -341,6 +501,8 @@ tree_crossover(struct GPTree *p1, struct GPTree *p2)
     p2->tree = new2;
     p1->len = tree_traverse(p1->tree, 0);
     p2->len = tree_traverse(p2->tree, 0);
+    tree_compile(p1);
+    tree_compile(p2);
 }
 
 /**
@@ -370,6 +532,9 @@ tree_mutate(struct GPTree *gp, const struct ArgsGPTree *args)
             }
         }
     }
+    if (changed) {
+        tree_compile(gp);
+    }
     return changed;
 }
 
@@ -411,6 +576,8 @@ tree_load(struct GPTree *gp, FILE *fp)
     gp->mu = malloc(sizeof(double) * N_MU);
     s += fread(gp->tree, sizeof(int), gp->len, fp);
     s += fread(gp->mu, sizeof(double), N_MU, fp);
+    gp->code = NULL;
+    tree_compile(gp);
     return s;
 }
 
@@ -44,8 +44,10 @@ struct ArgsGPTree {
 struct GPTree {
     int *tree; //!< Flattened tree representation of functions and terminals
     int len; //!< Size of the tree
-    int pos; //!< Current position in the tree
+    int pos; //!< Position in the tree; unused, kept for saved trees
     double *mu; //!< Mutation rates
+    int *code; //!< Tree compiled into postfix order for evaluation
+    int depth; //!< Maximum stack depth needed to evaluate the code
 };
 
 void
@@ -68,7 +70,15 @@ tree_json_import(struct GPTree *gp, const struct ArgsGPTree *args,
                  const cJSON *json);
 
 double
-tree_eval(struct GPTree *gp, const struct ArgsGPTree *args, const double *x);
+tree_eval(const struct GPTree *gp, const struct ArgsGPTree *args,
+          const double *x);
+
+void
+tree_eval_batch(const struct GPTree *gp, const struct ArgsGPTree *args,
+                const double *x, const int n, double *out);
+
+void
+tree_compile(struct GPTree *gp);
 
 void
 tree_crossover(struct GPTree *p1, struct GPTree *p2);
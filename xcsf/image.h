@@ -21,12 +21,14 @@
  * @brief Image handling functions.
  */
 
+#include "blas.h"
+
 void
-col2im(const double *data_col, const int channels, const int height,
+col2im(const real *data_col, const int channels, const int height,
        const int width, const int ksize, const int stride, const int pad,
-       double *data_im);
+       real *data_im);
 
 void
-im2col(const double *data_im, const int channels, const int height,
+im2col(const real *data_im, const int channels, const int height,
        const int width, const int ksize, const int stride, const int pad,
-       double *data_col);
+       real *data_col);
@@ -310,54 +310,229 @@ void
 neural_propagate(struct Net *net, const double *input, const bool train)
 {
     net->train = train;
+#ifdef SINGLE_PRECISION
+    real x[net->n_inputs]; // input in the precision of the layers
+    for (int i = 0; i < net->n_inputs; ++i) {
+        x[i] = (real) input[i];
+    }
+    const real *in = x;
+#else
+    const real *in = input;
+#endif
     const struct Llist *iter = net->tail;
     while (iter != NULL) {
-        layer_forward(iter->layer, net, input);
-        input = layer_output(iter->layer);
+        layer_forward(iter->layer, net, in);
+        in = layer_output(iter->layer);
         iter = iter->prev;
     }
 }
 
 /**
- * @brief Performs a gradient descent update on a neural network.
- * @param [in] net The neural network to be updated.
+ * @brief Backward propagates the error of a neural network's current output.
+ * @param [in] net The neural network.
  * @param [in] truth The desired network output.
- * @param [in] input The input state.
+ * @param [in] in The input state in the precision of the layers.
+ * @param [in] scale Factor applied to the output error.
  */
-void
-neural_learn(const struct Net *net, const double *truth, const double *input)
+static void
+neural_backward(const struct Net *net, const double *truth, const real *in,
+                const double scale)
 {
     // reset deltas
     const struct Llist *iter = net->tail;
     while (iter != NULL) {
-        memset(iter->layer->delta, 0, sizeof(double) * iter->layer->n_outputs);
+        memset(iter->layer->delta, 0, sizeof(real) * iter->layer->n_outputs);
         iter = iter->prev;
     }
     // calculate output layer delta
     const struct Layer *p = net->head->layer;
     for (int i = 0; i < p->n_outputs; ++i) {
-        p->delta[i] = truth[i] - p->output[i];
+        p->delta[i] = (truth[i] - p->output[i]) * scale;
     }
     // backward phase
     iter = net->head;
     while (iter != NULL) {
         const struct Layer *l = iter->layer;
         if (iter->next == NULL) {
-            layer_backward(l, net, input, 0);
+            layer_backward(l, net, in, 0);
         } else {
             const struct Layer *prev = iter->next->layer;
             layer_backward(l, net, prev->output, prev->delta);
         }
         iter = iter->next;
     }
-    // update phase
-    iter = net->tail;
+}
+
+/**
+ * @brief Applies the accumulated gradient descent updates to a neural network.
+ * @param [in] net The neural network to be updated.
+ */
+static void
+neural_update(const struct Net *net)
+{
+    const struct Llist *iter = net->tail;
     while (iter != NULL) {
+        if (iter->layer->options & LAYER_SGD_WEIGHTS) {
+            layer_unshare(iter->layer);
+        }
         layer_update(iter->layer);
         iter = iter->prev;
     }
 }
 
+/**
+ * @brief Performs a gradient descent update on a neural network.
+ * @param [in] net The neural network to be updated.
+ * @param [in] truth The desired network output.
+ * @param [in] input The input state.
+ */
+void
+neural_learn(const struct Net *net, const double *truth, const double *input)
+{
+#ifdef SINGLE_PRECISION
+    real x[net->n_inputs]; // input in the precision of the layers
+    for (int i = 0; i < net->n_inputs; ++i) {
+        x[i] = (real) input[i];
+    }
+    const real *in = x;
+#else
+    const real *in = input;
+#endif
+    neural_backward(net, truth, in, 1);
+    neural_update(net);
+}
+
+/**
+ * @brief Returns whether a neural network consists only of connected layers.
+ * @param [in] net The neural network.
+ * @return Whether all layers are connected layers.
+ */
+static bool
+neural_connected(const struct Net *net)
+{
+    for (const struct Llist *iter = net->tail; iter != NULL;
+         iter = iter->prev) {
+        if (iter->layer->type != CONNECTED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns whether a neural network has layers that keep state from
+ * one input to the next.
+ * @param [in] net The neural network.
+ * @return Whether any layer is a recurrent or LSTM layer.
+ */
+bool
+neural_stateful(const struct Net *net)
+{
+    for (const struct Llist *iter = net->tail; iter != NULL;
+         iter = iter->prev) {
+        if (iter->layer->type == RECURRENT || iter->layer->type == LSTM) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Accumulates the gradients of a batch of samples through a network
+ * of connected layers.
+ * @details Each layer is propagated over all samples at once so that the
+ * products are matrix-matrix rather than vector-matrix. The output errors
+ * are averaged over the batch.
+ * @param [in] net The neural network.
+ * @param [in] truth The desired network outputs, one row per sample.
+ * @param [in] x The input states in the precision of the layers.
+ * @param [in] n The number of samples.
+ */
+static void
+neural_backward_connected(const struct Net *net, const double *truth,
+                          const real *x, const int n)
+{
+    int size = 0;
+    for (const struct Llist *iter = net->tail; iter != NULL;
+         iter = iter->prev) {
+        size += iter->layer->n_outputs;
+    }
+    real *mem = calloc((size_t) 3 * n * size, sizeof(real));
+    real *state[net->n_layers];
+    real *output[net->n_layers];
+    real *delta[net->n_layers];
+    // forward phase
+    real *p = mem;
+    const real *in = x;
+    int i = 0;
+    for (const struct Llist *iter = net->tail; iter != NULL;
+         iter = iter->prev) {
+        const int len = n * iter->layer->n_outputs;
+        state[i] = p;
+        output[i] = p + len;
+        delta[i] = p + 2 * len;
+        p += 3 * len;
+        neural_layer_connected_forward_batch(iter->layer, in, n, state[i],
+                                             output[i]);
+        in = output[i];
+        ++i;
+    }
+    // calculate output layer delta
+    --i;
+    for (int j = 0; j < n * net->n_outputs; ++j) {
+        delta[i][j] = (truth[j] - output[i][j]) / n;
+    }
+    // backward phase
+    for (const struct Llist *iter = net->head; iter != NULL;
+         iter = iter->next) {
+        const real *layer_in = (i > 0) ? output[i - 1] : x;
+        real *prev_delta = (i > 0) ? delta[i - 1] : NULL;
+        neural_layer_connected_backward_batch(iter->layer, layer_in, n,
+                                              state[i], delta[i], prev_delta);
+        --i;
+    }
+    free(mem);
+}
+
+/**
+ * @brief Performs a mini-batch gradient descent update on a neural network.
+ * @details The gradients of the samples are averaged and applied in a single
+ * update. Networks of connected layers propagate the whole batch through
+ * each layer together; other networks propagate the samples one at a time.
+ * @pre The network is not stateful; see neural_stateful().
+ * @param [in] net The neural network to be updated.
+ * @param [in] truth The desired network outputs, one row per sample.
+ * @param [in] input The input states, one row per sample.
+ * @param [in] n The number of samples.
+ */
+void
+neural_learn_batch(struct Net *net, const double *truth, const double *input,
+                   const int n)
+{
+    const int n_in = net->n_inputs;
+#ifdef SINGLE_PRECISION
+    real *x = malloc(sizeof(real) * n * n_in); // inputs in layer precision
+    for (int i = 0; i < n * n_in; ++i) {
+        x[i] = (real) input[i];
+    }
+#else
+    const real *x = input;
+#endif
+    if (neural_connected(net)) {
+        neural_backward_connected(net, truth, x, n);
+    } else {
+        for (int i = 0; i < n; ++i) {
+            neural_propagate(net, &input[i * n_in], true);
+            neural_backward(net, &truth[i * net->n_outputs], &x[i * n_in],
+                            1. / n);
+        }
+    }
+    neural_update(net);
+#ifdef SINGLE_PRECISION
+    free(x);
+#endif
+}
+
 /**
  * @brief Returns the output of a specified neuron in the output layer of a
  * neural network.
@@ -380,7 +555,7 @@ neural_output(const struct Net *net, const int IDX)
  * @param [in] net The neural network to output.
  * @return The neural network outputs.
  */
-double *
+real *
 neural_outputs(const struct Net *net)
 {
     return layer_output(net->head->layer);
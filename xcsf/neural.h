@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "blas.h"
 #include "utils.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -49,7 +50,7 @@ struct Net {
     int n_layers; //!< Number of layers (hidden + output)
     int n_inputs; //!< Number of network inputs
     int n_outputs; //!< Number of network outputs
-    double *output; //!< Pointer to the network output
+    real *output; //!< Pointer to the network output
     struct Llist *head; //!< Pointer to the head layer (output layer)
     struct Llist *tail; //!< Pointer to the tail layer (first layer)
     bool train; //!< Whether the network is in training mode
@@ -68,7 +69,7 @@ neural_json_import(struct Net *net, const struct ArgsLayer *arg,
 double
 neural_output(const struct Net *net, const int IDX);
 
-double *
+real *
 neural_outputs(const struct Net *net);
 
 double
@@ -107,6 +108,13 @@ neural_pop(struct Net *net);
 void
 neural_learn(const struct Net *net, const double *output, const double *input);
 
+bool
+neural_stateful(const struct Net *net);
+
+void
+neural_learn_batch(struct Net *net, const double *truth, const double *input,
+                   const int n);
+
 void
 neural_print(const struct Net *net, const bool print_weights);
 
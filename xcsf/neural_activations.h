@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "blas.h"
 #include <math.h>
 
 #define LOGISTIC (0) //!< Logistic [0,1]
@@ -65,10 +66,10 @@ int
 neural_activation_as_int(const char *a);
 
 void
-neural_activate_array(double *state, double *output, const int n, const int a);
+neural_activate_array(real *state, real *output, const int n, const int a);
 
 void
-neural_gradient_array(const double *state, double *delta, const int n,
+neural_gradient_array(const real *state, real *delta, const int n,
                       const int a);
 
 static inline double
@@ -34,6 +34,8 @@
 #include "neural_layer_upsample.h"
 #include "utils.h"
 
+#define FILL_BLOCK (256) //!< Samples drawn at a time for single precision
+
 /**
  * @brief Sets a neural network layer's functions to the implementations.
  * @param [in] l The neural network layer to set.
@@ -131,20 +133,21 @@ layer_add_neurons(struct Layer *l, const int N)
 {
     const int old_n_outputs = l->n_outputs;
     const int old_n_weights = l->n_weights;
+    layer_unshare(l);
     l->n_outputs += N;
     l->n_biases = l->n_outputs;
     l->n_weights = l->n_outputs * l->n_inputs;
     layer_guard_outputs(l);
     layer_guard_weights(l);
-    l->weights = realloc(l->weights, sizeof(double) * l->n_weights);
+    l->weights = realloc(l->weights, sizeof(real) * l->n_weights);
     l->weight_active = realloc(l->weight_active, sizeof(bool) * l->n_weights);
     l->weight_updates =
-        realloc(l->weight_updates, sizeof(double) * l->n_weights);
-    l->state = realloc(l->state, sizeof(double) * l->n_outputs);
-    l->output = realloc(l->output, sizeof(double) * l->n_outputs);
-    l->biases = realloc(l->biases, sizeof(double) * l->n_biases);
-    l->bias_updates = realloc(l->bias_updates, sizeof(double) * l->n_biases);
-    l->delta = realloc(l->delta, sizeof(double) * l->n_outputs);
+        realloc(l->weight_updates, sizeof(real) * l->n_weights);
+    l->state = realloc(l->state, sizeof(real) * l->n_outputs);
+    l->output = realloc(l->output, sizeof(real) * l->n_outputs);
+    l->biases = realloc(l->biases, sizeof(real) * l->n_biases);
+    l->bias_updates = realloc(l->bias_updates, sizeof(real) * l->n_biases);
+    l->delta = realloc(l->delta, sizeof(real) * l->n_outputs);
     for (int i = old_n_weights; i < l->n_weights; ++i) {
         if (l->options & LAYER_EVOLVE_CONNECT && rand_uniform(0, 1) < 0.5) {
             l->weights[i] = 0;
@@ -180,11 +183,13 @@ layer_mutate_connectivity(struct Layer *l, const double mu_enable,
     if (l->n_inputs > 1 && l->n_outputs > 1) {
         for (int i = 0; i < l->n_weights; ++i) {
             if (!l->weight_active[i] && rand_uniform(0, 1) < mu_enable) {
+                layer_unshare(l);
                 l->weight_active[i] = true;
                 l->weights[i] = rand_normal(0, WEIGHT_SD);
                 ++(l->n_active);
                 mod = true;
             } else if (l->weight_active[i] && rand_uniform(0, 1) < mu_disable) {
+                layer_unshare(l);
                 l->weight_active[i] = false;
                 l->weights[i] = 0;
                 --(l->n_active);
@@ -213,6 +218,7 @@ layer_ensure_input_represention(struct Layer *l)
             }
         }
         if (active < 1) {
+            layer_unshare(l);
             const int r = rand_uniform_int(0, l->n_inputs);
             l->weights[offset + r] = rand_normal(0, WEIGHT_SD);
             l->weight_active[offset + r] = true;
@@ -231,6 +237,7 @@ layer_ensure_input_represention(struct Layer *l)
         while (active < 1) {
             const int offset = l->n_inputs * rand_uniform_int(0, l->n_outputs);
             if (!l->weight_active[offset + i]) {
+                layer_unshare(l);
                 l->weights[offset + i] = rand_normal(0, WEIGHT_SD);
                 l->weight_active[offset + i] = true;
                 ++(l->n_active);
@@ -240,6 +247,159 @@ layer_ensure_input_represention(struct Layer *l)
     }
 }
 
+/**
+ * @brief Adds to the number of layers sharing a layer's weights and biases.
+ * @param [in] l A layer with shareable weights and biases.
+ * @param [in] n The number to add.
+ * @return The new number of layers sharing the weights and biases.
+ */
+static int
+layer_share_add(const struct Layer *l, const int n)
+{
+    int count = 0;
+#ifdef PARALLEL
+    #pragma omp atomic capture
+#endif
+    count = *l->share += n;
+    return count;
+}
+
+/**
+ * @brief Returns the number of layers sharing a layer's weights and biases.
+ * @details A count of one cannot change under the caller since no other
+ * layer holds a reference through which to share.
+ * @param [in] l A layer with shareable weights and biases.
+ * @return The number of layers sharing the weights and biases.
+ */
+static int
+layer_share_count(const struct Layer *l)
+{
+    int count = 0;
+#ifdef PARALLEL
+    #pragma omp atomic read
+#endif
+    count = *l->share;
+    return count;
+}
+
+/**
+ * @brief Makes a layer use the weights and biases of another.
+ * @details The weights, biases and connectivity are shared by reference
+ * until one of the layers modifies them, at which point that layer takes
+ * its own copy with layer_unshare().
+ * @param [in] l The layer to share the weights and biases.
+ * @param [in] src The layer whose weights and biases are to be shared.
+ */
+void
+layer_share(struct Layer *l, const struct Layer *src)
+{
+    layer_share_add(src, 1);
+    l->share = src->share;
+    l->weights = src->weights;
+    l->weight_active = src->weight_active;
+    l->biases = src->biases;
+}
+
+/**
+ * @brief Releases a layer's weights and biases, freeing them once no other
+ * layer shares them.
+ * @param [in] l The layer whose weights and biases are to be released.
+ */
+void
+layer_release(const struct Layer *l)
+{
+    if (layer_share_count(l) == 1 || layer_share_add(l, -1) == 0) {
+        free(l->weights);
+        free(l->weight_active);
+        free(l->biases);
+        free(l->share);
+    }
+}
+
+/**
+ * @brief Gives a layer and its sub-layers their own copies of any weights and
+ * biases shared with other layers.
+ * @details Must be called before the weights, biases or connectivity of a
+ * layer are modified. Layers that do not share are left unchanged.
+ * @param [in] l The layer about to be modified.
+ */
+void
+layer_unshare(struct Layer *l)
+{
+    struct Layer *sub[] = { l->input_layer, l->self_layer, l->output_layer };
+    for (int i = 0; i < (int) (sizeof(sub) / sizeof(sub[0])); ++i) {
+        if (sub[i] != NULL) {
+            layer_unshare(sub[i]);
+        }
+    }
+    if (l->type == LSTM) { // the gates view the stacked sub-layers
+        neural_layer_lstm_views(l);
+    }
+    if (l->share == NULL || layer_share_count(l) == 1) {
+        return;
+    }
+    real *weights = malloc(sizeof(real) * l->n_weights);
+    bool *weight_active = malloc(sizeof(bool) * l->n_weights);
+    real *biases = malloc(sizeof(real) * l->n_biases);
+    memcpy(weights, l->weights, sizeof(real) * l->n_weights);
+    memcpy(weight_active, l->weight_active, sizeof(bool) * l->n_weights);
+    memcpy(biases, l->biases, sizeof(real) * l->n_biases);
+    layer_release(l);
+    l->weights = weights;
+    l->weight_active = weight_active;
+    l->biases = biases;
+    l->share = malloc(sizeof(int));
+    *l->share = 1;
+}
+
+/**
+ * @brief Fills layer values with samples from a normal distribution.
+ * @param [out] x The values to fill.
+ * @param [in] n The number of values.
+ * @param [in] mu Mean of the distribution.
+ * @param [in] sigma Standard deviation of the distribution.
+ */
+void
+layer_fill_normal(real *x, const int n, const double mu, const double sigma)
+{
+#ifdef SINGLE_PRECISION
+    double buf[FILL_BLOCK];
+    for (int i = 0; i < n; i += FILL_BLOCK) {
+        const int len = (n - i < FILL_BLOCK) ? n - i : FILL_BLOCK;
+        rand_normal_fill(buf, len, mu, sigma);
+        for (int j = 0; j < len; ++j) {
+            x[i + j] = (real) buf[j];
+        }
+    }
+#else
+    rand_normal_fill(x, n, mu, sigma);
+#endif
+}
+
+/**
+ * @brief Fills layer values with samples from a uniform distribution.
+ * @param [out] x The values to fill.
+ * @param [in] n The number of values.
+ * @param [in] min Minimum value.
+ * @param [in] max Maximum value.
+ */
+void
+layer_fill_uniform(real *x, const int n, const double min, const double max)
+{
+#ifdef SINGLE_PRECISION
+    double buf[FILL_BLOCK];
+    for (int i = 0; i < n; i += FILL_BLOCK) {
+        const int len = (n - i < FILL_BLOCK) ? n - i : FILL_BLOCK;
+        rand_uniform_fill(buf, len, min, max);
+        for (int j = 0; j < len; ++j) {
+            x[i + j] = (real) buf[j];
+        }
+    }
+#else
+    rand_uniform_fill(x, n, min, max);
+#endif
+}
+
 /**
  * @brief Mutates a layer's weights and biases by adding random numbers from a
  * Gaussian normal distribution with zero mean and standard deviation equal to
@@ -252,6 +412,7 @@ bool
 layer_mutate_weights(struct Layer *l, const double mu)
 {
     bool mod = false;
+    layer_unshare(l);
     for (int i = 0; i < l->n_weights; ++i) {
         if (l->weight_active[i]) {
             const double orig = l->weights[i];
@@ -313,6 +474,22 @@ layer_weight_print(const struct Layer *l, const bool print_weights)
     free(json_str);
 }
 
+/**
+ * @brief Creates a json array from values in the precision of the layers.
+ * @param [in] v The values.
+ * @param [in] n The number of values.
+ * @return The json array.
+ */
+static cJSON *
+layer_json_array(const real *v, const int n)
+{
+#ifdef SINGLE_PRECISION
+    return cJSON_CreateFloatArray(v, n);
+#else
+    return cJSON_CreateDoubleArray(v, n);
+#endif
+}
+
 /**
  * @brief Returns a json formatted string representation of a layer's weights.
  * @param [in] l The layer to return.
@@ -326,12 +503,12 @@ layer_weight_json(const struct Layer *l, const bool return_weights)
     cJSON *json = cJSON_CreateObject();
     cJSON_AddNumberToObject(json, "n_weights", l->n_weights);
     if (return_weights) {
-        cJSON *weights = cJSON_CreateDoubleArray(l->weights, l->n_weights);
+        cJSON *weights = layer_json_array(l->weights, l->n_weights);
         cJSON_AddItemToObject(json, "weights", weights);
     }
     cJSON_AddNumberToObject(json, "n_biases", l->n_biases);
     if (return_weights) {
-        cJSON *biases = cJSON_CreateDoubleArray(l->biases, l->n_biases);
+        cJSON *biases = layer_json_array(l->biases, l->n_biases);
         cJSON_AddItemToObject(json, "biases", biases);
     }
     cJSON_AddNumberToObject(json, "n_active", l->n_active);
@@ -347,14 +524,13 @@ layer_weight_json(const struct Layer *l, const bool return_weights)
 void
 layer_weight_rand(struct Layer *l)
 {
+    layer_unshare(l);
     l->n_active = l->n_weights;
+    layer_fill_normal(l->weights, l->n_weights, 0, WEIGHT_SD_RAND);
+    layer_fill_normal(l->biases, l->n_biases, 0, WEIGHT_SD_RAND);
     for (int i = 0; i < l->n_weights; ++i) {
-        l->weights[i] = rand_normal(0, WEIGHT_SD_RAND);
         l->weight_active[i] = true;
     }
-    for (int i = 0; i < l->n_biases; ++i) {
-        l->biases[i] = rand_normal(0, WEIGHT_SD_RAND);
-    }
 }
 
 /**
@@ -417,6 +593,7 @@ layer_defaults(struct Layer *l)
     l->output = NULL;
     l->options = 0;
     l->weights = NULL;
+    l->share = NULL;
     l->weight_active = NULL;
     l->biases = NULL;
     l->bias_updates = NULL;
@@ -461,8 +638,6 @@ layer_defaults(struct Layer *l)
     l->c = NULL;
     l->h = NULL;
     l->temp = NULL;
-    l->temp2 = NULL;
-    l->temp3 = NULL;
     l->dc = NULL;
     l->height = 0;
     l->width = 0;
@@ -72,15 +72,16 @@
  */
 struct Layer {
     int type; //!< Layer type: CONNECTED, DROPOUT, etc.
-    double *state; //!< Current neuron states (before activation function)
-    double *output; //!< Current neuron outputs (after activation function)
+    real *state; //!< Current neuron states (before activation function)
+    real *output; //!< Current neuron outputs (after activation function)
     uint32_t options; //!< Bitwise layer options permitting evolution, SGD, etc.
-    double *weights; //!< Weights for calculating neuron states
+    real *weights; //!< Weights for calculating neuron states
+    int *share; //!< Number of layers sharing the weights and biases
     bool *weight_active; //!< Whether each connection is present in the layer
-    double *biases; //!< Biases for calculating neuron states
-    double *bias_updates; //!< Updates to biases
-    double *weight_updates; //!< Updates to weights
-    double *delta; //!< Delta for updating weights
+    real *biases; //!< Biases for calculating neuron states
+    real *bias_updates; //!< Updates to biases
+    real *weight_updates; //!< Updates to weights
+    real *delta; //!< Delta for updating weights
     double *mu; //!< Mutation rates
     double eta; //!< Gradient descent rate
     double eta_max; //!< Maximum gradient descent rate
@@ -98,9 +99,9 @@ struct Layer {
     double scale; //!< Usage depends on layer implementation
     double probability; //!< Usage depends on layer implementation
     struct LayerVtbl const *layer_vptr; //!< Functions acting on layers
-    double *prev_state; //!< Previous state for recursive layers
-    struct Layer *input_layer; //!< Recursive layer input
-    struct Layer *self_layer; //!< Recursive layer self
+    real *prev_state; //!< Previous state for recursive layers
+    struct Layer *input_layer; //!< Recursive layer input, LSTM input gates
+    struct Layer *self_layer; //!< Recursive layer self, LSTM self gates
     struct Layer *output_layer; //!< Recursive layer output
     int recurrent_function; //!< LSTM
     struct Layer *uf; //!< LSTM
@@ -111,18 +112,16 @@ struct Layer {
     struct Layer *wi; //!< LSTM
     struct Layer *wg; //!< LSTM
     struct Layer *wo; //!< LSTM
-    double *cell; //!< LSTM
-    double *prev_cell; //!< LSTM
-    double *f; //!< LSTM
-    double *i; //!< LSTM
-    double *g; //!< LSTM
-    double *o; //!< LSTM
-    double *c; //!< LSTM
-    double *h; //!< LSTM
-    double *temp; //!< LSTM
-    double *temp2; //!< LSTM
-    double *temp3; //!< LSTM
-    double *dc; //!< LSTM
+    real *cell; //!< LSTM
+    real *prev_cell; //!< LSTM
+    real *f; //!< LSTM
+    real *i; //!< LSTM
+    real *g; //!< LSTM
+    real *o; //!< LSTM
+    real *c; //!< LSTM
+    real *h; //!< LSTM
+    real *temp; //!< Conv
+    real *dc; //!< LSTM
     int height; //!< Pool, Conv, and Upsample
     int width; //!< Pool, Conv, and Upsample
     int channels; //!< Pool, Conv, and Upsample
@@ -150,10 +149,10 @@ struct LayerVtbl {
     void (*layer_impl_print)(const struct Layer *l, const bool print_weights);
     void (*layer_impl_update)(const struct Layer *l);
     void (*layer_impl_backward)(const struct Layer *l, const struct Net *net,
-                                const double *input, double *delta);
+                                const real *input, real *delta);
     void (*layer_impl_forward)(const struct Layer *l, const struct Net *net,
-                               const double *input);
-    double *(*layer_impl_output)(const struct Layer *l);
+                               const real *input);
+    real *(*layer_impl_output)(const struct Layer *l);
     size_t (*layer_impl_save)(const struct Layer *l, FILE *fp);
     size_t (*layer_impl_load)(struct Layer *l, FILE *fp);
     char *(*layer_impl_json_export)(const struct Layer *l,
@@ -189,7 +188,7 @@ layer_load(struct Layer *l, FILE *fp)
  * @param [in] l The layer whose outputs are to be returned.
  * @return The layer outputs.
  */
-static inline double *
+static inline real *
 layer_output(const struct Layer *l)
 {
     return (*l->layer_vptr->layer_impl_output)(l);
@@ -202,7 +201,7 @@ layer_output(const struct Layer *l)
  * @param [in] input Input to the layer.
  */
 static inline void
-layer_forward(const struct Layer *l, const struct Net *net, const double *input)
+layer_forward(const struct Layer *l, const struct Net *net, const real *input)
 {
     (*l->layer_vptr->layer_impl_forward)(l, net, input);
 }
@@ -216,7 +215,7 @@ layer_forward(const struct Layer *l, const struct Net *net, const double *input)
  */
 static inline void
 layer_backward(const struct Layer *l, const struct Net *net,
-               const double *input, double *delta)
+               const real *input, real *delta)
 {
     (*l->layer_vptr->layer_impl_backward)(l, net, input, delta);
 }
@@ -320,6 +319,12 @@ layer_mutate_functions(struct Layer *l, const double mu);
 bool
 layer_mutate_weights(struct Layer *l, const double mu);
 
+void
+layer_fill_normal(real *x, const int n, const double mu, const double sigma);
+
+void
+layer_fill_uniform(real *x, const int n, const double min, const double max);
+
 int
 layer_mutate_neurons(const struct Layer *l, const double mu);
 
@@ -353,6 +358,15 @@ layer_weight_rand(struct Layer *l);
 void
 layer_ensure_input_represention(struct Layer *l);
 
+void
+layer_share(struct Layer *l, const struct Layer *src);
+
+void
+layer_unshare(struct Layer *l);
+
+void
+layer_release(const struct Layer *l);
+
 const char *
 layer_type_as_string(const int type);
 
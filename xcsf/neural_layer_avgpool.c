@@ -33,8 +33,8 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -45,8 +45,8 @@ static void
 realloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = realloc(l->output, sizeof(double) * l->n_outputs);
-    l->delta = realloc(l->delta, sizeof(double) * l->n_outputs);
+    l->output = realloc(l->output, sizeof(real) * l->n_outputs);
+    l->delta = realloc(l->delta, sizeof(real) * l->n_outputs);
 }
 
 /**
@@ -127,7 +127,7 @@ neural_layer_avgpool_rand(struct Layer *l)
  */
 void
 neural_layer_avgpool_forward(const struct Layer *l, const struct Net *net,
-                             const double *input)
+                             const real *input)
 {
     (void) net;
     const int n = l->height * l->width;
@@ -149,7 +149,7 @@ neural_layer_avgpool_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_avgpool_backward(const struct Layer *l, const struct Net *net,
-                              const double *input, double *delta)
+                              const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -211,7 +211,7 @@ neural_layer_avgpool_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_avgpool_output(const struct Layer *l)
 {
     return l->output;
@@ -43,6 +43,8 @@ static const int MU_TYPE[N_MU] = {
 
 /**
  * @brief Allocate memory used by a connected layer.
+ * @details The weights, biases and connectivity, which may be shared with
+ * other layers, are allocated separately by malloc_layer_weights().
  * @param [in] l The layer to be allocated memory.
  */
 static void
@@ -50,17 +52,28 @@ malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
     layer_guard_weights(l);
-    l->state = calloc(l->n_outputs, sizeof(double));
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->biases = malloc(sizeof(double) * l->n_outputs);
-    l->bias_updates = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->weight_updates = calloc(l->n_weights, sizeof(double));
-    l->weight_active = malloc(sizeof(bool) * l->n_weights);
-    l->weights = malloc(sizeof(double) * l->n_weights);
+    l->state = calloc(l->n_outputs, sizeof(real));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->bias_updates = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
+    l->weight_updates = calloc(l->n_weights, sizeof(real));
     l->mu = malloc(sizeof(double) * N_MU);
 }
 
+/**
+ * @brief Allocate the weights and biases of a connected layer.
+ * @param [in] l The layer to be allocated weights and biases.
+ */
+static void
+malloc_layer_weights(struct Layer *l)
+{
+    l->biases = malloc(sizeof(real) * l->n_outputs);
+    l->weight_active = malloc(sizeof(bool) * l->n_weights);
+    l->weights = malloc(sizeof(real) * l->n_weights);
+    l->share = malloc(sizeof(int));
+    *l->share = 1;
+}
+
 /**
  * @brief Initialises a fully-connected layer.
  * @param [in] l Layer to initialise.
@@ -87,11 +100,12 @@ neural_layer_connected_init(struct Layer *l, const struct ArgsLayer *args)
     l->decay = args->decay;
     layer_init_eta(l);
     malloc_layer_arrays(l);
+    malloc_layer_weights(l);
+    layer_fill_normal(l->weights, l->n_weights, 0, WEIGHT_SD_INIT);
     for (int i = 0; i < l->n_weights; ++i) {
-        l->weights[i] = rand_normal(0, WEIGHT_SD_INIT);
         l->weight_active[i] = true;
     }
-    memset(l->biases, 0, sizeof(double) * l->n_biases);
+    memset(l->biases, 0, sizeof(real) * l->n_biases);
     sam_init(l->mu, N_MU, MU_TYPE);
 }
 
@@ -104,17 +118,17 @@ neural_layer_connected_free(const struct Layer *l)
 {
     free(l->state);
     free(l->output);
-    free(l->biases);
     free(l->bias_updates);
     free(l->delta);
     free(l->weight_updates);
-    free(l->weight_active);
-    free(l->weights);
     free(l->mu);
+    layer_release(l);
 }
 
 /**
  * @brief Initialises and creates a copy of one connected layer from another.
+ * @details The copy shares the weights and biases of the source until either
+ * layer modifies them.
  * @param [in] src The source layer.
  * @return A pointer to the new layer.
  */
@@ -147,9 +161,7 @@ neural_layer_connected_copy(const struct Layer *src)
     l->max_neuron_grow = src->max_neuron_grow;
     l->n_active = src->n_active;
     malloc_layer_arrays(l);
-    memcpy(l->biases, src->biases, sizeof(double) * src->n_biases);
-    memcpy(l->weights, src->weights, sizeof(double) * src->n_weights);
-    memcpy(l->weight_active, src->weight_active, sizeof(bool) * src->n_weights);
+    layer_share(l, src);
     memcpy(l->mu, src->mu, sizeof(double) * N_MU);
     return l;
 }
@@ -172,16 +184,16 @@ neural_layer_connected_rand(struct Layer *l)
  */
 void
 neural_layer_connected_forward(const struct Layer *l, const struct Net *net,
-                               const double *input)
+                               const real *input)
 {
     (void) net;
     const int k = l->n_inputs;
     const int n = l->n_outputs;
-    const double *a = input;
-    const double *b = l->weights;
-    double *c = l->state;
-    memcpy(l->state, l->biases, sizeof(double) * l->n_outputs);
-    blas_gemm(0, 1, 1, n, k, 1, a, k, b, k, 1, c, n);
+    const real *a = input;
+    const real *b = l->weights;
+    real *c = l->state;
+    memcpy(l->state, l->biases, sizeof(real) * l->n_outputs);
+    blas_rgemm(0, 1, 1, n, k, 1, a, k, b, k, 1, c, n);
     neural_activate_array(l->state, l->output, l->n_outputs, l->function);
 }
 
@@ -194,45 +206,99 @@ neural_layer_connected_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_connected_backward(const struct Layer *l, const struct Net *net,
-                                const double *input, double *delta)
+                                const real *input, real *delta)
 {
     (void) net;
     neural_gradient_array(l->state, l->delta, l->n_outputs, l->function);
     if (l->options & LAYER_SGD_WEIGHTS) {
         const int m = l->n_outputs;
         const int n = l->n_inputs;
-        const double *a = l->delta;
-        const double *b = input;
-        double *c = l->weight_updates;
-        blas_axpy(l->n_outputs, 1, l->delta, 1, l->bias_updates, 1);
-        blas_gemm(1, 0, m, n, 1, 1, a, m, b, n, 1, c, n);
+        const real *a = l->delta;
+        const real *b = input;
+        real *c = l->weight_updates;
+        blas_raxpy(l->n_outputs, 1, l->delta, 1, l->bias_updates, 1);
+        blas_rgemm(1, 0, m, n, 1, 1, a, m, b, n, 1, c, n);
     }
     if (delta) {
         const int k = l->n_outputs;
         const int n = l->n_inputs;
-        const double *a = l->delta;
-        const double *b = l->weights;
-        double *c = delta;
-        blas_gemm(0, 0, 1, n, k, 1, a, k, b, n, 1, c, n);
+        const real *a = l->delta;
+        const real *b = l->weights;
+        real *c = delta;
+        blas_rgemm(0, 0, 1, n, k, 1, a, k, b, n, 1, c, n);
+    }
+}
+
+/**
+ * @brief Forward propagates a batch of inputs through a connected layer.
+ * @details The layer's own state and output are left unchanged.
+ * @param [in] l The layer to forward propagate.
+ * @param [in] input The inputs to the layer, one row per sample.
+ * @param [in] n The number of samples.
+ * @param [out] state The states of the layer, one row per sample.
+ * @param [out] output The outputs of the layer, one row per sample.
+ */
+void
+neural_layer_connected_forward_batch(const struct Layer *l, const real *input,
+                                     const int n, real *state, real *output)
+{
+    const int k = l->n_inputs;
+    const int m = l->n_outputs;
+    for (int i = 0; i < n; ++i) {
+        memcpy(&state[i * m], l->biases, sizeof(real) * m);
+    }
+    blas_rgemm(0, 1, n, m, k, 1, input, k, l->weights, k, 1, state, m);
+    neural_activate_array(state, output, n * m, l->function);
+}
+
+/**
+ * @brief Backward propagates a batch of errors through a connected layer.
+ * @details The gradients of the samples are summed into the layer updates.
+ * @param [in] l The layer to backward propagate.
+ * @param [in] input The inputs to the layer, one row per sample.
+ * @param [in] n The number of samples.
+ * @param [in] state The states of the layer, one row per sample.
+ * @param [in,out] delta The errors of the layer, one row per sample.
+ * @param [out] prev_delta The previous layer's errors, or NULL.
+ */
+void
+neural_layer_connected_backward_batch(const struct Layer *l, const real *input,
+                                      const int n, const real *state,
+                                      real *delta, real *prev_delta)
+{
+    const int k = l->n_inputs;
+    const int m = l->n_outputs;
+    neural_gradient_array(state, delta, n * m, l->function);
+    if (l->options & LAYER_SGD_WEIGHTS) {
+        for (int i = 0; i < n; ++i) {
+            blas_raxpy(m, 1, &delta[i * m], 1, l->bias_updates, 1);
+        }
+        blas_rgemm(1, 0, m, k, n, 1, delta, m, input, k, 1, l->weight_updates,
+                   k);
+    }
+    if (prev_delta) {
+        blas_rgemm(0, 0, n, k, m, 1, delta, m, l->weights, k, 1, prev_delta,
+                   k);
     }
 }
 
 /**
  * @brief Updates the weights and biases of a connected layer.
+ * @pre The weights and biases are not shared; see layer_unshare().
  * @param [in] l The layer to update.
  */
 void
 neural_layer_connected_update(const struct Layer *l)
 {
     if (l->options & LAYER_SGD_WEIGHTS && l->eta > 0) {
-        blas_axpy(l->n_biases, l->eta, l->bias_updates, 1, l->biases, 1);
-        blas_scal(l->n_biases, l->momentum, l->bias_updates, 1);
+        blas_raxpy(l->n_biases, l->eta, l->bias_updates, 1, l->biases, 1);
+        blas_rscal(l->n_biases, l->momentum, l->bias_updates, 1);
         if (l->decay > 0) {
-            blas_axpy(l->n_weights, -(l->decay), l->weights, 1,
-                      l->weight_updates, 1);
+            blas_raxpy(l->n_weights, -(l->decay), l->weights, 1,
+                       l->weight_updates, 1);
         }
-        blas_axpy(l->n_weights, l->eta, l->weight_updates, 1, l->weights, 1);
-        blas_scal(l->n_weights, l->momentum, l->weight_updates, 1);
+        blas_raxpy(l->n_weights, l->eta, l->weight_updates, 1, l->weights, 1);
+        blas_rscal(l->n_weights, l->momentum, l->weight_updates, 1);
         layer_weight_clamp(l);
     }
 }
@@ -251,8 +317,9 @@ neural_layer_connected_resize(struct Layer *l, const struct Layer *prev)
         layer_print(l, false);
         exit(EXIT_FAILURE);
     }
-    double *weights = malloc(sizeof(double) * n_weights);
-    double *weight_updates = malloc(sizeof(double) * n_weights);
+    layer_unshare(l);
+    real *weights = malloc(sizeof(real) * n_weights);
+    real *weight_updates = malloc(sizeof(real) * n_weights);
     bool *weight_active = malloc(sizeof(bool) * n_weights);
     for (int i = 0; i < l->n_outputs; ++i) {
         const int orig_offset = i * l->n_inputs;
@@ -324,7 +391,7 @@ neural_layer_connected_mutate(struct Layer *l)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_connected_output(const struct Layer *l)
 {
     return l->output;
@@ -396,11 +463,11 @@ neural_layer_connected_save(const struct Layer *l, FILE *fp)
     s += fwrite(&l->momentum, sizeof(double), 1, fp);
     s += fwrite(&l->decay, sizeof(double), 1, fp);
     s += fwrite(&l->n_active, sizeof(int), 1, fp);
-    s += fwrite(l->weights, sizeof(double), l->n_weights, fp);
+    s += fwrite(l->weights, sizeof(real), l->n_weights, fp);
     s += fwrite(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fwrite(l->biases, sizeof(double), l->n_biases, fp);
-    s += fwrite(l->bias_updates, sizeof(double), l->n_biases, fp);
-    s += fwrite(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fwrite(l->biases, sizeof(real), l->n_biases, fp);
+    s += fwrite(l->bias_updates, sizeof(real), l->n_biases, fp);
+    s += fwrite(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fwrite(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -433,11 +500,12 @@ neural_layer_connected_load(struct Layer *l, FILE *fp)
     l->out_c = 1;
     l->out_h = 1;
     malloc_layer_arrays(l);
-    s += fread(l->weights, sizeof(double), l->n_weights, fp);
+    malloc_layer_weights(l);
+    s += fread(l->weights, sizeof(real), l->n_weights, fp);
     s += fread(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fread(l->biases, sizeof(double), l->n_biases, fp);
-    s += fread(l->bias_updates, sizeof(double), l->n_biases, fp);
-    s += fread(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fread(l->biases, sizeof(real), l->n_biases, fp);
+    s += fread(l->bias_updates, sizeof(real), l->n_biases, fp);
+    s += fread(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fread(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -36,11 +36,20 @@ neural_layer_connected_rand(struct Layer *l);
 
 void
 neural_layer_connected_forward(const struct Layer *l, const struct Net *net,
-                               const double *input);
+                               const real *input);
 
 void
 neural_layer_connected_backward(const struct Layer *l, const struct Net *net,
-                                const double *input, double *delta);
+                                const real *input, real *delta);
+
+void
+neural_layer_connected_forward_batch(const struct Layer *l, const real *input,
+                                     const int n, real *state, real *output);
+
+void
+neural_layer_connected_backward_batch(const struct Layer *l, const real *input,
+                                      const int n, const real *state,
+                                      real *delta, real *prev_delta);
 
 void
 neural_layer_connected_update(const struct Layer *l);
@@ -54,7 +63,7 @@ neural_layer_connected_mutate(struct Layer *l);
 void
 neural_layer_connected_free(const struct Layer *l);
 
-double *
+real *
 neural_layer_connected_output(const struct Layer *l);
 
 size_t
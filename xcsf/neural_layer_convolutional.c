@@ -73,7 +73,7 @@ static size_t
 get_workspace_size(const struct Layer *l)
 {
     const size_t workspace_size = (size_t) l->out_h * l->out_w * l->size *
-        l->size * l->channels * sizeof(double);
+        l->size * l->channels * sizeof(real);
     if (workspace_size < 1) {
         printf("neural_layer_convolutional: invalid workspace size\n");
         layer_print(l, false);
@@ -102,14 +102,14 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     guard_malloc(l);
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->state = calloc(l->n_outputs, sizeof(double));
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->weights = malloc(sizeof(double) * l->n_weights);
-    l->weight_updates = calloc(l->n_weights, sizeof(double));
+    l->delta = calloc(l->n_outputs, sizeof(real));
+    l->state = calloc(l->n_outputs, sizeof(real));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->weights = malloc(sizeof(real) * l->n_weights);
+    l->weight_updates = calloc(l->n_weights, sizeof(real));
     l->weight_active = malloc(sizeof(bool) * l->n_weights);
-    l->biases = malloc(sizeof(double) * l->n_biases);
-    l->bias_updates = calloc(l->n_biases, sizeof(double));
+    l->biases = malloc(sizeof(real) * l->n_biases);
+    l->bias_updates = calloc(l->n_biases, sizeof(real));
     l->temp = malloc(get_workspace_size(l));
     l->mu = malloc(sizeof(double) * N_MU);
 }
@@ -122,15 +122,15 @@ static void
 realloc_layer_arrays(struct Layer *l)
 {
     guard_malloc(l);
-    l->delta = realloc(l->delta, sizeof(double) * l->n_outputs);
-    l->state = realloc(l->state, sizeof(double) * l->n_outputs);
-    l->output = realloc(l->output, sizeof(double) * l->n_outputs);
-    l->weights = realloc(l->weights, sizeof(double) * l->n_weights);
+    l->delta = realloc(l->delta, sizeof(real) * l->n_outputs);
+    l->state = realloc(l->state, sizeof(real) * l->n_outputs);
+    l->output = realloc(l->output, sizeof(real) * l->n_outputs);
+    l->weights = realloc(l->weights, sizeof(real) * l->n_weights);
     l->weight_updates =
-        realloc(l->weight_updates, sizeof(double) * l->n_weights);
+        realloc(l->weight_updates, sizeof(real) * l->n_weights);
     l->weight_active = realloc(l->weight_active, sizeof(bool) * l->n_weights);
-    l->biases = realloc(l->biases, sizeof(double) * l->n_biases);
-    l->bias_updates = realloc(l->bias_updates, sizeof(double) * l->n_biases);
+    l->biases = realloc(l->biases, sizeof(real) * l->n_biases);
+    l->bias_updates = realloc(l->bias_updates, sizeof(real) * l->n_biases);
     l->temp = realloc(l->temp, get_workspace_size(l));
 }
 
@@ -186,11 +186,11 @@ neural_layer_convolutional_init(struct Layer *l, const struct ArgsLayer *args)
     l->n_outputs = l->out_h * l->out_w * l->out_c;
     layer_init_eta(l);
     malloc_layer_arrays(l);
+    layer_fill_normal(l->weights, l->n_weights, 0, WEIGHT_SD_INIT);
     for (int i = 0; i < l->n_weights; ++i) {
-        l->weights[i] = rand_normal(0, WEIGHT_SD_INIT);
         l->weight_active[i] = true;
     }
-    memset(l->biases, 0, sizeof(double) * l->n_biases);
+    memset(l->biases, 0, sizeof(real) * l->n_biases);
     sam_init(l->mu, N_MU, MU_TYPE);
 }
 
@@ -235,9 +235,9 @@ neural_layer_convolutional_copy(const struct Layer *src)
     l->eta_max = src->eta_max;
     l->eta_min = src->eta_min;
     malloc_layer_arrays(l);
-    memcpy(l->weights, src->weights, sizeof(double) * src->n_weights);
+    memcpy(l->weights, src->weights, sizeof(real) * src->n_weights);
     memcpy(l->weight_active, src->weight_active, sizeof(bool) * src->n_weights);
-    memcpy(l->biases, src->biases, sizeof(double) * src->n_biases);
+    memcpy(l->biases, src->biases, sizeof(real) * src->n_biases);
     memcpy(l->mu, src->mu, sizeof(double) * N_MU);
     return l;
 }
@@ -260,22 +260,22 @@ neural_layer_convolutional_rand(struct Layer *l)
  */
 void
 neural_layer_convolutional_forward(const struct Layer *l, const struct Net *net,
-                                   const double *input)
+                                   const real *input)
 {
     (void) net;
     const int m = l->n_filters;
     const int k = l->size * l->size * l->channels;
     const int n = l->out_w * l->out_h;
-    const double *a = l->weights;
-    double *b = l->temp;
-    double *c = l->state;
-    memset(l->state, 0, sizeof(double) * l->n_outputs);
+    const real *a = l->weights;
+    real *b = l->temp;
+    real *c = l->state;
+    memset(l->state, 0, sizeof(real) * l->n_outputs);
     if (l->size == 1) {
-        blas_gemm(0, 0, m, n, k, 1, a, k, input, n, 1, c, n);
+        blas_rgemm(0, 0, m, n, k, 1, a, k, input, n, 1, c, n);
     } else {
         im2col(input, l->channels, l->height, l->width, l->size, l->stride,
                l->pad, b);
-        blas_gemm(0, 0, m, n, k, 1, a, k, b, n, 1, c, n);
+        blas_rgemm(0, 0, m, n, k, 1, a, k, b, n, 1, c, n);
     }
     for (int i = 0; i < l->n_biases; ++i) {
         for (int j = 0; j < n; ++j) {
@@ -294,8 +294,8 @@ neural_layer_convolutional_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_convolutional_backward(const struct Layer *l,
-                                    const struct Net *net, const double *input,
-                                    double *delta)
+                                    const struct Net *net, const real *input,
+                                    real *delta)
 {
     (void) net;
     const int m = l->n_filters;
@@ -304,27 +304,27 @@ neural_layer_convolutional_backward(const struct Layer *l,
     if (l->options & LAYER_SGD_WEIGHTS) {
         neural_gradient_array(l->state, l->delta, l->n_outputs, l->function);
         for (int i = 0; i < l->n_biases; ++i) {
-            l->bias_updates[i] += blas_sum(l->delta + k * i, k);
+            l->bias_updates[i] += blas_rsum(l->delta + k * i, k);
         }
-        const double *a = l->delta;
-        double *b = l->temp;
-        double *c = l->weight_updates;
+        const real *a = l->delta;
+        real *b = l->temp;
+        real *c = l->weight_updates;
         if (l->size == 1) {
-            blas_gemm(0, 1, m, n, k, 1, a, k, input, k, 1, c, n);
+            blas_rgemm(0, 1, m, n, k, 1, a, k, input, k, 1, c, n);
         } else {
             im2col(input, l->channels, l->height, l->width, l->size, l->stride,
                    l->pad, b);
-            blas_gemm(0, 1, m, n, k, 1, a, k, b, k, 1, c, n);
+            blas_rgemm(0, 1, m, n, k, 1, a, k, b, k, 1, c, n);
         }
     }
     if (delta) {
-        const double *a = l->weights;
-        const double *b = l->delta;
-        double *c = l->temp;
+        const real *a = l->weights;
+        const real *b = l->delta;
+        real *c = l->temp;
         if (l->size == 1) {
             c = delta;
         }
-        blas_gemm(1, 0, n, k, m, 1, a, n, b, k, 0, c, k);
+        blas_rgemm(1, 0, n, k, m, 1, a, n, b, k, 0, c, k);
         if (l->size != 1) {
             col2im(l->temp, l->channels, l->height, l->width, l->size,
                    l->stride, l->pad, delta);
@@ -340,14 +340,14 @@ void
 neural_layer_convolutional_update(const struct Layer *l)
 {
     if (l->options & LAYER_SGD_WEIGHTS && l->eta > 0) {
-        blas_axpy(l->n_biases, l->eta, l->bias_updates, 1, l->biases, 1);
-        blas_scal(l->n_biases, l->momentum, l->bias_updates, 1);
+        blas_raxpy(l->n_biases, l->eta, l->bias_updates, 1, l->biases, 1);
+        blas_rscal(l->n_biases, l->momentum, l->bias_updates, 1);
         if (l->decay > 0) {
-            blas_axpy(l->n_weights, -(l->decay), l->weights, 1,
-                      l->weight_updates, 1);
+            blas_raxpy(l->n_weights, -(l->decay), l->weights, 1,
+                       l->weight_updates, 1);
         }
-        blas_axpy(l->n_weights, l->eta, l->weight_updates, 1, l->weights, 1);
-        blas_scal(l->n_weights, l->momentum, l->weight_updates, 1);
+        blas_raxpy(l->n_weights, l->eta, l->weight_updates, 1, l->weights, 1);
+        blas_rscal(l->n_weights, l->momentum, l->weight_updates, 1);
         layer_weight_clamp(l);
     }
 }
@@ -483,7 +483,7 @@ neural_layer_convolutional_mutate(struct Layer *l)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_convolutional_output(const struct Layer *l)
 {
     return l->output;
@@ -570,11 +570,11 @@ neural_layer_convolutional_save(const struct Layer *l, FILE *fp)
     s += fwrite(&l->momentum, sizeof(double), 1, fp);
     s += fwrite(&l->decay, sizeof(double), 1, fp);
     s += fwrite(&l->max_neuron_grow, sizeof(int), 1, fp);
-    s += fwrite(l->weights, sizeof(double), l->n_weights, fp);
-    s += fwrite(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fwrite(l->weights, sizeof(real), l->n_weights, fp);
+    s += fwrite(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fwrite(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fwrite(l->biases, sizeof(double), l->n_biases, fp);
-    s += fwrite(l->bias_updates, sizeof(double), l->n_filters, fp);
+    s += fwrite(l->biases, sizeof(real), l->n_biases, fp);
+    s += fwrite(l->bias_updates, sizeof(real), l->n_filters, fp);
     s += fwrite(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -614,11 +614,11 @@ neural_layer_convolutional_load(struct Layer *l, FILE *fp)
     s += fread(&l->decay, sizeof(double), 1, fp);
     s += fread(&l->max_neuron_grow, sizeof(int), 1, fp);
     malloc_layer_arrays(l);
-    s += fread(l->weights, sizeof(double), l->n_weights, fp);
-    s += fread(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fread(l->weights, sizeof(real), l->n_weights, fp);
+    s += fread(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fread(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fread(l->biases, sizeof(double), l->n_biases, fp);
-    s += fread(l->bias_updates, sizeof(double), l->n_biases, fp);
+    s += fread(l->biases, sizeof(real), l->n_biases, fp);
+    s += fread(l->bias_updates, sizeof(real), l->n_biases, fp);
     s += fread(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -36,12 +36,12 @@ neural_layer_convolutional_rand(struct Layer *l);
 
 void
 neural_layer_convolutional_forward(const struct Layer *l, const struct Net *net,
-                                   const double *input);
+                                   const real *input);
 
 void
 neural_layer_convolutional_backward(const struct Layer *l,
-                                    const struct Net *net, const double *input,
-                                    double *delta);
+                                    const struct Net *net, const real *input,
+                                    real *delta);
 
 void
 neural_layer_convolutional_update(const struct Layer *l);
@@ -56,7 +56,7 @@ neural_layer_convolutional_mutate(struct Layer *l);
 void
 neural_layer_convolutional_free(const struct Layer *l);
 
-double *
+real *
 neural_layer_convolutional_output(const struct Layer *l);
 
 size_t
@@ -21,6 +21,8 @@
  * @brief An implementation of a long short-term memory layer.
  * @details Stateful, and with a step of 1.
  * Typically the output activation is TANH and recurrent activation LOGISTIC.
+ * The input and self weights of the four gates are each stacked in a single
+ * connected layer, which the per-gate connected layers view.
  */
 
 #include "neural_layer_lstm.h"
@@ -31,6 +33,7 @@
 #include "utils.h"
 
 #define N_MU (6) //!< Number of mutation rates applied to an LSTM layer
+#define N_GATES (4) //!< Number of gates in an LSTM layer
 
 /**
  * @brief Self-adaptation method for mutating an LSTM layer.
@@ -75,9 +78,232 @@ set_layer_n_biases(struct Layer *l)
 static void
 set_layer_n_active(struct Layer *l)
 {
-    l->n_active = l->uf->n_active + l->ui->n_active + l->ug->n_active +
-        l->uo->n_active + l->wf->n_active + l->wi->n_active + l->wg->n_active +
-        l->wo->n_active;
+    l->input_layer->n_active = l->uf->n_active + l->ui->n_active +
+        l->ug->n_active + l->uo->n_active;
+    l->self_layer->n_active = l->wf->n_active + l->wi->n_active +
+        l->wg->n_active + l->wo->n_active;
+    l->n_active = l->input_layer->n_active + l->self_layer->n_active;
+}
+
+/**
+ * @brief Points the connected layers of four gates at their rows of a stack.
+ * @param [in] stack The connected layer holding the stacked gates.
+ * @param [in] gates The connected layers of the forget, input, cell and
+ * output gates.
+ */
+static void
+gates_view(const struct Layer *stack, struct Layer *const *gates)
+{
+    const int n = stack->n_outputs / N_GATES;
+    const int k = stack->n_inputs;
+    for (int q = 0; q < N_GATES; ++q) {
+        struct Layer *g = gates[q];
+        g->n_inputs = k;
+        g->n_outputs = n;
+        g->out_w = n;
+        g->n_weights = n * k;
+        g->n_biases = n;
+        g->weights = &stack->weights[q * n * k];
+        g->weight_active = &stack->weight_active[q * n * k];
+        g->weight_updates = &stack->weight_updates[q * n * k];
+        g->biases = &stack->biases[q * n];
+        g->bias_updates = &stack->bias_updates[q * n];
+        g->state = &stack->state[q * n];
+        g->output = &stack->output[q * n];
+        g->delta = &stack->delta[q * n];
+    }
+}
+
+/**
+ * @brief Stacks the connected layers of four gates into a single layer.
+ * @details The gates are left as views of the stack, keeping only their own
+ * mutation rates.
+ * @param [in] gates The connected layers of the forget, input, cell and
+ * output gates.
+ * @return A connected layer holding the stacked gates.
+ */
+static struct Layer *
+gates_stack(struct Layer *const *gates)
+{
+    const struct Layer *src = gates[0];
+    const int n = src->n_outputs;
+    const int n_weights = src->n_weights;
+    struct Layer *l = malloc(sizeof(struct Layer));
+    layer_defaults(l);
+    l->type = src->type;
+    l->layer_vptr = src->layer_vptr;
+    l->function = src->function;
+    l->options = src->options;
+    l->n_inputs = src->n_inputs;
+    l->n_outputs = N_GATES * n;
+    l->max_outputs = N_GATES * src->max_outputs;
+    l->out_w = l->n_outputs;
+    l->out_h = 1;
+    l->out_c = 1;
+    l->n_weights = N_GATES * n_weights;
+    l->n_biases = l->n_outputs;
+    l->eta = src->eta;
+    l->eta_max = src->eta_max;
+    l->eta_min = src->eta_min;
+    l->momentum = src->momentum;
+    l->decay = src->decay;
+    l->max_neuron_grow = src->max_neuron_grow;
+    layer_guard_outputs(l);
+    layer_guard_weights(l);
+    l->weights = malloc(sizeof(real) * l->n_weights);
+    l->weight_active = malloc(sizeof(bool) * l->n_weights);
+    l->weight_updates = malloc(sizeof(real) * l->n_weights);
+    l->biases = malloc(sizeof(real) * l->n_outputs);
+    l->bias_updates = malloc(sizeof(real) * l->n_outputs);
+    l->state = malloc(sizeof(real) * l->n_outputs);
+    l->output = malloc(sizeof(real) * l->n_outputs);
+    l->delta = malloc(sizeof(real) * l->n_outputs);
+    l->share = malloc(sizeof(int));
+    *l->share = 1;
+    l->mu = malloc(sizeof(double) * N_MU);
+    memcpy(l->mu, src->mu, sizeof(double) * N_MU);
+    for (int q = 0; q < N_GATES; ++q) {
+        struct Layer *g = gates[q];
+        const int w = q * n_weights;
+        memcpy(&l->weights[w], g->weights, sizeof(real) * n_weights);
+        memcpy(&l->weight_active[w], g->weight_active,
+               sizeof(bool) * n_weights);
+        memcpy(&l->weight_updates[w], g->weight_updates,
+               sizeof(real) * n_weights);
+        memcpy(&l->biases[q * n], g->biases, sizeof(real) * n);
+        memcpy(&l->bias_updates[q * n], g->bias_updates, sizeof(real) * n);
+        memcpy(&l->state[q * n], g->state, sizeof(real) * n);
+        memcpy(&l->output[q * n], g->output, sizeof(real) * n);
+        memcpy(&l->delta[q * n], g->delta, sizeof(real) * n);
+        l->n_active += g->n_active;
+        free(g->state);
+        free(g->output);
+        free(g->bias_updates);
+        free(g->delta);
+        free(g->weight_updates);
+        layer_release(g);
+        g->share = NULL;
+    }
+    gates_view(l, gates);
+    return l;
+}
+
+/**
+ * @brief Gives the connected layers of four gates their own copies of their
+ * rows of a stack, which is then freed.
+ * @param [in] stack The connected layer holding the stacked gates.
+ * @param [in] gates The connected layers of the forget, input, cell and
+ * output gates.
+ */
+static void
+gates_unstack(struct Layer *stack, struct Layer *const *gates)
+{
+    for (int q = 0; q < N_GATES; ++q) {
+        struct Layer *g = gates[q];
+        const real *weights = g->weights;
+        const bool *weight_active = g->weight_active;
+        const real *weight_updates = g->weight_updates;
+        const real *biases = g->biases;
+        const real *bias_updates = g->bias_updates;
+        const real *state = g->state;
+        const real *output = g->output;
+        const real *delta = g->delta;
+        const int n = g->n_outputs;
+        g->weights = malloc(sizeof(real) * g->n_weights);
+        g->weight_active = malloc(sizeof(bool) * g->n_weights);
+        g->weight_updates = malloc(sizeof(real) * g->n_weights);
+        g->biases = malloc(sizeof(real) * n);
+        g->bias_updates = malloc(sizeof(real) * n);
+        g->state = malloc(sizeof(real) * n);
+        g->output = malloc(sizeof(real) * n);
+        g->delta = malloc(sizeof(real) * n);
+        g->share = malloc(sizeof(int));
+        *g->share = 1;
+        memcpy(g->weights, weights, sizeof(real) * g->n_weights);
+        memcpy(g->weight_active, weight_active, sizeof(bool) * g->n_weights);
+        memcpy(g->weight_updates, weight_updates, sizeof(real) * g->n_weights);
+        memcpy(g->biases, biases, sizeof(real) * n);
+        memcpy(g->bias_updates, bias_updates, sizeof(real) * n);
+        memcpy(g->state, state, sizeof(real) * n);
+        memcpy(g->output, output, sizeof(real) * n);
+        memcpy(g->delta, delta, sizeof(real) * n);
+    }
+    layer_free(stack);
+    free(stack);
+}
+
+/**
+ * @brief Creates a connected layer of a gate that views the same rows of a
+ * stack as the connected layer of another gate.
+ * @param [in] src The connected layer of the gate to copy.
+ * @return A pointer to the new gate layer; see neural_layer_lstm_views().
+ */
+static struct Layer *
+gate_copy(const struct Layer *src)
+{
+    struct Layer *l = malloc(sizeof(struct Layer));
+    layer_defaults(l);
+    l->type = src->type;
+    l->layer_vptr = src->layer_vptr;
+    l->function = src->function;
+    l->options = src->options;
+    l->max_outputs = src->max_outputs;
+    l->out_h = src->out_h;
+    l->out_c = src->out_c;
+    l->n_active = src->n_active;
+    l->eta = src->eta;
+    l->eta_max = src->eta_max;
+    l->eta_min = src->eta_min;
+    l->momentum = src->momentum;
+    l->decay = src->decay;
+    l->max_neuron_grow = src->max_neuron_grow;
+    l->mu = malloc(sizeof(double) * N_MU);
+    memcpy(l->mu, src->mu, sizeof(double) * N_MU);
+    return l;
+}
+
+/**
+ * @brief Stacks the input and self connected layers of the gates.
+ * @param [in] l The layer whose gates are to be stacked.
+ */
+static void
+stack_gates(struct Layer *l)
+{
+    struct Layer *u[N_GATES] = { l->uf, l->ui, l->ug, l->uo };
+    struct Layer *w[N_GATES] = { l->wf, l->wi, l->wg, l->wo };
+    l->input_layer = gates_stack(u);
+    l->self_layer = gates_stack(w);
+}
+
+/**
+ * @brief Gives the input and self connected layers of the gates their own
+ * weights and biases, freeing the stacks.
+ * @param [in] l The layer whose gates are to be unstacked.
+ */
+static void
+unstack_gates(struct Layer *l)
+{
+    struct Layer *u[N_GATES] = { l->uf, l->ui, l->ug, l->uo };
+    struct Layer *w[N_GATES] = { l->wf, l->wi, l->wg, l->wo };
+    gates_unstack(l->input_layer, u);
+    gates_unstack(l->self_layer, w);
+    l->input_layer = NULL;
+    l->self_layer = NULL;
+}
+
+/**
+ * @brief Points the connected layers of an LSTM's gates at their stacks.
+ * @details Must be called whenever the stacked weights and biases are
+ * reallocated, for example by layer_unshare().
+ * @param [in] l The LSTM layer.
+ */
+void
+neural_layer_lstm_views(const struct Layer *l)
+{
+    struct Layer *u[N_GATES] = { l->uf, l->ui, l->ug, l->uo };
+    struct Layer *w[N_GATES] = { l->wf, l->wi, l->wg, l->wo };
+    gates_view(l->input_layer, u);
+    gates_view(l->self_layer, w);
 }
 
 /**
@@ -88,22 +314,19 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->state = calloc(l->n_outputs, sizeof(double));
-    l->prev_state = calloc(l->n_outputs, sizeof(double));
-    l->prev_cell = calloc(l->n_outputs, sizeof(double));
-    l->cell = calloc(l->n_outputs, sizeof(double));
-    l->f = calloc(l->n_outputs, sizeof(double));
-    l->i = calloc(l->n_outputs, sizeof(double));
-    l->g = calloc(l->n_outputs, sizeof(double));
-    l->o = calloc(l->n_outputs, sizeof(double));
-    l->c = calloc(l->n_outputs, sizeof(double));
-    l->h = calloc(l->n_outputs, sizeof(double));
-    l->temp = calloc(l->n_outputs, sizeof(double));
-    l->temp2 = calloc(l->n_outputs, sizeof(double));
-    l->temp3 = calloc(l->n_outputs, sizeof(double));
-    l->dc = calloc(l->n_outputs, sizeof(double));
+    l->delta = calloc(l->n_outputs, sizeof(real));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->state = calloc(l->n_outputs, sizeof(real));
+    l->prev_state = calloc(l->n_outputs, sizeof(real));
+    l->prev_cell = calloc(l->n_outputs, sizeof(real));
+    l->cell = calloc(l->n_outputs, sizeof(real));
+    l->f = calloc(l->n_outputs, sizeof(real));
+    l->i = calloc(l->n_outputs, sizeof(real));
+    l->g = calloc(l->n_outputs, sizeof(real));
+    l->o = calloc(l->n_outputs, sizeof(real));
+    l->c = calloc(l->n_outputs, sizeof(real));
+    l->h = calloc(l->n_outputs, sizeof(real));
+    l->dc = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -125,9 +348,6 @@ free_layer_arrays(const struct Layer *l)
     free(l->o);
     free(l->c);
     free(l->h);
-    free(l->temp);
-    free(l->temp2);
-    free(l->temp3);
     free(l->dc);
 }
 
@@ -139,6 +359,8 @@ static void
 set_eta(struct Layer *l)
 {
     l->eta = l->uf->eta;
+    l->input_layer->eta = l->eta;
+    l->self_layer->eta = l->eta;
     l->ui->eta = l->eta;
     l->ug->eta = l->eta;
     l->uo->eta = l->eta;
@@ -148,24 +370,6 @@ set_eta(struct Layer *l)
     l->wo->eta = l->eta;
 }
 
-/**
- * @brief Zeros the deltas used to update an LSTM layer.
- * @param [in] l The layer whose deltas are to be reset.
- */
-static void
-reset_layer_deltas(const struct Layer *l)
-{
-    size_t size = l->n_outputs * sizeof(double);
-    memset(l->wf->delta, 0, size);
-    memset(l->wi->delta, 0, size);
-    memset(l->wg->delta, 0, size);
-    memset(l->wo->delta, 0, size);
-    memset(l->uf->delta, 0, size);
-    memset(l->ui->delta, 0, size);
-    memset(l->ug->delta, 0, size);
-    memset(l->uo->delta, 0, size);
-}
-
 /**
  * @brief Mutates the gradient descent rate used to update an LSTM layer.
  * @param [in] l The layer whose gradient descent rate is to be mutated.
@@ -191,6 +395,7 @@ mutate_neurons(struct Layer *l)
 {
     const int n = layer_mutate_neurons(l->uf, l->mu[1]);
     if (n != 0) {
+        unstack_gates(l);
         layer_add_neurons(l->uf, n);
         layer_add_neurons(l->ui, n);
         layer_add_neurons(l->ug, n);
@@ -203,6 +408,7 @@ mutate_neurons(struct Layer *l)
         layer_resize(l->wi, l->uf);
         layer_resize(l->wg, l->uf);
         layer_resize(l->wo, l->uf);
+        stack_gates(l);
         l->n_outputs = l->uf->n_outputs;
         l->out_w = l->n_outputs;
         l->out_c = 1;
@@ -226,6 +432,7 @@ static bool
 mutate_connectivity(struct Layer *l)
 {
     bool mod = false;
+    layer_unshare(l);
     mod = layer_mutate_connectivity(l->uf, l->mu[2], l->mu[3]) ? true : mod;
     mod = layer_mutate_connectivity(l->ui, l->mu[2], l->mu[3]) ? true : mod;
     mod = layer_mutate_connectivity(l->ug, l->mu[2], l->mu[3]) ? true : mod;
@@ -247,6 +454,7 @@ static bool
 mutate_weights(struct Layer *l)
 {
     bool mod = false;
+    layer_unshare(l);
     mod = layer_mutate_weights(l->uf, l->mu[4]) ? true : mod;
     mod = layer_mutate_weights(l->ui, l->mu[4]) ? true : mod;
     mod = layer_mutate_weights(l->ug, l->mu[4]) ? true : mod;
@@ -292,6 +500,7 @@ neural_layer_lstm_init(struct Layer *l, const struct ArgsLayer *args)
     l->wg = layer_init(cargs);
     l->wo = layer_init(cargs);
     free(cargs);
+    stack_gates(l);
     set_layer_n_biases(l);
     set_layer_n_weights(l);
     set_layer_n_active(l);
@@ -334,14 +543,17 @@ neural_layer_lstm_copy(const struct Layer *src)
     l->decay = src->decay;
     l->max_neuron_grow = src->max_neuron_grow;
     l->max_outputs = src->max_outputs;
-    l->uf = layer_copy(src->uf);
-    l->ui = layer_copy(src->ui);
-    l->ug = layer_copy(src->ug);
-    l->uo = layer_copy(src->uo);
-    l->wf = layer_copy(src->wf);
-    l->wi = layer_copy(src->wi);
-    l->wg = layer_copy(src->wg);
-    l->wo = layer_copy(src->wo);
+    l->input_layer = layer_copy(src->input_layer);
+    l->self_layer = layer_copy(src->self_layer);
+    l->uf = gate_copy(src->uf);
+    l->ui = gate_copy(src->ui);
+    l->ug = gate_copy(src->ug);
+    l->uo = gate_copy(src->uo);
+    l->wf = gate_copy(src->wf);
+    l->wi = gate_copy(src->wi);
+    l->wg = gate_copy(src->wg);
+    l->wo = gate_copy(src->wo);
+    neural_layer_lstm_views(l);
     malloc_layer_arrays(l);
     l->mu = malloc(sizeof(double) * N_MU);
     memcpy(l->mu, src->mu, sizeof(double) * N_MU);
@@ -355,14 +567,18 @@ neural_layer_lstm_copy(const struct Layer *src)
 void
 neural_layer_lstm_free(const struct Layer *l)
 {
-    layer_free(l->uf);
-    layer_free(l->ui);
-    layer_free(l->ug);
-    layer_free(l->uo);
-    layer_free(l->wf);
-    layer_free(l->wi);
-    layer_free(l->wg);
-    layer_free(l->wo);
+    layer_free(l->input_layer);
+    layer_free(l->self_layer);
+    free(l->input_layer);
+    free(l->self_layer);
+    free(l->uf->mu);
+    free(l->ui->mu);
+    free(l->ug->mu);
+    free(l->uo->mu);
+    free(l->wf->mu);
+    free(l->wi->mu);
+    free(l->wg->mu);
+    free(l->wo->mu);
     free(l->uf);
     free(l->ui);
     free(l->ug);
@@ -382,6 +598,7 @@ neural_layer_lstm_free(const struct Layer *l)
 void
 neural_layer_lstm_rand(struct Layer *l)
 {
+    layer_unshare(l);
     layer_rand(l->uf);
     layer_rand(l->ui);
     layer_rand(l->ug);
@@ -392,49 +609,72 @@ neural_layer_lstm_rand(struct Layer *l)
     layer_rand(l->wo);
 }
 
+/**
+ * @brief Computes the states of a stack of LSTM gate connected layers.
+ * @details The connected layers are linear so their activation is left to
+ * the LSTM, which sums the input and self states of each gate.
+ * @param [in] l The connected layer holding the stacked gates.
+ * @param [in] input The input to the connected layer.
+ */
+static void
+gate_state(const struct Layer *l, const real *input)
+{
+    const int k = l->n_inputs;
+    const int n = l->n_outputs;
+    memcpy(l->state, l->biases, sizeof(real) * n);
+    blas_rgemm(0, 1, 1, n, k, 1, input, k, l->weights, k, 1, l->state, n);
+}
+
+/**
+ * @brief Returns the activation of an LSTM gate.
+ * @param [in] u The state of the gate's input layer.
+ * @param [in] w The state of the gate's self layer.
+ * @param [in] function The activation function of the gate.
+ * @return The gate activation.
+ */
+static inline real
+gate_activate(const real u, const real w, const int function)
+{
+    const real sum = (real) clamp(w, NEURON_MIN, NEURON_MAX) +
+        (real) clamp(u, NEURON_MIN, NEURON_MAX);
+    const real state = clamp(sum, NEURON_MIN, NEURON_MAX);
+    return neural_activate(function, state);
+}
+
 /**
  * @brief Forward propagates an LSTM layer.
+ * @details The input and self states of the four gates are each computed with
+ * a single matrix-vector product over the stacked weights and then the gate
+ * activations, cell and output are computed in a single pass.
  * @param [in] l The layer to forward propagate.
  * @param [in] net Network containing the layer.
  * @param [in] input The input to the layer.
  */
 void
 neural_layer_lstm_forward(const struct Layer *l, const struct Net *net,
-                          const double *input)
-{
-    layer_forward(l->uf, net, input);
-    layer_forward(l->ui, net, input);
-    layer_forward(l->ug, net, input);
-    layer_forward(l->uo, net, input);
-    layer_forward(l->wf, net, l->h);
-    layer_forward(l->wi, net, l->h);
-    layer_forward(l->wg, net, l->h);
-    layer_forward(l->wo, net, l->h);
-    memcpy(l->f, l->wf->output, sizeof(double) * l->n_outputs);
-    blas_axpy(l->n_outputs, 1, l->uf->output, 1, l->f, 1);
-    memcpy(l->i, l->wi->output, sizeof(double) * l->n_outputs);
-    blas_axpy(l->n_outputs, 1, l->ui->output, 1, l->i, 1);
-    memcpy(l->g, l->wg->output, sizeof(double) * l->n_outputs);
-    blas_axpy(l->n_outputs, 1, l->ug->output, 1, l->g, 1);
-    memcpy(l->o, l->wo->output, sizeof(double) * l->n_outputs);
-    blas_axpy(l->n_outputs, 1, l->uo->output, 1, l->o, 1);
-    neural_activate_array(l->f, l->f, l->n_outputs, l->recurrent_function);
-    neural_activate_array(l->i, l->i, l->n_outputs, l->recurrent_function);
-    neural_activate_array(l->g, l->g, l->n_outputs, l->function);
-    neural_activate_array(l->o, l->o, l->n_outputs, l->recurrent_function);
-    memcpy(l->temp, l->i, sizeof(double) * l->n_outputs);
-    blas_mul(l->n_outputs, l->g, 1, l->temp, 1);
-    blas_mul(l->n_outputs, l->f, 1, l->c, 1);
-    blas_axpy(l->n_outputs, 1, l->temp, 1, l->c, 1);
-    memcpy(l->h, l->c, sizeof(double) * l->n_outputs);
-    neural_activate_array(l->h, l->h, l->n_outputs, l->function);
-    blas_mul(l->n_outputs, l->o, 1, l->h, 1);
-    memcpy(l->cell, l->c, sizeof(double) * l->n_outputs);
-    memcpy(l->output, l->h, sizeof(double) * l->n_outputs);
+                          const real *input)
+{
+    (void) net;
+    gate_state(l->input_layer, input);
+    gate_state(l->self_layer, l->h);
+    const int rf = l->recurrent_function;
+    for (int j = 0; j < l->n_outputs; ++j) {
+        l->f[j] = gate_activate(l->uf->state[j], l->wf->state[j], rf);
+        l->i[j] = gate_activate(l->ui->state[j], l->wi->state[j], rf);
+        l->g[j] = gate_activate(l->ug->state[j], l->wg->state[j], l->function);
+        l->o[j] = gate_activate(l->uo->state[j], l->wo->state[j], rf);
+        l->c[j] = l->c[j] * l->f[j] + l->i[j] * l->g[j];
+        const real c = clamp(l->c[j], NEURON_MIN, NEURON_MAX);
+        l->h[j] = (real) neural_activate(l->function, c) * l->o[j];
+        l->cell[j] = l->c[j];
+        l->output[j] = l->h[j];
+    }
 }
 
 /**
  * @brief Backward propagates an LSTM layer.
+ * @details The gate errors are computed in a single pass and then backward
+ * propagated through the stacked input and self connected layers.
  * @param [in] l The layer to backward propagate.
  * @param [in] net Network containing the layer.
  * @param [in] input The input to the layer.
@@ -442,48 +682,35 @@ neural_layer_lstm_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_lstm_backward(const struct Layer *l, const struct Net *net,
-                           const double *input, double *delta)
-{
-    reset_layer_deltas(l);
-    memcpy(l->temp3, l->delta, sizeof(double) * l->n_outputs);
-    memcpy(l->temp, l->c, sizeof(double) * l->n_outputs);
-    neural_activate_array(l->temp, l->temp, l->n_outputs, l->function);
-    memcpy(l->temp2, l->temp3, sizeof(double) * l->n_outputs);
-    blas_mul(l->n_outputs, l->o, 1, l->temp2, 1);
-    neural_gradient_array(l->temp, l->temp2, l->n_outputs, l->function);
-    blas_axpy(l->n_outputs, 1, l->dc, 1, l->temp2, 1);
-    memcpy(l->temp, l->c, sizeof(double) * l->n_outputs);
-    neural_activate_array(l->temp, l->temp, l->n_outputs, l->function);
-    blas_mul(l->n_outputs, l->temp3, 1, l->temp, 1);
-    neural_gradient_array(l->o, l->temp, l->n_outputs, l->recurrent_function);
-    memcpy(l->wo->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->wo, net, l->prev_state, 0);
-    memcpy(l->uo->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->uo, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
-    blas_mul(l->n_outputs, l->i, 1, l->temp, 1);
-    neural_gradient_array(l->g, l->temp, l->n_outputs, l->function);
-    memcpy(l->wg->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->wg, net, l->prev_state, 0);
-    memcpy(l->ug->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->ug, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
-    blas_mul(l->n_outputs, l->g, 1, l->temp, 1);
-    neural_gradient_array(l->i, l->temp, l->n_outputs, l->recurrent_function);
-    memcpy(l->wi->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->wi, net, l->prev_state, 0);
-    memcpy(l->ui->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->ui, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
-    blas_mul(l->n_outputs, l->prev_cell, 1, l->temp, 1);
-    neural_gradient_array(l->f, l->temp, l->n_outputs, l->recurrent_function);
-    memcpy(l->wf->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->wf, net, l->prev_state, 0);
-    memcpy(l->uf->delta, l->temp, sizeof(double) * l->n_outputs);
-    layer_backward(l->uf, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
-    blas_mul(l->n_outputs, l->f, 1, l->temp, 1);
-    memcpy(l->dc, l->temp, sizeof(double) * l->n_outputs);
+                           const real *input, real *delta)
+{
+    const int rf = l->recurrent_function;
+    for (int j = 0; j < l->n_outputs; ++j) {
+        const real c = clamp(l->c[j], NEURON_MIN, NEURON_MAX);
+        const real h = neural_activate(l->function, c);
+        real dc = l->delta[j] * l->o[j];
+        dc *= neural_gradient(l->function, h);
+        dc += l->dc[j];
+        real d = h * l->delta[j];
+        d *= neural_gradient(rf, l->o[j]);
+        l->wo->delta[j] = d;
+        l->uo->delta[j] = d;
+        d = dc * l->i[j];
+        d *= neural_gradient(l->function, l->g[j]);
+        l->wg->delta[j] = d;
+        l->ug->delta[j] = d;
+        d = dc * l->g[j];
+        d *= neural_gradient(rf, l->i[j]);
+        l->wi->delta[j] = d;
+        l->ui->delta[j] = d;
+        d = dc * l->prev_cell[j];
+        d *= neural_gradient(rf, l->f[j]);
+        l->wf->delta[j] = d;
+        l->uf->delta[j] = d;
+        l->dc[j] = dc * l->f[j];
+    }
+    layer_backward(l->self_layer, net, l->prev_state, 0);
+    layer_backward(l->input_layer, net, input, delta);
 }
 
 /**
@@ -494,14 +721,8 @@ void
 neural_layer_lstm_update(const struct Layer *l)
 {
     if (l->options & LAYER_SGD_WEIGHTS && l->eta > 0) {
-        layer_update(l->wf);
-        layer_update(l->wi);
-        layer_update(l->wg);
-        layer_update(l->wo);
-        layer_update(l->uf);
-        layer_update(l->ui);
-        layer_update(l->ug);
-        layer_update(l->uo);
+        layer_update(l->self_layer);
+        layer_update(l->input_layer);
     }
 }
 
@@ -513,11 +734,13 @@ neural_layer_lstm_update(const struct Layer *l)
 void
 neural_layer_lstm_resize(struct Layer *l, const struct Layer *prev)
 {
+    unstack_gates(l);
     layer_resize(l->uf, prev);
     layer_resize(l->ui, prev);
     layer_resize(l->ug, prev);
     layer_resize(l->uo, prev);
     layer_resize(l->uf, prev);
+    stack_gates(l);
     l->n_inputs = prev->n_outputs;
     set_layer_n_weights(l);
     set_layer_n_biases(l);
@@ -529,7 +752,7 @@ neural_layer_lstm_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_lstm_output(const struct Layer *l)
 {
     return l->output;
@@ -658,19 +881,16 @@ neural_layer_lstm_save(const struct Layer *l, FILE *fp)
     s += fwrite(&l->max_neuron_grow, sizeof(int), 1, fp);
     s += fwrite(&l->options, sizeof(uint32_t), 1, fp);
     s += fwrite(l->mu, sizeof(double), N_MU, fp);
-    s += fwrite(l->state, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->prev_state, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->cell, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->f, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->i, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->g, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->o, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->c, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->h, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->temp, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->temp2, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->temp3, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->dc, sizeof(double), l->n_outputs, fp);
+    s += fwrite(l->state, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->prev_state, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->cell, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->f, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->i, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->g, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->o, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->c, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->h, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->dc, sizeof(real), l->n_outputs, fp);
     s += layer_save(l->uf, fp);
     s += layer_save(l->ui, fp);
     s += layer_save(l->ug, fp);
@@ -682,6 +902,23 @@ neural_layer_lstm_save(const struct Layer *l, FILE *fp)
     return s;
 }
 
+/**
+ * @brief Reads the connected layer of an LSTM gate from a file.
+ * @param [out] gate The connected layer to be created.
+ * @param [in] fp Pointer to the file to be read.
+ * @return The number of elements read.
+ */
+static size_t
+gate_load(struct Layer **gate, FILE *fp)
+{
+    struct Layer *l = malloc(sizeof(struct Layer));
+    layer_defaults(l);
+    l->type = CONNECTED;
+    layer_set_vptr(l);
+    *gate = l;
+    return layer_load(l, fp);
+}
+
 /**
  * @brief Reads an LSTM layer from a file.
  * @param [in] l The layer to load.
@@ -710,26 +947,24 @@ neural_layer_lstm_load(struct Layer *l, FILE *fp)
     malloc_layer_arrays(l);
     l->mu = malloc(sizeof(double) * N_MU);
     s += fread(l->mu, sizeof(double), N_MU, fp);
-    s += fread(l->state, sizeof(double), l->n_outputs, fp);
-    s += fread(l->prev_state, sizeof(double), l->n_outputs, fp);
-    s += fread(l->cell, sizeof(double), l->n_outputs, fp);
-    s += fread(l->f, sizeof(double), l->n_outputs, fp);
-    s += fread(l->i, sizeof(double), l->n_outputs, fp);
-    s += fread(l->g, sizeof(double), l->n_outputs, fp);
-    s += fread(l->o, sizeof(double), l->n_outputs, fp);
-    s += fread(l->c, sizeof(double), l->n_outputs, fp);
-    s += fread(l->h, sizeof(double), l->n_outputs, fp);
-    s += fread(l->temp, sizeof(double), l->n_outputs, fp);
-    s += fread(l->temp2, sizeof(double), l->n_outputs, fp);
-    s += fread(l->temp3, sizeof(double), l->n_outputs, fp);
-    s += fread(l->dc, sizeof(double), l->n_outputs, fp);
-    s += layer_load(l->uf, fp);
-    s += layer_load(l->ui, fp);
-    s += layer_load(l->ug, fp);
-    s += layer_load(l->uo, fp);
-    s += layer_load(l->wf, fp);
-    s += layer_load(l->wi, fp);
-    s += layer_load(l->wg, fp);
-    s += layer_load(l->wo, fp);
+    s += fread(l->state, sizeof(real), l->n_outputs, fp);
+    s += fread(l->prev_state, sizeof(real), l->n_outputs, fp);
+    s += fread(l->cell, sizeof(real), l->n_outputs, fp);
+    s += fread(l->f, sizeof(real), l->n_outputs, fp);
+    s += fread(l->i, sizeof(real), l->n_outputs, fp);
+    s += fread(l->g, sizeof(real), l->n_outputs, fp);
+    s += fread(l->o, sizeof(real), l->n_outputs, fp);
+    s += fread(l->c, sizeof(real), l->n_outputs, fp);
+    s += fread(l->h, sizeof(real), l->n_outputs, fp);
+    s += fread(l->dc, sizeof(real), l->n_outputs, fp);
+    s += gate_load(&l->uf, fp);
+    s += gate_load(&l->ui, fp);
+    s += gate_load(&l->ug, fp);
+    s += gate_load(&l->uo, fp);
+    s += gate_load(&l->wf, fp);
+    s += gate_load(&l->wi, fp);
+    s += gate_load(&l->wg, fp);
+    s += gate_load(&l->wo, fp);
+    stack_gates(l);
     return s;
 }
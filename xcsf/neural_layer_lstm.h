@@ -36,11 +36,11 @@ neural_layer_lstm_rand(struct Layer *l);
 
 void
 neural_layer_lstm_forward(const struct Layer *l, const struct Net *net,
-                          const double *input);
+                          const real *input);
 
 void
 neural_layer_lstm_backward(const struct Layer *l, const struct Net *net,
-                           const double *input, double *delta);
+                           const real *input, real *delta);
 
 void
 neural_layer_lstm_update(const struct Layer *l);
@@ -54,7 +54,7 @@ neural_layer_lstm_mutate(struct Layer *l);
 void
 neural_layer_lstm_free(const struct Layer *l);
 
-double *
+real *
 neural_layer_lstm_output(const struct Layer *l);
 
 size_t
@@ -69,6 +69,9 @@ neural_layer_lstm_resize(struct Layer *l, const struct Layer *prev);
 char *
 neural_layer_lstm_json_export(const struct Layer *l, const bool return_weights);
 
+void
+neural_layer_lstm_views(const struct Layer *l);
+
 /**
  * @brief Neural long short-term memory layer implemented functions.
  */
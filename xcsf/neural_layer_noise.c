@@ -33,9 +33,9 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->state = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
+    l->state = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -125,15 +125,15 @@ neural_layer_noise_rand(struct Layer *l)
  */
 void
 neural_layer_noise_forward(const struct Layer *l, const struct Net *net,
-                           const double *input)
+                           const real *input)
 {
     if (!net->train) {
         for (int i = 0; i < l->n_inputs; ++i) {
             l->output[i] = input[i];
         }
     } else {
+        layer_fill_uniform(l->state, l->n_inputs, 0, 1);
         for (int i = 0; i < l->n_inputs; ++i) {
-            l->state[i] = rand_uniform(0, 1);
             if (l->state[i] < l->probability) {
                 l->output[i] = input[i] + rand_normal(0, l->scale);
             } else {
@@ -152,7 +152,7 @@ neural_layer_noise_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_noise_backward(const struct Layer *l, const struct Net *net,
-                            const double *input, double *delta)
+                            const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -208,7 +208,7 @@ neural_layer_noise_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_noise_output(const struct Layer *l)
 {
     return l->output;
@@ -36,11 +36,11 @@ neural_layer_recurrent_rand(struct Layer *l);
 
 void
 neural_layer_recurrent_forward(const struct Layer *l, const struct Net *net,
-                               const double *input);
+                               const real *input);
 
 void
 neural_layer_recurrent_backward(const struct Layer *l, const struct Net *net,
-                                const double *input, double *delta);
+                                const real *input, real *delta);
 
 void
 neural_layer_recurrent_update(const struct Layer *l);
@@ -54,7 +54,7 @@ neural_layer_recurrent_mutate(struct Layer *l);
 void
 neural_layer_recurrent_free(const struct Layer *l);
 
-double *
+real *
 neural_layer_recurrent_output(const struct Layer *l);
 
 size_t
@@ -33,8 +33,8 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -111,7 +111,7 @@ neural_layer_softmax_rand(struct Layer *l)
  */
 void
 neural_layer_softmax_forward(const struct Layer *l, const struct Net *net,
-                             const double *input)
+                             const real *input)
 {
     (void) net;
     double largest = input[0];
@@ -140,7 +140,7 @@ neural_layer_softmax_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_softmax_backward(const struct Layer *l, const struct Net *net,
-                              const double *input, double *delta)
+                              const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -241,7 +241,7 @@ neural_layer_softmax_free(const struct Layer *l)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_softmax_output(const struct Layer *l)
 {
     return l->output;
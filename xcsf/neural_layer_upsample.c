@@ -33,8 +33,8 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -127,7 +127,7 @@ neural_layer_upsample_rand(struct Layer *l)
  */
 void
 neural_layer_upsample_forward(const struct Layer *l, const struct Net *net,
-                              const double *input)
+                              const real *input)
 {
     (void) net;
     const int w = l->width;
@@ -154,7 +154,7 @@ neural_layer_upsample_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_upsample_backward(const struct Layer *l, const struct Net *net,
-                               const double *input, double *delta)
+                               const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -224,7 +224,7 @@ neural_layer_upsample_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_upsample_output(const struct Layer *l)
 {
     return l->output;
@@ -65,41 +65,22 @@ pa_build(const struct XCSF *xcsf, const double *x)
     double *pa = xcsf->pa;
     double *nr = xcsf->nr;
     pa_reset(xcsf);
+    // propagate input and compute predictions
 #ifdef PARALLEL_PRED
-    // (parallel) propagate input and compute predictions
-    struct Cl *clist[set->size];
-    struct Clist *iter = set->list;
-    for (int i = 0; i < set->size; ++i) {
-        clist[i] = NULL;
-        if (iter != NULL) {
-            clist[i] = iter->cl;
-            iter = iter->next;
-        }
-    }
     #pragma omp parallel for
+#endif
     for (int i = 0; i < set->size; ++i) {
-        if (clist[i] != NULL) {
-            cl_predict(xcsf, clist[i], x);
-        }
-    }
-#else
-    // (series) propagate input and compute predictions
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        cl_predict(xcsf, iter->cl, x);
-        iter = iter->next;
+        cl_predict(xcsf, set->cl[i], x);
     }
-#endif
     // compute the prediction array in series for determinism
-    iter = set->list;
-    while (iter != NULL) {
-        const double *pred = iter->cl->prediction;
-        const double fitness = iter->cl->fit;
+    for (int i = 0; i < set->size; ++i) {
+        const struct Cl *c = set->cl[i];
+        const double *pred = c->prediction;
+        const double fitness = c->fit;
         for (int j = 0; j < xcsf->y_dim; ++j) {
-            pa[iter->cl->action * xcsf->y_dim + j] += pred[j] * fitness;
-            nr[iter->cl->action * xcsf->y_dim + j] += fitness;
+            pa[c->action * xcsf->y_dim + j] += pred[j] * fitness;
+            nr[c->action * xcsf->y_dim + j] += fitness;
         }
-        iter = iter->next;
     }
     for (int i = 0; i < xcsf->n_actions; ++i) {
         for (int j = 0; j < xcsf->y_dim; ++j) {
@@ -122,7 +103,8 @@ pa_build(const struct XCSF *xcsf, const double *x)
 int
 pa_best_action(const struct XCSF *xcsf)
 {
-    int *max_i = calloc(xcsf->n_actions, sizeof(int));
+    int max_i[xcsf->n_actions];
+    max_i[0] = 0;
     double max = xcsf->pa[0];
     int n_max = 1;
     for (int i = 1; i < xcsf->n_actions; ++i) {
@@ -136,9 +118,7 @@ pa_best_action(const struct XCSF *xcsf)
             ++n_max;
         }
     }
-    const int best = max_i[rand_uniform_int(0, n_max)];
-    free(max_i);
-    return best;
+    return max_i[rand_uniform_int(0, n_max)];
 }
 
 /**
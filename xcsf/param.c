@@ -25,6 +25,7 @@
 #include "action.h"
 #include "condition.h"
 #include "ea.h"
+#include "pool.h"
 #include "prediction.h"
 #include "utils.h"
 
@@ -54,8 +55,10 @@ param_init(struct XCSF *xcsf, const int x_dim, const int y_dim,
     xcsf->act = malloc(sizeof(struct ArgsAct));
     xcsf->cond = malloc(sizeof(struct ArgsCond));
     xcsf->pred = malloc(sizeof(struct ArgsPred));
+    xcsf->pool = pool_init();
     xcsf->population_file = malloc(sizeof(char));
     xcsf->population_file[0] = '\0';
+    xcsf->soa = NULL;
     param_set_n_actions(xcsf, n_actions);
     param_set_x_dim(xcsf, x_dim);
     param_set_y_dim(xcsf, y_dim);
@@ -102,6 +105,7 @@ param_free(struct XCSF *xcsf)
     free(xcsf->act);
     free(xcsf->cond);
     free(xcsf->pred);
+    pool_destroy(xcsf->pool);
 }
 
 /**
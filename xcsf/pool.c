@@ -0,0 +1,197 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pool.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Slab allocator for classifiers and their payloads.
+ */
+
+#include "pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PARALLEL
+    #include <omp.h>
+#endif
+
+#define POOL_LARGE (POOL_CLASSES) //!< Class of blocks taken from the heap
+
+/**
+ * @brief Returns the size class used to hold a block of a given size.
+ * @param [in] size The number of bytes requested.
+ * @return The size class.
+ */
+static size_t
+pool_class(const size_t size)
+{
+    if (size > (size_t) POOL_GRAIN * POOL_CLASSES) {
+        return POOL_LARGE;
+    }
+    return (size > 0) ? (size - 1) / POOL_GRAIN : 0;
+}
+
+/**
+ * @brief Starts a new slab, linking it to the previous ones.
+ * @param [in] pool The pool to extend.
+ */
+static void
+pool_grow(struct Pool *pool)
+{
+    char *slab = malloc(POOL_SLAB);
+    *(void **) slab = pool->slabs;
+    pool->slabs = slab;
+    pool->next = slab + POOL_GRAIN;
+    pool->end = slab + POOL_SLAB;
+}
+
+/**
+ * @brief Creates an empty pool.
+ * @return The new pool.
+ */
+struct Pool *
+pool_init(void)
+{
+    struct Pool *pool = malloc(sizeof(struct Pool));
+    memset(pool->free, 0, sizeof(pool->free));
+    pool->slabs = NULL;
+    pool->next = NULL;
+    pool->end = NULL;
+    return pool;
+}
+
+/**
+ * @brief Frees a pool and all of its slabs.
+ * @details Any blocks still in use become invalid; blocks larger than the
+ * biggest size class must have been released beforehand.
+ * @param [in] pool The pool to be freed.
+ */
+void
+pool_destroy(struct Pool *pool)
+{
+    void *slab = pool->slabs;
+    while (slab != NULL) {
+        void *prev = *(void **) slab;
+        free(slab);
+        slab = prev;
+    }
+    free(pool);
+}
+
+/**
+ * @brief Takes a block from a pool without any locking.
+ * @param [in] pool The pool to allocate from.
+ * @param [in] size The number of bytes to allocate.
+ * @return Pointer to the block.
+ */
+static void *
+pool_take(struct Pool *pool, const size_t size)
+{
+    const size_t class = pool_class(size);
+    char *block = NULL;
+    if (class == POOL_LARGE) {
+        block = malloc(POOL_GRAIN + size);
+    } else if (pool->free[class] != NULL) {
+        block = (char *) pool->free[class] - POOL_GRAIN;
+        pool->free[class] = *(void **) pool->free[class];
+    } else {
+        const size_t bytes = POOL_GRAIN * (class + 2);
+        if (pool->next == NULL || (size_t) (pool->end - pool->next) < bytes) {
+            pool_grow(pool);
+        }
+        block = pool->next;
+        pool->next += bytes;
+    }
+    *(size_t *) block = class;
+    return block + POOL_GRAIN;
+}
+
+/**
+ * @brief Returns a block to a pool without any locking.
+ * @param [in] pool The pool the block was allocated from.
+ * @param [in] ptr Pointer to the block.
+ */
+static void
+pool_give(struct Pool *pool, void *ptr)
+{
+    char *block = (char *) ptr - POOL_GRAIN;
+    const size_t class = *(size_t *) block;
+    if (class == POOL_LARGE) {
+        free(block);
+    } else if (class != POOL_MAPPED) {
+        *(void **) ptr = pool->free[class];
+        pool->free[class] = ptr;
+    }
+}
+
+/**
+ * @brief Allocates a block of memory from a pool.
+ * @details The block is aligned to POOL_GRAIN bytes and its contents are
+ * uninitialised.
+ * @param [in] pool The pool to allocate from.
+ * @param [in] size The number of bytes to allocate.
+ * @return Pointer to the block.
+ */
+void *
+pool_malloc(struct Pool *pool, const size_t size)
+{
+#ifdef PARALLEL
+    if (omp_in_parallel()) {
+        void *ptr = NULL;
+    #pragma omp critical(pool)
+        ptr = pool_take(pool, size);
+        return ptr;
+    }
+#endif
+    return pool_take(pool, size);
+}
+
+/**
+ * @brief Allocates a zero-initialised array from a pool.
+ * @param [in] pool The pool to allocate from.
+ * @param [in] n The number of elements.
+ * @param [in] size The size of each element.
+ * @return Pointer to the array.
+ */
+void *
+pool_calloc(struct Pool *pool, const size_t n, const size_t size)
+{
+    void *ptr = pool_malloc(pool, n * size);
+    memset(ptr, 0, n * size);
+    return ptr;
+}
+
+/**
+ * @brief Returns a block to the pool it was allocated from.
+ * @param [in] pool The pool the block was allocated from.
+ * @param [in] ptr Pointer to the block; may be NULL.
+ */
+void
+pool_free(struct Pool *pool, void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+#ifdef PARALLEL
+    if (omp_in_parallel()) {
+    #pragma omp critical(pool)
+        pool_give(pool, ptr);
+        return;
+    }
+#endif
+    pool_give(pool, ptr);
+}
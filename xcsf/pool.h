@@ -0,0 +1,67 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pool.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Slab allocator for classifiers and their payloads.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#define POOL_GRAIN (16) //!< Size class granularity and block alignment
+#define POOL_CLASSES (128) //!< Number of pooled size classes
+#define POOL_SLAB (65536) //!< Bytes requested from the heap per slab
+#define POOL_MAPPED (POOL_CLASSES + 1) //!< Class of blocks in a mapped file
+
+/**
+ * @brief Size-class pool of small fixed-size blocks.
+ * @details Blocks are carved from large slabs with a bump pointer and
+ * returned to a free list for their size class when released, so the
+ * classifiers created and destroyed by the EA recycle the same memory
+ * rather than going through the general purpose heap. Each block is preceded
+ * by a header recording its size class so that it can be released without
+ * the caller supplying the size. Requests larger than the biggest class are
+ * passed through to the heap. Slabs are only returned when the pool is
+ * destroyed. Blocks tagged POOL_MAPPED live inside a memory-mapped snapshot
+ * and are left alone when released. Calls made from inside an OpenMP
+ * parallel region are serialised with a critical section; calls outside take
+ * no lock.
+ */
+struct Pool {
+    void *free[POOL_CLASSES]; //!< Free list of released blocks per class
+    void *slabs; //!< Most recently allocated slab, linked to older ones
+    char *next; //!< Next unused byte in the current slab
+    char *end; //!< End of the current slab
+};
+
+struct Pool *
+pool_init(void);
+
+void
+pool_destroy(struct Pool *pool);
+
+void *
+pool_malloc(struct Pool *pool, const size_t size);
+
+void *
+pool_calloc(struct Pool *pool, const size_t n, const size_t size);
+
+void
+pool_free(struct Pool *pool, void *ptr);
@@ -35,6 +35,19 @@
 #include "neural_layer_upsample.h"
 #include "utils.h"
 
+/**
+ * @brief Initialises an empty mini-batch buffer.
+ * @param [in] pred The neural prediction whose buffer is to be initialised.
+ */
+static void
+pred_neural_batch_init(struct PredNeural *pred)
+{
+    pred->batch_x = NULL;
+    pred->batch_y = NULL;
+    pred->batch_n = 0;
+    pred->batch_max = 0;
+}
+
 /**
  * @brief Creates and initialises a neural network prediction.
  * @details Uses fully-connected layers.
@@ -46,6 +59,7 @@ pred_neural_init(const struct XCSF *xcsf, struct Cl *c)
 {
     struct PredNeural *new = malloc(sizeof(struct PredNeural));
     neural_create(&new->net, xcsf->pred->largs);
+    pred_neural_batch_init(new);
     c->pred = new;
 }
 
@@ -60,6 +74,8 @@ pred_neural_free(const struct XCSF *xcsf, const struct Cl *c)
     (void) xcsf;
     struct PredNeural *pred = c->pred;
     neural_free(&pred->net);
+    free(pred->batch_x);
+    free(pred->batch_y);
     free(pred);
 }
 
@@ -76,11 +92,18 @@ pred_neural_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
     struct PredNeural *new = malloc(sizeof(struct PredNeural));
     const struct PredNeural *src_pred = src->pred;
     neural_copy(&new->net, &src_pred->net);
+    pred_neural_batch_init(new);
     dest->pred = new;
 }
 
 /**
  * @brief Backward propagates and updates a neural network prediction.
+ * @details With a batch size greater than one, the samples are buffered and
+ * the network is updated with their average gradient once the batch is full.
+ * Rules with less experience than the batch size are updated after each
+ * sample so that young rules adapt quickly to their niche. Networks with
+ * recurrent or LSTM layers are always updated after each sample since
+ * replaying the buffered samples would advance their state.
  * @pre The prediction has been forward propagated for the current state.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c Classifier whose prediction is to be updated.
@@ -91,9 +114,29 @@ void
 pred_neural_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
                    const double *y)
 {
-    (void) xcsf;
-    const struct PredNeural *pred = c->pred;
-    neural_learn(&pred->net, y, x);
+    struct PredNeural *pred = c->pred;
+    const int batch = xcsf->pred->batch_size;
+    if (batch < 2 || c->exp < batch || neural_stateful(&pred->net)) {
+        neural_learn(&pred->net, y, x);
+        return;
+    }
+    if (batch > pred->batch_max) {
+        pred->batch_x =
+            realloc(pred->batch_x, sizeof(double) * batch * xcsf->x_dim);
+        pred->batch_y =
+            realloc(pred->batch_y, sizeof(double) * batch * xcsf->y_dim);
+        pred->batch_max = batch;
+    }
+    memcpy(&pred->batch_x[pred->batch_n * xcsf->x_dim], x,
+           sizeof(double) * xcsf->x_dim);
+    memcpy(&pred->batch_y[pred->batch_n * xcsf->y_dim], y,
+           sizeof(double) * xcsf->y_dim);
+    ++pred->batch_n;
+    if (pred->batch_n >= batch) {
+        neural_learn_batch(&pred->net, pred->batch_y, pred->batch_x,
+                           pred->batch_n);
+        pred->batch_n = 0;
+    }
 }
 
 /**
@@ -201,6 +244,7 @@ pred_neural_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     (void) xcsf;
     struct PredNeural *new = malloc(sizeof(struct PredNeural));
     size_t s = neural_load(&new->net, fp);
+    pred_neural_batch_init(new);
     c->pred = new;
     return s;
 }
@@ -466,6 +510,13 @@ pred_neural_param_json_import(struct XCSF *xcsf, cJSON *json)
 {
     layer_args_free(&xcsf->pred->largs);
     for (cJSON *iter = json; iter != NULL; iter = iter->next) {
+        if (strncmp(iter->string, "batch_size\0", 11) == 0) {
+            if (!cJSON_IsNumber(iter)) {
+                return iter->string;
+            }
+            pred_param_set_batch_size(xcsf, iter->valueint);
+            continue;
+        }
         struct ArgsLayer *larg = malloc(sizeof(struct ArgsLayer));
         layer_args_init(larg);
         larg->n_inputs = xcsf->x_dim;
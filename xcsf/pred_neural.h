@@ -34,6 +34,10 @@
  */
 struct PredNeural {
     struct Net net; //!< Neural network
+    double *batch_x; //!< Input states awaiting a mini-batch update
+    double *batch_y; //!< Truth values awaiting a mini-batch update
+    int batch_n; //!< Number of samples awaiting a mini-batch update
+    int batch_max; //!< Number of samples the mini-batch buffers can hold
 };
 
 void
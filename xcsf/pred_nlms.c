@@ -23,10 +23,11 @@
 
 #include "pred_nlms.h"
 #include "blas.h"
+#include "pool.h"
 #include "sam.h"
 #include "utils.h"
 
-#define N_MU (1) //!< Number of self-adaptive mutation rates
+#define N_MU (PRED_NLMS_N_MU) //!< Number of mutation rates
 
 /**
  * @brief Self-adaptation method for mutating NLMS predictions.
@@ -43,7 +44,7 @@ static const int MU_TYPE[N_MU] = {
 void
 pred_nlms_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct PredNLMS *pred = malloc(sizeof(struct PredNLMS));
+    struct PredNLMS *pred = pool_malloc(xcsf->pool, sizeof(struct PredNLMS));
     c->pred = pred;
     // set the length of weights per predicted variable
     if (xcsf->pred->type == PRED_TYPE_NLMS_QUADRATIC) {
@@ -54,10 +55,10 @@ pred_nlms_init(const struct XCSF *xcsf, struct Cl *c)
     }
     // initialise weights
     pred->n_weights = pred->n * xcsf->y_dim;
-    pred->weights = calloc(pred->n_weights, sizeof(double));
+    pred->weights = pool_calloc(xcsf->pool, pred->n_weights, sizeof(double));
     blas_fill(xcsf->y_dim, xcsf->pred->x0, pred->weights, pred->n);
     // initialise learning rate
-    pred->mu = malloc(sizeof(double) * N_MU);
+    pred->mu = pool_malloc(xcsf->pool, sizeof(double) * N_MU);
     if (xcsf->pred->evolve_eta) {
         sam_init(pred->mu, N_MU, MU_TYPE);
         pred->eta = rand_uniform(xcsf->pred->eta_min, xcsf->pred->eta);
@@ -66,7 +67,7 @@ pred_nlms_init(const struct XCSF *xcsf, struct Cl *c)
         pred->eta = xcsf->pred->eta;
     }
     // initialise temporary storage for weight updating
-    pred->tmp_input = malloc(sizeof(double) * pred->n);
+    pred->tmp_input = pool_malloc(xcsf->pool, sizeof(double) * pred->n);
 }
 
 /**
@@ -95,12 +96,11 @@ pred_nlms_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 void
 pred_nlms_free(const struct XCSF *xcsf, const struct Cl *c)
 {
-    (void) xcsf;
     struct PredNLMS *pred = c->pred;
-    free(pred->weights);
-    free(pred->tmp_input);
-    free(pred->mu);
-    free(pred);
+    pool_free(xcsf->pool, pred->weights);
+    pool_free(xcsf->pool, pred->tmp_input);
+    pool_free(xcsf->pool, pred->mu);
+    pool_free(xcsf->pool, pred);
 }
 
 /**
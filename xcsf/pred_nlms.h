@@ -26,6 +26,8 @@
 #include "prediction.h"
 #include "xcsf.h"
 
+#define PRED_NLMS_N_MU (1) //!< Number of NLMS prediction mutation rates
+
 /**
  * @brief Normalised least mean squares prediction data structure.
  */
@@ -23,6 +23,7 @@
 
 #include "pred_rls.h"
 #include "blas.h"
+#include "pool.h"
 #include "utils.h"
 
 /**
@@ -33,7 +34,7 @@
 void
 pred_rls_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct PredRLS *pred = malloc(sizeof(struct PredRLS));
+    struct PredRLS *pred = pool_malloc(xcsf->pool, sizeof(struct PredRLS));
     c->pred = pred;
     // set the length of weights per predicted variable
     if (xcsf->pred->type == PRED_TYPE_RLS_QUADRATIC) {
@@ -44,19 +45,18 @@ pred_rls_init(const struct XCSF *xcsf, struct Cl *c)
     }
     // initialise weights
     pred->n_weights = pred->n * xcsf->y_dim;
-    pred->weights = calloc(pred->n_weights, sizeof(double));
+    pred->weights = pool_calloc(xcsf->pool, pred->n_weights, sizeof(double));
     blas_fill(xcsf->y_dim, xcsf->pred->x0, pred->weights, pred->n);
     // initialise gain matrix
     const int n_sqrd = pred->n * pred->n;
-    pred->matrix = calloc(n_sqrd, sizeof(double));
+    pred->matrix = pool_calloc(xcsf->pool, n_sqrd, sizeof(double));
     for (int i = 0; i < pred->n; ++i) {
         pred->matrix[i * pred->n + i] = xcsf->pred->scale_factor;
     }
     // initialise temporary storage for weight updating
-    pred->tmp_input = malloc(sizeof(double) * pred->n);
-    pred->tmp_vec = calloc(pred->n, sizeof(double));
-    pred->tmp_matrix1 = calloc(n_sqrd, sizeof(double));
-    pred->tmp_matrix2 = calloc(n_sqrd, sizeof(double));
+    pred->tmp_input = pool_malloc(xcsf->pool, sizeof(double) * pred->n);
+    pred->tmp_vec = pool_calloc(xcsf->pool, pred->n, sizeof(double));
+    pred->tmp_row = pool_calloc(xcsf->pool, pred->n, sizeof(double));
 }
 
 /**
@@ -83,15 +83,13 @@ pred_rls_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 void
 pred_rls_free(const struct XCSF *xcsf, const struct Cl *c)
 {
-    (void) xcsf;
     struct PredRLS *pred = c->pred;
-    free(pred->weights);
-    free(pred->matrix);
-    free(pred->tmp_input);
-    free(pred->tmp_vec);
-    free(pred->tmp_matrix1);
-    free(pred->tmp_matrix2);
-    free(pred);
+    pool_free(xcsf->pool, pred->weights);
+    pool_free(xcsf->pool, pred->matrix);
+    pool_free(xcsf->pool, pred->tmp_input);
+    pool_free(xcsf->pool, pred->tmp_vec);
+    pool_free(xcsf->pool, pred->tmp_row);
+    pool_free(xcsf->pool, pred);
 }
 
 /**
@@ -123,27 +121,18 @@ pred_rls_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
         const double error = y[i] - c->prediction[i];
         blas_axpy(n, error, pred->tmp_vec, 1, &pred->weights[i * n], 1);
     }
-    // update gain matrix
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < n; ++j) {
-            const double tmp = pred->tmp_vec[i] * pred->tmp_input[j];
-            if (i == j) {
-                pred->tmp_matrix1[i * n + j] = 1 - tmp;
-            } else {
-                pred->tmp_matrix1[i * n + j] = -tmp;
-            }
-        }
-    }
-    // tmp_matrix2 = tmp_matrix1 * pred_matrix
-    A = pred->tmp_matrix1;
+    // update gain matrix with the rank-1 update (matrix - gain * row) / lambda
+    // where row = tmp_input' * matrix
+    A = pred->tmp_input;
     B = pred->matrix;
-    C = pred->tmp_matrix2;
-    blas_gemm(0, 0, n, n, n, 1, A, n, B, n, 0, C, n);
-    // divide gain matrix entries by lambda
+    C = pred->tmp_row;
+    blas_gemm(0, 0, 1, n, n, 1, A, n, B, n, 0, C, n);
     const double lambda = xcsf->pred->lambda;
     for (int i = 0; i < n; ++i) {
+        const double gain = pred->tmp_vec[i];
+        double *row = &pred->matrix[i * n];
         for (int j = 0; j < n; ++j) {
-            pred->matrix[i * n + j] = pred->tmp_matrix2[i * n + j] / lambda;
+            row[j] = (row[j] - gain * pred->tmp_row[j]) / lambda;
         }
     }
 }
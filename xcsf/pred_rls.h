@@ -36,8 +36,7 @@ struct PredRLS {
     double *matrix; //!< Gain matrix used to update weights
     double *tmp_input; //!< Temporary storage for updating weights
     double *tmp_vec; //!< Temporary storage for updating weights
-    double *tmp_matrix1; //!< Temporary storage for updating gain matrix
-    double *tmp_matrix2; //!< Temporary storage for updating gain matrix
+    double *tmp_row; //!< Temporary storage for updating gain matrix
 };
 
 char *
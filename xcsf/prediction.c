@@ -126,6 +126,7 @@ pred_param_defaults(struct XCSF *xcsf)
     pred_param_set_scale_factor(xcsf, 1000);
     pred_param_set_x0(xcsf, 1);
     pred_param_set_evolve_eta(xcsf, true);
+    pred_param_set_batch_size(xcsf, 1);
     pred_neural_param_defaults(xcsf);
 }
 
@@ -160,6 +161,9 @@ pred_param_json_export(const struct XCSF *xcsf)
     if (json_str != NULL) {
         cJSON *params = cJSON_Parse(json_str);
         if (params != NULL) {
+            if (pred->type == PRED_TYPE_NEURAL) {
+                cJSON_AddNumberToObject(params, "batch_size", pred->batch_size);
+            }
             cJSON_AddItemToObject(json, "args", params);
         }
         free(json_str);
@@ -218,6 +222,7 @@ pred_param_save(const struct XCSF *xcsf, FILE *fp)
     s += fwrite(&pred->scale_factor, sizeof(double), 1, fp);
     s += fwrite(&pred->x0, sizeof(double), 1, fp);
     s += fwrite(&pred->evolve_eta, sizeof(bool), 1, fp);
+    s += fwrite(&pred->batch_size, sizeof(int), 1, fp);
     s += layer_args_save(pred->largs, fp);
     return s;
 }
@@ -240,6 +245,7 @@ pred_param_load(struct XCSF *xcsf, FILE *fp)
     s += fread(&pred->scale_factor, sizeof(double), 1, fp);
     s += fread(&pred->x0, sizeof(double), 1, fp);
     s += fread(&pred->evolve_eta, sizeof(bool), 1, fp);
+    s += fread(&pred->batch_size, sizeof(int), 1, fp);
     s += layer_args_load(&pred->largs, fp);
     return s;
 }
@@ -339,6 +345,17 @@ pred_param_set_evolve_eta(struct XCSF *xcsf, const bool a)
     xcsf->pred->evolve_eta = a;
 }
 
+void
+pred_param_set_batch_size(struct XCSF *xcsf, const int a)
+{
+    if (a < 1) {
+        printf("Warning: tried to set PRED BATCH_SIZE too small\n");
+        xcsf->pred->batch_size = 1;
+    } else {
+        xcsf->pred->batch_size = a;
+    }
+}
+
 void
 pred_param_set_type(struct XCSF *xcsf, const int a)
 {
@@ -55,6 +55,7 @@ struct ArgsPred {
     double lambda; //!< RLS forget rate
     double scale_factor; //!< Initial values for the RLS gain-matrix
     double x0; //!< Prediction weight vector offset value
+    int batch_size; //!< Number of samples per neural gradient descent update
     struct ArgsLayer *largs; //!< Linked-list of layer parameters
 };
 
@@ -307,6 +308,9 @@ pred_param_set_x0(struct XCSF *xcsf, const double a);
 void
 pred_param_set_evolve_eta(struct XCSF *xcsf, const bool a);
 
+void
+pred_param_set_batch_size(struct XCSF *xcsf, const int a);
+
 void
 pred_param_set_type(struct XCSF *xcsf, const int a);
 
@@ -26,6 +26,7 @@
     #define _hypot hypot
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <fstream>
@@ -48,6 +49,8 @@ extern "C" {
 #include "ea.h"
 #include "param.h"
 #include "prediction.h"
+#include "snapshot.h"
+#include "stream.h"
 #include "utils.h"
 #include "xcs_rl.h"
 #include "xcs_supervised.h"
@@ -58,6 +61,109 @@ extern "C" {
 #include "pybind_callback_earlystop.h"
 #include "pybind_utils.h"
 
+/**
+ * @brief Data source reading batches of rows from a Python iterator.
+ */
+struct StreamPy {
+    py::iterator it; //!< Iterator yielding (X, y) batches
+    py::array_t<double> x; //!< Feature variables of the current batch
+    py::array_t<double> y; //!< Target variables of the current batch
+    py::ssize_t n; //!< Number of rows in the current batch
+    py::ssize_t pos; //!< Next row of the current batch
+    int x_dim; //!< Number of feature variables
+    int y_dim; //!< Number of target variables
+    std::string error; //!< Message of any exception raised while reading
+};
+
+/**
+ * @brief Reads the next rows from a Python iterator of (X, y) batches.
+ * @details Called from the stream reading thread, which takes the GIL only
+ * while reading. Any exception ends the stream and is recorded.
+ * @param [in] ctx The Python source.
+ * @param [out] x Space for max_rows rows of feature variables.
+ * @param [out] y Space for max_rows rows of target variables.
+ * @param [in] max_rows The maximum number of rows to read.
+ * @return The number of rows read.
+ */
+static int
+stream_py_read(void *ctx, double *x, double *y, const int max_rows)
+{
+    StreamPy *src = static_cast<StreamPy *>(ctx);
+    py::gil_scoped_acquire acquire;
+    int n = 0;
+    try {
+        while (n < max_rows) {
+            if (src->pos >= src->n) {
+                if (src->it == py::iterator::sentinel()) {
+                    break;
+                }
+                const py::tuple batch = (*src->it).cast<py::tuple>();
+                ++src->it;
+                src->x = batch[0].cast<py::array_t<
+                    double, py::array::c_style | py::array::forcecast>>();
+                src->y = batch[1].cast<py::array_t<
+                    double, py::array::c_style | py::array::forcecast>>();
+                src->n = src->x.size() / src->x_dim;
+                src->pos = 0;
+                if (src->x.size() != src->n * src->x_dim ||
+                    src->y.size() != src->n * src->y_dim) {
+                    std::ostringstream err;
+                    err << "stream batch shapes must be: (n_samples, "
+                        << src->x_dim << ") and (n_samples, " << src->y_dim
+                        << ")" << std::endl;
+                    throw std::invalid_argument(err.str());
+                }
+            }
+            const py::ssize_t k =
+                std::min((py::ssize_t) (max_rows - n), src->n - src->pos);
+            const double *bx = src->x.data() + src->pos * src->x_dim;
+            const double *by = src->y.data() + src->pos * src->y_dim;
+            std::copy(bx, bx + k * src->x_dim, x + n * src->x_dim);
+            std::copy(by, by + k * src->y_dim, y + n * src->y_dim);
+            src->pos += k;
+            n += (int) k;
+        }
+    } catch (const std::exception &e) {
+        src->error = e.what();
+        return 0;
+    }
+    return n;
+}
+
+/**
+ * @brief Stops and frees a stream when it leaves scope.
+ * @details Ensures the reading thread and buffers are released even when an
+ * exception is raised while learning from the stream.
+ */
+class StreamGuard
+{
+  public:
+    /**
+     * @brief Takes ownership of an initialised stream.
+     * @param [in] stream The stream to free on destruction.
+     */
+    explicit StreamGuard(struct Stream *stream) : stream(stream)
+    {
+    }
+
+    /**
+     * @brief Frees the stream, releasing the GIL so that the reading thread
+     * can finish any read in progress.
+     */
+    ~StreamGuard()
+    {
+        py::gil_scoped_release release;
+        stream_free(stream);
+    }
+
+    StreamGuard(const StreamGuard &) = delete;
+    StreamGuard &
+    operator=(const StreamGuard &) = delete;
+
+  private:
+    struct Stream *stream; //!< The stream to free
+};
+
 /**
  * @brief Python XCSF class data structure.
  */
@@ -152,6 +258,30 @@ class XCS
         return s;
     }
 
+    /**
+     * @brief Writes the current state of XCSF to a snapshot file.
+     * @param [in] filename String containing the name of the output file.
+     * @return The number of bytes written.
+     */
+    size_t
+    save_snapshot(const char *filename)
+    {
+        return snapshot_save(&xcs, filename);
+    }
+
+    /**
+     * @brief Maps the state of XCSF from a snapshot file.
+     * @param [in] filename String containing the name of the input file.
+     * @return The number of bytes mapped.
+     */
+    size_t
+    load_snapshot(const char *filename)
+    {
+        size_t s = snapshot_load(&xcs, filename);
+        update_params();
+        return s;
+    }
+
     /**
      * @brief Stores the current population in memory for later retrieval.
      */
@@ -408,7 +538,10 @@ class XCS
     void
     update_metrics(const double train, const double val, const int n_trials)
     {
-        const int trial = (1 + metric_counter) * n_trials;
+        int trial = n_trials;
+        if (metric_counter > 0) {
+            trial += py::cast<int>(metric_trial[metric_trial.size() - 1]);
+        }
         metric_train.append(train);
         metric_val.append(val);
         metric_trial.append(trial);
@@ -533,6 +666,70 @@ class XCS
         return *this;
     }
 
+    /**
+     * @brief Executes at most MAX_TRIALS learning iterations over rows read
+     * from an iterator of batches that need not fit in memory together.
+     * @param [in] source Iterable yielding (X, y) tuples of batches.
+     * @param [in] chunk_size The number of rows buffered at a time.
+     * @param [in] window The number of rows to shuffle within; 0 for none.
+     * @param [in] warm_start Whether to continue with existing population.
+     * @param [in] verbose Whether to print learning metrics.
+     * @return The fitted XCSF model.
+     */
+    XCS &
+    fit_stream(const py::iterable source, const int chunk_size,
+               const int window, const bool warm_start, const bool verbose)
+    {
+        if (chunk_size < 1 || window < 0) {
+            std::ostringstream err;
+            err << "chunk_size must be positive and window non-negative"
+                << std::endl;
+            throw std::invalid_argument(err.str());
+        }
+        if (!warm_start) { // re-initialise XCSF as necessary
+            xcsf_free(&xcs);
+            xcsf_init(&xcs);
+        }
+        StreamPy src;
+        src.it = py::iter(source);
+        src.n = 0;
+        src.pos = 0;
+        src.x_dim = xcs.x_dim;
+        src.y_dim = xcs.y_dim;
+        struct Stream stream;
+        stream_init(&stream, xcs.x_dim, xcs.y_dim, chunk_size, window,
+                    stream_py_read, &src);
+        {
+            StreamGuard guard(&stream);
+            // break up the learning into epochs to track metrics
+            const int n = ceil(xcs.MAX_TRIALS / (double) xcs.PERF_TRIALS);
+            const int n_trials = std::min(xcs.MAX_TRIALS, xcs.PERF_TRIALS);
+            for (int i = 0; i < n; ++i) {
+                double train = 0;
+                int done = 0;
+                {
+                    py::gil_scoped_release release;
+                    train = xcs_supervised_fit_stream(&xcs, &stream, NULL,
+                                                      false, n_trials, &done);
+                }
+                if (done < 1) {
+                    break;
+                }
+                update_metrics(train, 0, done);
+                if (verbose) {
+                    print_status();
+                }
+                if (done < n_trials) { // the stream is exhausted
+                    break;
+                }
+            }
+        }
+        if (!src.error.empty()) {
+            throw std::runtime_error(src.error);
+        }
+        return *this;
+    }
+
     /**
      * @brief Returns the values specified in the cover array.
      * @param [in] cover The values to return for covering.
@@ -628,52 +825,39 @@ class XCS
 
     /**
      * @brief Implements pickle file writing.
-     * @details Uses a temporary binary file.
+     * @details Serialises directly into a memory buffer.
      * @return The pickled XCSF.
      */
     py::bytes
     serialize() const
     {
-        // Write XCSF to a temporary binary file
-        const char *filename = "_tmp_pickle.bin";
-        xcsf_save(&xcs, filename);
-        // Read the binary file into bytes
-        std::ifstream file(filename, std::ios::binary);
-        std::string state((std::istreambuf_iterator<char>(file)),
-                          std::istreambuf_iterator<char>());
-        file.close();
-        // Delete the temporary file
-        if (std::remove(filename) != 0) {
-            perror("Error deleting temporary pickle file");
-        }
-        // Return the binary data as bytes
-        return py::bytes(state);
+        char *buf = NULL;
+        size_t len = 0;
+        xcsf_save_buffer(&xcs, &buf, &len);
+        py::bytes state(buf, len);
+        free(buf);
+        return state;
     }
 
     /**
      * @brief Implements pickle file reading.
-     * @details Uses a temporary binary file.
+     * @details Deserialises directly from the bytes object without copying.
      * @param state The pickled state of a saved XCSF.
      */
     static XCS
     deserialize(const py::bytes &state)
     {
-        // Write the XCSF bytes to a temporary binary file
-        const char *filename = "_tmp_pickle.bin";
-        std::ofstream file(filename, std::ios::binary);
-        file.write(state.cast<std::string>().c_str(),
-                   state.cast<std::string>().size());
-        file.close();
+        char *buf = NULL;
+        Py_ssize_t len = 0;
+        if (PyBytes_AsStringAndSize(state.ptr(), &buf, &len) != 0) {
+            throw py::error_already_set();
+        }
         // Create a new XCSF instance
         XCS xcs = XCS();
         // Load XCSF
-        xcsf_load(&xcs.xcs, filename);
+        xcsf_load_buffer(&xcs.xcs, buf, (size_t) len);
         // Update object params
         xcs.update_params();
-        // Delete the temporary file
-        if (std::remove(filename) != 0) {
-            perror("Error deleting temporary pickle file");
-        }
         // Return the deserialized XCSF
         return xcs;
     }
@@ -805,7 +989,7 @@ class XCS
     const char *
     json_export(const bool condition, const bool action, const bool prediction)
     {
-        if (xcs.pset.list != NULL) {
+        if (xcs.pset.size > 0) {
             return clset_json_export(&xcs, &xcs.pset, condition, action,
                                      prediction);
         }
@@ -988,6 +1172,16 @@ PYBIND11_MODULE(xcsf, m)
              py::arg("X_train"), py::arg("y_train"), py::arg("shuffle") = true,
              py::arg("warm_start") = false, py::arg("verbose") = true,
              py::arg("callbacks") = py::none())
+        .def("fit_stream", &XCS::fit_stream,
+             "Executes at most MAX_TRIALS number of XCSF learning iterations "
+             "over an iterable of (X, y) batches read in chunks by a "
+             "background thread, stopping early if it is exhausted. X shape "
+             "must be: (n_samples, x_dim). y shape must be: (n_samples, "
+             "y_dim). window > 0 shuffles rows within a reservoir of that "
+             "size.",
+             py::arg("source"), py::arg("chunk_size") = 1024,
+             py::arg("window") = 0, py::arg("warm_start") = false,
+             py::arg("verbose") = true)
         .def(
             "score", &XCS::score,
             "Returns the error using at most N random samples from the "
@@ -1016,6 +1210,13 @@ PYBIND11_MODULE(xcsf, m)
         .def("load", &XCS::load,
              "Loads the current state of XCSF from persistent storage.",
              py::arg("filename"))
+        .def("save_snapshot", &XCS::save_snapshot,
+             "Saves the current state of XCSF to a memory-mappable snapshot.",
+             py::arg("filename"))
+        .def("load_snapshot", &XCS::load_snapshot,
+             "Loads the current state of XCSF from a snapshot, sharing the "
+             "file's pages where possible.",
+             py::arg("filename"))
         .def("store", &XCS::store,
              "Stores the current XCSF population in memory for later "
              "retrieval, overwriting any previously stored population.")
@@ -0,0 +1,575 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file snapshot.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Memory-mappable population snapshots.
+ * @details The file is mapped copy-on-write, so worker processes loading the
+ * same snapshot share its pages until a classifier array is modified.
+ */
+
+#include "snapshot.h"
+#include "action.h"
+#include "blas.h"
+#include "cl.h"
+#include "clset.h"
+#include "clset_del.h"
+#include "clset_soa.h"
+#include "clset_stats.h"
+#include "cond_ellipsoid.h"
+#include "cond_rectangle.h"
+#include "condition.h"
+#include "param.h"
+#include "pool.h"
+#include "pred_nlms.h"
+#include "pred_rls.h"
+#include "prediction.h"
+#include "utils.h"
+
+static const char SNAPSHOT_MAGIC[8] = "XCSFSNAP"; //!< File signature
+static const uint32_t SNAPSHOT_ENDIAN = 0x01020304; //!< Byte order mark
+
+/**
+ * @brief Returns whether conditions are stored as mapped arrays.
+ * @param [in] xcsf The XCSF data structure.
+ * @return Whether the condition type is an interval representation.
+ */
+static bool
+snapshot_cond_blocks(const struct XCSF *xcsf)
+{
+    return xcsf->cond->type == COND_TYPE_HYPERRECTANGLE_CSR ||
+        xcsf->cond->type == COND_TYPE_HYPERRECTANGLE_UBR ||
+        xcsf->cond->type == COND_TYPE_HYPERELLIPSOID;
+}
+
+/**
+ * @brief Returns whether predictions are stored as mapped arrays.
+ * @param [in] xcsf The XCSF data structure.
+ * @return Whether the prediction type is a least squares representation.
+ */
+static bool
+snapshot_pred_blocks(const struct XCSF *xcsf)
+{
+    return xcsf->pred->type == PRED_TYPE_NLMS_LINEAR ||
+        xcsf->pred->type == PRED_TYPE_NLMS_QUADRATIC ||
+        xcsf->pred->type == PRED_TYPE_RLS_LINEAR ||
+        xcsf->pred->type == PRED_TYPE_RLS_QUADRATIC;
+}
+
+/**
+ * @brief Rounds an offset up to the snapshot alignment.
+ * @param [in] offset The byte offset.
+ * @return The aligned offset.
+ */
+static size_t
+snapshot_align(const size_t offset)
+{
+    return (offset + SNAPSHOT_ALIGN - 1) & ~((size_t) SNAPSHOT_ALIGN - 1);
+}
+
+/**
+ * @brief Writes zeros until the stream reaches a given offset.
+ * @param [in] fp Pointer to the output file.
+ * @param [in] offset The offset to advance to.
+ */
+static void
+snapshot_pad(FILE *fp, const size_t offset)
+{
+    static const char zeros[SNAPSHOT_ALIGN] = { 0 };
+    const size_t pos = (size_t) ftell(fp);
+    fwrite(zeros, 1, offset - pos, fp);
+}
+
+/**
+ * @brief Writes an array preceded by a mapped pool block header.
+ * @details The array starts on an aligned offset so that it may be used in
+ * place once the file is mapped.
+ * @param [in] fp Pointer to the output file.
+ * @param [in] data The array to write.
+ * @param [in] n The number of doubles in the array.
+ */
+static void
+snapshot_write_block(FILE *fp, const double *data, const int n)
+{
+    const size_t pos = (size_t) ftell(fp);
+    snapshot_pad(fp, snapshot_align(pos + POOL_GRAIN) - POOL_GRAIN);
+    size_t header[POOL_GRAIN / sizeof(size_t)] = { 0 };
+    header[0] = POOL_MAPPED;
+    header[1] = sizeof(double) * n;
+    fwrite(header, POOL_GRAIN, 1, fp);
+    fwrite(data, sizeof(double), n, fp);
+}
+
+/**
+ * @brief Returns the next mapped array of a blocks section.
+ * @param [in] base Start of the mapped file.
+ * @param [in,out] pos Offset of the end of the previous array.
+ * @param [in] end Offset of the end of the section.
+ * @param [in] n The number of doubles expected, or zero for any.
+ * @param [out] len The number of doubles in the array.
+ * @return Pointer to the array inside the mapping.
+ */
+static double *
+snapshot_read_block(char *base, size_t *pos, const size_t end, const int n,
+                    int *len)
+{
+    const size_t start = snapshot_align(*pos + POOL_GRAIN);
+    if (start > end) {
+        printf("Error loading snapshot: truncated section\n");
+        exit(EXIT_FAILURE);
+    }
+    const size_t *header = (const size_t *) (base + start - POOL_GRAIN);
+    const size_t bytes = header[1];
+    if (header[0] != POOL_MAPPED || bytes > end - start ||
+        (n > 0 && bytes != sizeof(double) * n)) {
+        printf("Error loading snapshot: invalid block\n");
+        exit(EXIT_FAILURE);
+    }
+    *pos = start + bytes;
+    *len = (int) (bytes / sizeof(double));
+    return (double *) (base + start);
+}
+
+/**
+ * @brief Returns a stream reading a section of the mapped file.
+ * @param [in] data Start of the section.
+ * @param [in] size The number of bytes in the section.
+ * @return Pointer to the stream.
+ */
+static FILE *
+snapshot_stream(char *data, const size_t size)
+{
+#ifdef _WIN32
+    FILE *fp = tmpfile();
+    if (fp != 0) {
+        fwrite(data, 1, size, fp);
+        rewind(fp);
+    }
+#else
+    FILE *fp = fmemopen(data, size, "rb");
+#endif
+    if (fp == 0) {
+        printf("Error loading snapshot: %s.\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    return fp;
+}
+
+/**
+ * @brief Writes the conditions of the population as mapped arrays.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] fp Pointer to the output file.
+ */
+static void
+snapshot_save_cond(const struct XCSF *xcsf, FILE *fp)
+{
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        const struct Cl *c = xcsf->pset.cl[i];
+        if (xcsf->cond->type == COND_TYPE_HYPERELLIPSOID) {
+            const struct CondEllipsoid *cond = c->cond;
+            snapshot_write_block(fp, cond->center, xcsf->x_dim);
+            snapshot_write_block(fp, cond->spread, xcsf->x_dim);
+            snapshot_write_block(fp, cond->mu, COND_ELLIPSOID_N_MU);
+        } else {
+            const struct CondRectangle *cond = c->cond;
+            snapshot_write_block(fp, cond->b1, xcsf->x_dim);
+            snapshot_write_block(fp, cond->b2, xcsf->x_dim);
+            snapshot_write_block(fp, cond->mu, COND_RECTANGLE_N_MU);
+        }
+    }
+}
+
+/**
+ * @brief Writes the predictions of the population as mapped arrays.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] fp Pointer to the output file.
+ */
+static void
+snapshot_save_pred(const struct XCSF *xcsf, FILE *fp)
+{
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        const struct Cl *c = xcsf->pset.cl[i];
+        if (xcsf->pred->type == PRED_TYPE_RLS_LINEAR ||
+            xcsf->pred->type == PRED_TYPE_RLS_QUADRATIC) {
+            const struct PredRLS *pred = c->pred;
+            snapshot_write_block(fp, pred->weights, pred->n_weights);
+            snapshot_write_block(fp, pred->matrix, pred->n * pred->n);
+        } else {
+            const struct PredNLMS *pred = c->pred;
+            snapshot_write_block(fp, pred->weights, pred->n_weights);
+            snapshot_write_block(fp, pred->mu, PRED_NLMS_N_MU);
+            snapshot_write_block(fp, &pred->eta, 1);
+        }
+    }
+}
+
+/**
+ * @brief Points the condition of a classifier into the mapped file.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier being loaded.
+ * @param [in] base Start of the mapped file.
+ * @param [in,out] pos Offset of the end of the previous array.
+ * @param [in] end Offset of the end of the section.
+ */
+static void
+snapshot_load_cond(const struct XCSF *xcsf, struct Cl *c, char *base,
+                   size_t *pos, const size_t end)
+{
+    int len = 0;
+    if (xcsf->cond->type == COND_TYPE_HYPERELLIPSOID) {
+        struct CondEllipsoid *cond =
+            pool_malloc(xcsf->pool, sizeof(struct CondEllipsoid));
+        cond->center = snapshot_read_block(base, pos, end, xcsf->x_dim, &len);
+        cond->spread = snapshot_read_block(base, pos, end, xcsf->x_dim, &len);
+        cond->mu = snapshot_read_block(base, pos, end, COND_ELLIPSOID_N_MU,
+                                       &len);
+        c->cond = cond;
+    } else {
+        struct CondRectangle *cond =
+            pool_malloc(xcsf->pool, sizeof(struct CondRectangle));
+        cond->b1 = snapshot_read_block(base, pos, end, xcsf->x_dim, &len);
+        cond->b2 = snapshot_read_block(base, pos, end, xcsf->x_dim, &len);
+        cond->mu = snapshot_read_block(base, pos, end, COND_RECTANGLE_N_MU,
+                                       &len);
+        c->cond = cond;
+    }
+}
+
+/**
+ * @brief Points the prediction of a classifier into the mapped file.
+ * @details Only the temporary storage used for updating is allocated.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier being loaded.
+ * @param [in] base Start of the mapped file.
+ * @param [in,out] pos Offset of the end of the previous array.
+ * @param [in] end Offset of the end of the section.
+ */
+static void
+snapshot_load_pred(const struct XCSF *xcsf, struct Cl *c, char *base,
+                   size_t *pos, const size_t end)
+{
+    int len = 0;
+    if (xcsf->pred->type == PRED_TYPE_RLS_LINEAR ||
+        xcsf->pred->type == PRED_TYPE_RLS_QUADRATIC) {
+        struct PredRLS *pred = pool_malloc(xcsf->pool, sizeof(struct PredRLS));
+        pred->weights = snapshot_read_block(base, pos, end, 0, &len);
+        pred->n_weights = len;
+        pred->n = len / xcsf->y_dim;
+        pred->matrix =
+            snapshot_read_block(base, pos, end, pred->n * pred->n, &len);
+        pred->tmp_input = pool_malloc(xcsf->pool, sizeof(double) * pred->n);
+        pred->tmp_vec = pool_calloc(xcsf->pool, pred->n, sizeof(double));
+        pred->tmp_row = pool_calloc(xcsf->pool, pred->n, sizeof(double));
+        c->pred = pred;
+    } else {
+        struct PredNLMS *pred =
+            pool_malloc(xcsf->pool, sizeof(struct PredNLMS));
+        pred->weights = snapshot_read_block(base, pos, end, 0, &len);
+        pred->n_weights = len;
+        pred->n = len / xcsf->y_dim;
+        pred->mu = snapshot_read_block(base, pos, end, PRED_NLMS_N_MU, &len);
+        pred->eta = *snapshot_read_block(base, pos, end, 1, &len);
+        pred->tmp_input = pool_malloc(xcsf->pool, sizeof(double) * pred->n);
+        c->pred = pred;
+    }
+}
+
+/**
+ * @brief Starts a new section on an aligned offset.
+ * @param [in] fp Pointer to the output file.
+ * @param [in] s The section to start.
+ * @param [in] id The section identifier.
+ * @param [in] encoding How the section contents are laid out.
+ */
+static void
+snapshot_begin(FILE *fp, struct SnapshotSection *s, const uint32_t id,
+               const uint32_t encoding)
+{
+    snapshot_pad(fp, snapshot_align((size_t) ftell(fp)));
+    s->id = id;
+    s->encoding = encoding;
+    s->offset = (uint64_t) ftell(fp);
+}
+
+/**
+ * @brief Ends the current section.
+ * @param [in] fp Pointer to the output file.
+ * @param [in] s The section to end.
+ */
+static void
+snapshot_end(FILE *fp, struct SnapshotSection *s)
+{
+    s->size = (uint64_t) ftell(fp) - s->offset;
+}
+
+/**
+ * @brief Writes the current state of XCSF to a snapshot file.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The name of the output file.
+ * @return The number of bytes written.
+ */
+size_t
+snapshot_save(const struct XCSF *xcsf, const char *filename)
+{
+    FILE *fp = fopen(filename, "wb");
+    if (fp == 0) {
+        printf("Error saving file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    struct SnapshotHeader h;
+    memset(&h, 0, sizeof(struct SnapshotHeader));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.format = SNAPSHOT_FORMAT;
+    h.endian = SNAPSHOT_ENDIAN;
+    h.version[0] = VERSION_MAJOR;
+    h.version[1] = VERSION_MINOR;
+    h.version[2] = VERSION_BUILD;
+    h.n_rules = xcsf->pset.size;
+    h.precision = (int32_t) sizeof(real);
+    fwrite(&h, sizeof(struct SnapshotHeader), 1, fp);
+    struct SnapshotSection *s = h.section;
+    // parameters
+    snapshot_begin(fp, &s[SNAPSHOT_PARAMS], SNAPSHOT_PARAMS, SNAPSHOT_STREAM);
+    param_save(xcsf, fp);
+    snapshot_end(fp, &s[SNAPSHOT_PARAMS]);
+    // fixed-size rule records
+    snapshot_begin(fp, &s[SNAPSHOT_RULES], SNAPSHOT_RULES, SNAPSHOT_RECORDS);
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        const struct Cl *c = xcsf->pset.cl[i];
+        const struct SnapshotRule r = {
+            .err = c->err,
+            .fit = c->fit,
+            .size = c->size,
+            .num = c->num,
+            .exp = c->exp,
+            .time = c->time,
+            .action = c->action,
+            .age = c->age,
+            .mtotal = c->mtotal,
+            .m = c->m,
+            .pad = 0,
+        };
+        fwrite(&r, sizeof(struct SnapshotRule), 1, fp);
+    }
+    snapshot_end(fp, &s[SNAPSHOT_RULES]);
+    // prediction outputs
+    snapshot_begin(fp, &s[SNAPSHOT_OUTPUTS], SNAPSHOT_OUTPUTS,
+                   SNAPSHOT_RECORDS);
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        fwrite(xcsf->pset.cl[i]->prediction, sizeof(double), xcsf->y_dim, fp);
+    }
+    snapshot_end(fp, &s[SNAPSHOT_OUTPUTS]);
+    // conditions
+    if (snapshot_cond_blocks(xcsf)) {
+        snapshot_begin(fp, &s[SNAPSHOT_COND], SNAPSHOT_COND, SNAPSHOT_BLOCKS);
+        snapshot_save_cond(xcsf, fp);
+    } else {
+        snapshot_begin(fp, &s[SNAPSHOT_COND], SNAPSHOT_COND, SNAPSHOT_STREAM);
+        for (int i = 0; i < xcsf->pset.size; ++i) {
+            cond_save(xcsf, xcsf->pset.cl[i], fp);
+        }
+    }
+    snapshot_end(fp, &s[SNAPSHOT_COND]);
+    // predictions
+    if (snapshot_pred_blocks(xcsf)) {
+        snapshot_begin(fp, &s[SNAPSHOT_PRED], SNAPSHOT_PRED, SNAPSHOT_BLOCKS);
+        snapshot_save_pred(xcsf, fp);
+    } else {
+        snapshot_begin(fp, &s[SNAPSHOT_PRED], SNAPSHOT_PRED, SNAPSHOT_STREAM);
+        for (int i = 0; i < xcsf->pset.size; ++i) {
+            pred_save(xcsf, xcsf->pset.cl[i], fp);
+        }
+    }
+    snapshot_end(fp, &s[SNAPSHOT_PRED]);
+    // actions
+    snapshot_begin(fp, &s[SNAPSHOT_ACT], SNAPSHOT_ACT, SNAPSHOT_STREAM);
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        act_save(xcsf, xcsf->pset.cl[i], fp);
+    }
+    snapshot_end(fp, &s[SNAPSHOT_ACT]);
+    // section table
+    const size_t len = (size_t) ftell(fp);
+    rewind(fp);
+    fwrite(&h, sizeof(struct SnapshotHeader), 1, fp);
+    fclose(fp);
+    return len;
+}
+
+/**
+ * @brief Checks the header and section table of a mapped snapshot.
+ * @param [in] h The snapshot header.
+ * @param [in] len The length of the file.
+ * @param [in] filename The name of the input file.
+ */
+static void
+snapshot_check(const struct SnapshotHeader *h, const size_t len,
+               const char *filename)
+{
+    if (len < sizeof(struct SnapshotHeader) ||
+        memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) != 0 ||
+        h->format != SNAPSHOT_FORMAT || h->endian != SNAPSHOT_ENDIAN) {
+        printf("Error loading file: %s. Not a snapshot.\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    if (h->version[0] != VERSION_MAJOR || h->version[1] != VERSION_MINOR) {
+        printf("Error loading file: %s. Version mismatch. ", filename);
+        printf("This version: %d.%d\n", VERSION_MAJOR, VERSION_MINOR);
+        printf("Loaded version: %d.%d\n", h->version[0], h->version[1]);
+        exit(EXIT_FAILURE);
+    }
+    if (h->precision != (int32_t) sizeof(real)) {
+        printf("Error loading file: %s. Precision mismatch. ", filename);
+        printf("This build: %d bytes\n", (int) sizeof(real));
+        printf("Loaded precision: %d bytes\n", h->precision);
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < SNAPSHOT_SECTIONS; ++i) {
+        const struct SnapshotSection *s = &h->section[i];
+        if (s->id != (uint32_t) i || s->offset > len ||
+            s->size > len - s->offset) {
+            printf("Error loading file: %s. Invalid section.\n", filename);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (h->section[SNAPSHOT_RULES].size !=
+        sizeof(struct SnapshotRule) * (size_t) h->n_rules) {
+        printf("Error loading file: %s. Invalid section.\n", filename);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Reads the state of XCSF from a snapshot file.
+ * @details The file is mapped into memory and the arrays of interval
+ * conditions and least squares predictions are used in place; other
+ * representations are read from the mapping with their load functions.
+ * The mapping is released when the population is next loaded from a
+ * snapshot or XCSF is freed.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The name of the input file.
+ * @return The number of bytes mapped.
+ */
+size_t
+snapshot_load(struct XCSF *xcsf, const char *filename)
+{
+    clset_kill(xcsf, &xcsf->pset);
+    clset_init(&xcsf->pset);
+    clset_purge(xcsf, &xcsf->kset);
+    clset_soa_invalidate(xcsf);
+    clset_stats_invalidate(xcsf);
+    clset_del_invalidate(xcsf);
+    snapshot_free(xcsf);
+    size_t len = 0;
+    char *base = utils_file_map(filename, &len);
+    const struct SnapshotHeader *h = (const struct SnapshotHeader *) base;
+    snapshot_check(h, len, filename);
+    const struct SnapshotSection *s = h->section;
+    // parameters
+    FILE *fp = snapshot_stream(base + s[SNAPSHOT_PARAMS].offset,
+                               s[SNAPSHOT_PARAMS].size);
+    param_load(xcsf, fp);
+    fclose(fp);
+    const uint32_t cond_enc = snapshot_cond_blocks(xcsf) ? SNAPSHOT_BLOCKS
+                                                         : SNAPSHOT_STREAM;
+    const uint32_t pred_enc = snapshot_pred_blocks(xcsf) ? SNAPSHOT_BLOCKS
+                                                         : SNAPSHOT_STREAM;
+    if (s[SNAPSHOT_OUTPUTS].size !=
+            sizeof(double) * xcsf->y_dim * (size_t) h->n_rules ||
+        s[SNAPSHOT_COND].encoding != cond_enc ||
+        s[SNAPSHOT_PRED].encoding != pred_enc) {
+        printf("Error loading file: %s. Invalid section.\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    // classifiers
+    const struct SnapshotRule *rules =
+        (const struct SnapshotRule *) (base + s[SNAPSHOT_RULES].offset);
+    const double *outputs =
+        (const double *) (base + s[SNAPSHOT_OUTPUTS].offset);
+    size_t cond_pos = s[SNAPSHOT_COND].offset;
+    size_t pred_pos = s[SNAPSHOT_PRED].offset;
+    const size_t cond_end = cond_pos + s[SNAPSHOT_COND].size;
+    const size_t pred_end = pred_pos + s[SNAPSHOT_PRED].size;
+    FILE *cond_fp = NULL;
+    FILE *pred_fp = NULL;
+    if (cond_enc == SNAPSHOT_STREAM) {
+        cond_fp = snapshot_stream(base + cond_pos, s[SNAPSHOT_COND].size);
+    }
+    if (pred_enc == SNAPSHOT_STREAM) {
+        pred_fp = snapshot_stream(base + pred_pos, s[SNAPSHOT_PRED].size);
+    }
+    FILE *act_fp =
+        snapshot_stream(base + s[SNAPSHOT_ACT].offset, s[SNAPSHOT_ACT].size);
+    for (int i = 0; i < h->n_rules; ++i) {
+        const struct SnapshotRule *r = &rules[i];
+        struct Cl *c = cl_alloc(xcsf);
+        c->err = r->err;
+        c->fit = r->fit;
+        c->size = r->size;
+        c->num = r->num;
+        c->exp = r->exp;
+        c->time = r->time;
+        c->action = r->action;
+        c->age = r->age;
+        c->mtotal = r->mtotal;
+        c->m = r->m;
+        c->prediction = pool_malloc(xcsf->pool, sizeof(double) * xcsf->y_dim);
+        memcpy(c->prediction, &outputs[i * xcsf->y_dim],
+               sizeof(double) * xcsf->y_dim);
+        action_set(xcsf, c);
+        prediction_set(xcsf, c);
+        condition_set(xcsf, c);
+        act_load(xcsf, c, act_fp);
+        if (pred_fp != NULL) {
+            pred_load(xcsf, c, pred_fp);
+        } else {
+            snapshot_load_pred(xcsf, c, base, &pred_pos, pred_end);
+        }
+        if (cond_fp != NULL) {
+            cond_load(xcsf, c, cond_fp);
+        } else {
+            snapshot_load_cond(xcsf, c, base, &cond_pos, cond_end);
+        }
+        clset_add(&xcsf->pset, c);
+    }
+    fclose(act_fp);
+    if (cond_fp != NULL) {
+        fclose(cond_fp);
+    }
+    if (pred_fp != NULL) {
+        fclose(pred_fp);
+    }
+    xcsf->snap = malloc(sizeof(struct Snapshot));
+    xcsf->snap->addr = base;
+    xcsf->snap->len = len;
+    return len;
+}
+
+/**
+ * @brief Releases the snapshot mapping, if any.
+ * @details Classifiers pointing into the mapping must have been freed.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+snapshot_free(struct XCSF *xcsf)
+{
+    if (xcsf->snap != NULL) {
+        utils_file_unmap(xcsf->snap->addr, xcsf->snap->len);
+        free(xcsf->snap);
+        xcsf->snap = NULL;
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file snapshot.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Memory-mappable population snapshots.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+#include <stdint.h>
+
+#define SNAPSHOT_FORMAT (2) //!< Snapshot layout version
+#define SNAPSHOT_ALIGN (64) //!< Alignment of sections and mapped arrays
+
+#define SNAPSHOT_PARAMS (0) //!< Section holding the parameter stream
+#define SNAPSHOT_RULES (1) //!< Section holding fixed-size rule records
+#define SNAPSHOT_OUTPUTS (2) //!< Section holding rule prediction outputs
+#define SNAPSHOT_COND (3) //!< Section holding rule conditions
+#define SNAPSHOT_PRED (4) //!< Section holding rule predictions
+#define SNAPSHOT_ACT (5) //!< Section holding rule actions
+#define SNAPSHOT_SECTIONS (6) //!< Number of sections
+
+#define SNAPSHOT_STREAM (0) //!< Section written by the component save
+#define SNAPSHOT_BLOCKS (1) //!< Section of aligned arrays used in place
+#define SNAPSHOT_RECORDS (2) //!< Section of fixed-size records
+
+/**
+ * @brief Location and encoding of a snapshot section.
+ */
+struct SnapshotSection {
+    uint32_t id; //!< Section identifier
+    uint32_t encoding; //!< How the section contents are laid out
+    uint64_t offset; //!< Byte offset from the start of the file
+    uint64_t size; //!< Number of bytes in the section
+};
+
+/**
+ * @brief Snapshot file header.
+ * @details The header is followed by each section starting on a
+ * SNAPSHOT_ALIGN boundary. Blocks sections hold the numeric arrays of
+ * interval conditions and least squares predictions, each preceded by a
+ * pool block header tagged POOL_MAPPED so that a classifier may point
+ * straight into the mapped file and release the array as usual. Other
+ * representations are stored with their own save functions.
+ */
+struct SnapshotHeader {
+    char magic[8]; //!< File signature
+    uint32_t format; //!< Snapshot layout version
+    uint32_t endian; //!< Byte order mark
+    int32_t version[3]; //!< XCSF major, minor and build version
+    int32_t n_rules; //!< Number of classifiers in the population
+    int32_t precision; //!< Size of the neural network floating point type
+    int32_t pad; //!< Padding to a multiple of eight bytes
+    struct SnapshotSection section[SNAPSHOT_SECTIONS]; //!< Section table
+};
+
+/**
+ * @brief Fixed-size record of the scalar state of a classifier.
+ */
+struct SnapshotRule {
+    double err; //!< Error
+    double fit; //!< Fitness
+    double size; //!< Average participated set size
+    int32_t num; //!< Numerosity
+    int32_t exp; //!< Experience
+    int32_t time; //!< Time EA last executed in a participating set
+    int32_t action; //!< Current classifier action
+    int32_t age; //!< Total number of times match testing been performed
+    int32_t mtotal; //!< Total number of times actually matched an input
+    int32_t m; //!< Whether the classifier matches current input
+    int32_t pad; //!< Padding to a multiple of eight bytes
+};
+
+/**
+ * @brief A snapshot file mapped into memory.
+ */
+struct Snapshot {
+    void *addr; //!< Start of the mapping
+    size_t len; //!< Length of the mapping
+};
+
+size_t
+snapshot_save(const struct XCSF *xcsf, const char *filename);
+
+size_t
+snapshot_load(struct XCSF *xcsf, const char *filename);
+
+void
+snapshot_free(struct XCSF *xcsf);
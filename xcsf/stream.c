@@ -0,0 +1,324 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Out-of-core streaming data sources.
+ */
+
+#include "stream.h"
+#include "utils.h"
+
+/**
+ * @brief Reads chunks of the source into whichever buffer is free.
+ * @param [in] arg The stream.
+ * @return NULL.
+ */
+static void *
+stream_thread(void *arg)
+{
+    struct Stream *stream = arg;
+    for (int b = 0;; b ^= 1) {
+        pthread_mutex_lock(&stream->lock);
+        while (stream->full[b] && !stream->stop) {
+            pthread_cond_wait(&stream->cond, &stream->lock);
+        }
+        const bool stop = stream->stop;
+        pthread_mutex_unlock(&stream->lock);
+        if (stop) {
+            break;
+        }
+        const int n = (stream->read)(stream->ctx, stream->x[b], stream->y[b],
+                                     stream->chunk);
+        pthread_mutex_lock(&stream->lock);
+        stream->n[b] = n;
+        stream->full[b] = true;
+        pthread_cond_broadcast(&stream->cond);
+        pthread_mutex_unlock(&stream->lock);
+        if (n < 1) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Initialises a stream and starts reading its first chunks.
+ * @param [in] stream The stream to initialise.
+ * @param [in] x_dim The number of feature variables.
+ * @param [in] y_dim The number of target variables.
+ * @param [in] chunk The maximum number of rows read at a time.
+ * @param [in] window The number of rows to shuffle within; 0 for none.
+ * @param [in] read Function reading the next rows of the source.
+ * @param [in] ctx The source state passed to the read function.
+ */
+void
+stream_init(struct Stream *stream, const int x_dim, const int y_dim,
+            const int chunk, const int window, StreamRead read, void *ctx)
+{
+    if (chunk < 1 || window < 0) {
+        printf("stream_init(): error invalid chunk or window size\n");
+        exit(EXIT_FAILURE);
+    }
+    stream->read = read;
+    stream->ctx = ctx;
+    stream->x_dim = x_dim;
+    stream->y_dim = y_dim;
+    stream->chunk = chunk;
+    for (int b = 0; b < 2; ++b) {
+        stream->x[b] = malloc(sizeof(double) * chunk * x_dim);
+        stream->y[b] = malloc(sizeof(double) * chunk * y_dim);
+        stream->n[b] = 0;
+        stream->full[b] = false;
+    }
+    stream->front = -1;
+    stream->pos = 0;
+    stream->done = false;
+    stream->stop = false;
+    stream->window = window;
+    stream->filled = 0;
+    stream->res_x = malloc(sizeof(double) * window * x_dim);
+    stream->res_y = malloc(sizeof(double) * window * y_dim);
+    stream->out_x = malloc(sizeof(double) * x_dim);
+    stream->out_y = malloc(sizeof(double) * y_dim);
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->cond, NULL);
+    if (pthread_create(&stream->thread, NULL, stream_thread, stream) != 0) {
+        printf("stream_init(): error creating reading thread\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Stops reading and frees a stream.
+ * @param [in] stream The stream to free.
+ */
+void
+stream_free(struct Stream *stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    stream->stop = true;
+    pthread_cond_broadcast(&stream->cond);
+    pthread_mutex_unlock(&stream->lock);
+    pthread_join(stream->thread, NULL);
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->cond);
+    for (int b = 0; b < 2; ++b) {
+        free(stream->x[b]);
+        free(stream->y[b]);
+    }
+    free(stream->res_x);
+    free(stream->res_y);
+    free(stream->out_x);
+    free(stream->out_y);
+}
+
+/**
+ * @brief Returns the next row in the order it was read.
+ * @details Moves to the other buffer once the current one is consumed,
+ * handing the consumed buffer back to the reading thread.
+ * @param [in] stream The stream.
+ * @param [out] x Pointer set to the feature variables.
+ * @param [out] y Pointer set to the target variables.
+ * @return Whether a row was returned.
+ */
+static bool
+stream_row(struct Stream *stream, const double **x, const double **y)
+{
+    if (stream->done) {
+        return false;
+    }
+    if (stream->front < 0 || stream->pos >= stream->n[stream->front]) {
+        pthread_mutex_lock(&stream->lock);
+        if (stream->front >= 0) {
+            stream->full[stream->front] = false;
+            pthread_cond_broadcast(&stream->cond);
+        }
+        stream->front = (stream->front < 0) ? 0 : stream->front ^ 1;
+        while (!stream->full[stream->front]) {
+            pthread_cond_wait(&stream->cond, &stream->lock);
+        }
+        pthread_mutex_unlock(&stream->lock);
+        stream->pos = 0;
+        if (stream->n[stream->front] < 1) {
+            stream->done = true;
+            return false;
+        }
+    }
+    *x = &stream->x[stream->front][stream->pos * stream->x_dim];
+    *y = &stream->y[stream->front][stream->pos * stream->y_dim];
+    ++stream->pos;
+    return true;
+}
+
+/**
+ * @brief Returns the next row of a stream.
+ * @details Without a window the rows are returned in order; otherwise a
+ * random row of the reservoir is returned and replaced by the next row read.
+ * The returned rows remain valid until the next call.
+ * @param [in] stream The stream.
+ * @param [out] x Pointer set to the feature variables.
+ * @param [out] y Pointer set to the target variables.
+ * @return Whether a row was returned; false once the stream is exhausted.
+ */
+bool
+stream_next(struct Stream *stream, const double **x, const double **y)
+{
+    if (stream->window < 1) {
+        return stream_row(stream, x, y);
+    }
+    const size_t x_size = sizeof(double) * stream->x_dim;
+    const size_t y_size = sizeof(double) * stream->y_dim;
+    const double *rx = NULL;
+    const double *ry = NULL;
+    while (stream->filled < stream->window && stream_row(stream, &rx, &ry)) {
+        memcpy(&stream->res_x[stream->filled * stream->x_dim], rx, x_size);
+        memcpy(&stream->res_y[stream->filled * stream->y_dim], ry, y_size);
+        ++stream->filled;
+    }
+    if (stream->filled < 1) {
+        return false;
+    }
+    const int j = rand_uniform_int(0, stream->filled);
+    double *slot_x = &stream->res_x[j * stream->x_dim];
+    double *slot_y = &stream->res_y[j * stream->y_dim];
+    memcpy(stream->out_x, slot_x, x_size);
+    memcpy(stream->out_y, slot_y, y_size);
+    if (!stream_row(stream, &rx, &ry)) {
+        --stream->filled;
+        rx = &stream->res_x[stream->filled * stream->x_dim];
+        ry = &stream->res_y[stream->filled * stream->y_dim];
+    }
+    memmove(slot_x, rx, x_size);
+    memmove(slot_y, ry, y_size);
+    *x = stream->out_x;
+    *y = stream->out_y;
+    return true;
+}
+
+/**
+ * @brief Opens a pair of csv files as a data source.
+ * @param [in] csv The source to open.
+ * @param [in] x_file The name of the csv file of feature variables.
+ * @param [in] y_file The name of the csv file of target variables.
+ * @param [in] x_dim The number of feature variables.
+ * @param [in] y_dim The number of target variables.
+ */
+void
+stream_csv_open(struct StreamCSV *csv, const char *x_file, const char *y_file,
+                const int x_dim, const int y_dim)
+{
+    csv->fx = fopen(x_file, "rt");
+    csv->fy = fopen(y_file, "rt");
+    if (csv->fx == 0 || csv->fy == 0) {
+        printf("Error opening file: %s. %s.\n",
+               (csv->fx == 0) ? x_file : y_file, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    csv->x_dim = x_dim;
+    csv->y_dim = y_dim;
+    csv->len = 256;
+    csv->line = malloc(csv->len);
+}
+
+/**
+ * @brief Closes a csv data source.
+ * @param [in] csv The source to close.
+ */
+void
+stream_csv_close(struct StreamCSV *csv)
+{
+    fclose(csv->fx);
+    fclose(csv->fy);
+    free(csv->line);
+}
+
+/**
+ * @brief Reads the next non-blank line of a csv file of any length.
+ * @param [in] csv The source whose line buffer is used.
+ * @param [in] fp The file to read.
+ * @return Whether a line was read.
+ */
+static bool
+stream_csv_line(struct StreamCSV *csv, FILE *fp)
+{
+    for (;;) {
+        size_t used = 0;
+        while (fgets(csv->line + used, (int) (csv->len - used), fp) != NULL) {
+            used += strlen(csv->line + used);
+            if (used > 0 && csv->line[used - 1] == '\n') {
+                break;
+            }
+            csv->len *= 2;
+            csv->line = realloc(csv->line, csv->len);
+        }
+        if (used == 0) {
+            return false;
+        }
+        if (strspn(csv->line, " \t\r\n") < used) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Parses the fields of the current line.
+ * @details Non-numeric fields read as zero.
+ * @param [in] line The line to parse.
+ * @param [out] v The parsed values.
+ * @param [in] n The number of values expected.
+ */
+static void
+stream_csv_parse(const char *line, double *v, const int n)
+{
+    char *end = NULL;
+    for (int i = 0; i < n; ++i) {
+        line += strspn(line, " \t,");
+        if (*line == '\0' || *line == '\r' || *line == '\n') {
+            printf("stream_csv_read(): error missing values\n");
+            exit(EXIT_FAILURE);
+        }
+        v[i] = strtod(line, &end);
+        line = (end == line) ? line + strcspn(line, ",\r\n") : end;
+    }
+}
+
+/**
+ * @brief Reads the next rows of a pair of csv files.
+ * @param [in] ctx The csv source.
+ * @param [out] x Space for max_rows rows of feature variables.
+ * @param [out] y Space for max_rows rows of target variables.
+ * @param [in] max_rows The maximum number of rows to read.
+ * @return The number of rows read.
+ */
+int
+stream_csv_read(void *ctx, double *x, double *y, const int max_rows)
+{
+    struct StreamCSV *csv = ctx;
+    int n = 0;
+    while (n < max_rows && stream_csv_line(csv, csv->fx)) {
+        stream_csv_parse(csv->line, &x[n * csv->x_dim], csv->x_dim);
+        if (!stream_csv_line(csv, csv->fy)) {
+            printf("stream_csv_read(): error fewer targets than features\n");
+            exit(EXIT_FAILURE);
+        }
+        stream_csv_parse(csv->line, &y[n * csv->y_dim], csv->y_dim);
+        ++n;
+    }
+    return n;
+}
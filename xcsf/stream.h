@@ -0,0 +1,102 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2023.
+ * @brief Out-of-core streaming data sources.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+#include <pthread.h>
+
+/**
+ * @brief Reads the next rows of a data source.
+ * @param [in] ctx The source state.
+ * @param [out] x Space for max_rows rows of feature variables.
+ * @param [out] y Space for max_rows rows of target variables.
+ * @param [in] max_rows The maximum number of rows to read.
+ * @return The number of rows read; zero once the source is exhausted.
+ */
+typedef int (*StreamRead)(void *ctx, double *x, double *y, const int max_rows);
+
+/**
+ * @brief Streaming data source.
+ * @details Rows are read in chunks by a background thread into one buffer
+ * while the rows of the other buffer are consumed, so reading overlaps with
+ * training. When a window is given, rows are drawn uniformly at random from
+ * a reservoir of that many rows that is refilled from the stream, giving a
+ * local shuffle of data too large to hold in memory.
+ */
+struct Stream {
+    StreamRead read; //!< Function reading the next rows of the source
+    void *ctx; //!< State of the source
+    int x_dim; //!< Number of feature variables
+    int y_dim; //!< Number of target variables
+    int chunk; //!< Maximum number of rows per buffer
+    double *x[2]; //!< Feature variables of the two buffers
+    double *y[2]; //!< Target variables of the two buffers
+    int n[2]; //!< Number of rows in each buffer
+    bool full[2]; //!< Whether each buffer is waiting to be consumed
+    int front; //!< Buffer being consumed, or -1 before the first
+    int pos; //!< Next row of the buffer being consumed
+    bool done; //!< Whether the source has been exhausted
+    bool stop; //!< Whether the reading thread has been asked to stop
+    int window; //!< Number of rows in the shuffle reservoir; 0 for none
+    int filled; //!< Number of rows held in the reservoir
+    double *res_x; //!< Feature variables of the reservoir
+    double *res_y; //!< Target variables of the reservoir
+    double *out_x; //!< Feature variables of the last row returned
+    double *out_y; //!< Target variables of the last row returned
+    pthread_t thread; //!< Background reading thread
+    pthread_mutex_t lock; //!< Lock protecting the buffer states
+    pthread_cond_t cond; //!< Signalled when a buffer changes state
+};
+
+/**
+ * @brief Data source reading rows from a pair of csv files.
+ */
+struct StreamCSV {
+    FILE *fx; //!< File of feature variables
+    FILE *fy; //!< File of target variables
+    int x_dim; //!< Number of feature variables
+    int y_dim; //!< Number of target variables
+    char *line; //!< Line buffer
+    size_t len; //!< Length of the line buffer
+};
+
+bool
+stream_next(struct Stream *stream, const double **x, const double **y);
+
+void
+stream_init(struct Stream *stream, const int x_dim, const int y_dim,
+            const int chunk, const int window, StreamRead read, void *ctx);
+
+void
+stream_free(struct Stream *stream);
+
+int
+stream_csv_read(void *ctx, double *x, double *y, const int max_rows);
+
+void
+stream_csv_open(struct StreamCSV *csv, const char *x_file, const char *y_file,
+                const int x_dim, const int y_dim);
+
+void
+stream_csv_close(struct StreamCSV *csv);
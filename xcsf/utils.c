@@ -18,38 +18,170 @@
  * @author Richard Preen <rpreen@gmail.com>
  * @author David Pätzel
  * @copyright The Authors.
- * @date 2015--2021.
+ * @date 2015--2023.
  * @brief Utility functions for random number handling, etc.
  */
 
 #include "utils.h"
+#include <errno.h>
 #include <limits.h>
+#include <stdalign.h>
 #include <stdbool.h>
+#include <string.h>
 #include <time.h>
 
+#ifdef PARALLEL
+    #include <omp.h>
+#endif
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#define RAND_STREAMS (1024) //!< Maximum number of threads drawing numbers
+#define RAND_LANES (8) //!< Philox blocks generated together
+#define RAND_BUF (2 * RAND_LANES) //!< Uniform draws buffered per stream
+
 /**
- * @brief Initialises the pseudo-random number generator.
+ * @brief Random number stream owned by a single thread.
+ * @details Draws come from the Philox4x32-10 counter-based generator; each
+ * 128-bit block is a pure function of the key, the block number, and the
+ * stream number, so streams never overlap and reseeding only resets the
+ * counters. The stream number is its index in the array of streams. The
+ * stream is aligned to a cache line to avoid false sharing.
  */
-void
-rand_init(void)
+struct RandStream {
+    alignas(64) uint32_t key[2]; //!< Key derived from the seed
+    uint64_t block; //!< Number of the next block to generate
+    double buf[RAND_BUF]; //!< Buffered uniform draws
+    int avail; //!< Number of unused draws at the end of the buffer
+    bool has_normal; //!< Whether a spare Gaussian draw is cached
+    double normal; //!< Spare Gaussian draw from the last Box-Muller pair
+};
+
+static struct RandStream streams[RAND_STREAMS]; //!< One stream per thread
+
+/**
+ * @brief Returns the random number stream of the calling thread.
+ * @return The stream.
+ */
+static struct RandStream *
+rand_stream(void)
 {
-    time_t now = time(0);
-    const unsigned char *p = (unsigned char *) &now;
-    uint32_t seed = 0;
-    for (size_t i = 0; i < sizeof(now); ++i) {
-        seed = (seed * (UCHAR_MAX + 2U)) + p[i];
+#ifdef PARALLEL
+    const int t = omp_get_thread_num();
+    if (t >= RAND_STREAMS) {
+        printf("rand_stream(): error thread %d >= %d\n", t, RAND_STREAMS);
+        exit(EXIT_FAILURE);
+    }
+    return &streams[t];
+#else
+    return &streams[0];
+#endif
+}
+
+/**
+ * @brief Generates consecutive Philox4x32-10 blocks as uniform draws (0,1).
+ * @details The lanes are processed in lockstep so that the rounds vectorise.
+ * Each 128-bit block yields two doubles with 52 random mantissa bits.
+ * @param [in] s The random number stream.
+ * @param [out] out The RAND_BUF uniform draws generated.
+ */
+static void
+rand_philox(struct RandStream *s, double *out)
+{
+    uint32_t c0[RAND_LANES];
+    uint32_t c1[RAND_LANES];
+    uint32_t c2[RAND_LANES];
+    uint32_t c3[RAND_LANES];
+    for (int i = 0; i < RAND_LANES; ++i) {
+        const uint64_t block = s->block + i;
+        c0[i] = (uint32_t) block;
+        c1[i] = (uint32_t) (block >> 32);
+        c2[i] = (uint32_t) (s - streams);
+        c3[i] = 0;
+    }
+    s->block += RAND_LANES;
+    uint32_t k0 = s->key[0];
+    uint32_t k1 = s->key[1];
+    for (int r = 0; r < 10; ++r) {
+        for (int i = 0; i < RAND_LANES; ++i) {
+            const uint64_t p0 = (uint64_t) 0xD2511F53 * c0[i];
+            const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2[i];
+            const uint32_t x0 = (uint32_t) (p1 >> 32) ^ c1[i] ^ k0;
+            const uint32_t x2 = (uint32_t) (p0 >> 32) ^ c3[i] ^ k1;
+            c1[i] = (uint32_t) p1;
+            c3[i] = (uint32_t) p0;
+            c0[i] = x0;
+            c2[i] = x2;
+        }
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    for (int i = 0; i < RAND_LANES; ++i) {
+        const uint64_t a = ((uint64_t) c0[i] << 32) | c1[i];
+        const uint64_t b = ((uint64_t) c2[i] << 32) | c3[i];
+        out[2 * i] = ((double) (a >> 12) + 0.5) * 0x1p-52;
+        out[2 * i + 1] = ((double) (b >> 12) + 0.5) * 0x1p-52;
+    }
+}
+
+/**
+ * @brief Returns the next uniform draw (0,1) from a stream.
+ * @param [in] s The random number stream.
+ * @return A random float.
+ */
+static inline double
+rand_next(struct RandStream *s)
+{
+    if (s->avail < 1) {
+        rand_philox(s, s->buf);
+        s->avail = RAND_BUF;
     }
-    dsfmt_gv_init_gen_rand(seed);
+    return s->buf[RAND_BUF - s->avail--];
 }
 
 /**
  * @brief Initialises the pseudo-random number generator with a fixed seed.
+ * @details Every thread stream shares a key derived from the seed and is
+ * distinguished by its stream number, so results are reproducible for a
+ * given seed and number of threads.
  * @param [in] seed Random number seed.
  */
 void
 rand_init_seed(const uint32_t seed)
 {
-    dsfmt_gv_init_gen_rand(seed);
+    uint64_t z = seed + 0x9E3779B97F4A7C15;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    z ^= z >> 31;
+    for (int i = 0; i < RAND_STREAMS; ++i) {
+        struct RandStream *s = &streams[i];
+        s->key[0] = (uint32_t) z;
+        s->key[1] = (uint32_t) (z >> 32);
+        s->block = 0;
+        s->avail = 0;
+        s->has_normal = false;
+        s->normal = 0;
+    }
+}
+
+/**
+ * @brief Initialises the pseudo-random number generator.
+ */
+void
+rand_init(void)
+{
+    time_t now = time(0);
+    const unsigned char *p = (unsigned char *) &now;
+    uint32_t seed = 0;
+    for (size_t i = 0; i < sizeof(now); ++i) {
+        seed = (seed * (UCHAR_MAX + 2U)) + p[i];
+    }
+    rand_init_seed(seed);
 }
 
 /**
@@ -61,7 +193,37 @@ rand_init_seed(const uint32_t seed)
 double
 rand_uniform(const double min, const double max)
 {
-    return min + (dsfmt_gv_genrand_open_open() * (max - min));
+    return min + (rand_next(rand_stream()) * (max - min));
+}
+
+/**
+ * @brief Fills an array with uniform random floats [min,max].
+ * @details Draws the same sequence as calling rand_uniform() n times, with
+ * whole buffers generated directly into the array.
+ * @param [out] x The array to fill.
+ * @param [in] n The number of draws.
+ * @param [in] min Minimum value.
+ * @param [in] max Maximum value.
+ */
+void
+rand_uniform_fill(double *x, const int n, const double min, const double max)
+{
+    struct RandStream *s = rand_stream();
+    const double range = max - min;
+    int i = 0;
+    while (i < n && s->avail > 0) {
+        x[i++] = min + (s->buf[RAND_BUF - s->avail--] * range);
+    }
+    for (; i + RAND_BUF <= n; i += RAND_BUF) {
+        double *y = &x[i];
+        rand_philox(s, y);
+        for (int j = 0; j < RAND_BUF; ++j) {
+            y[j] = min + (y[j] * range);
+        }
+    }
+    while (i < n) {
+        x[i++] = min + (rand_next(s) * range);
+    }
 }
 
 /**
@@ -78,7 +240,8 @@ rand_uniform_int(const int min, const int max)
 
 /**
  * @brief Returns a random Gaussian with specified mean and standard deviation.
- * @details Box-Muller transform.
+ * @details Box-Muller transform; the second draw of each pair is cached in
+ * the calling thread's stream.
  * @param [in] mu Mean.
  * @param [in] sigma Standard deviation.
  * @return A random float.
@@ -86,18 +249,51 @@ rand_uniform_int(const int min, const int max)
 double
 rand_normal(const double mu, const double sigma)
 {
-    static const double two_pi = 2 * M_PI;
-    static double z1;
-    static bool generate;
-    generate = !generate;
-    if (!generate) {
-        return z1 * sigma + mu;
-    }
-    const double u1 = dsfmt_gv_genrand_open_open();
-    const double u2 = dsfmt_gv_genrand_open_open();
-    const double z0 = sqrt(-2 * log(u1)) * cos(two_pi * u2);
-    z1 = sqrt(-2 * log(u1)) * sin(two_pi * u2);
-    return z0 * sigma + mu;
+    struct RandStream *s = rand_stream();
+    if (s->has_normal) {
+        s->has_normal = false;
+        return s->normal * sigma + mu;
+    }
+    const double u1 = rand_next(s);
+    const double u2 = rand_next(s);
+    const double r = sqrt(-2 * log(u1));
+    s->normal = r * sin(2 * M_PI * u2);
+    s->has_normal = true;
+    return r * cos(2 * M_PI * u2) * sigma + mu;
+}
+
+/**
+ * @brief Fills an array with random Gaussians.
+ * @details Draws the same sequence as calling rand_normal() n times. Pairs of
+ * uniform draws are generated in bulk into the array and then transformed in
+ * place.
+ * @param [out] x The array to fill.
+ * @param [in] n The number of draws.
+ * @param [in] mu Mean.
+ * @param [in] sigma Standard deviation.
+ */
+void
+rand_normal_fill(double *x, const int n, const double mu, const double sigma)
+{
+    struct RandStream *s = rand_stream();
+    int i = 0;
+    if (n > 0 && s->has_normal) {
+        s->has_normal = false;
+        x[i++] = s->normal * sigma + mu;
+    }
+    const int n_pairs = (n - i) / 2;
+    rand_uniform_fill(&x[i], n_pairs * 2, 0, 1);
+    for (int j = 0; j < n_pairs; ++j) {
+        double *z = &x[i + 2 * j];
+        const double r = sqrt(-2 * log(z[0]));
+        const double theta = 2 * M_PI * z[1];
+        z[0] = r * cos(theta) * sigma + mu;
+        z[1] = r * sin(theta) * sigma + mu;
+    }
+    i += n_pairs * 2;
+    if (i < n) {
+        x[i] = rand_normal(mu, sigma);
+    }
 }
 
 /**
@@ -117,3 +313,73 @@ utils_json_parse_check(const cJSON *json)
         exit(EXIT_FAILURE);
     }
 }
+
+/**
+ * @brief Maps a file into memory.
+ * @details The mapping is private and writable; modified pages are copied
+ * rather than written back to the file. Where memory mapping is unavailable
+ * the file is read into a heap buffer.
+ * @param [in] filename The name of the file to map.
+ * @param [out] len The length of the file.
+ * @return Pointer to the start of the mapping, or NULL if the file is empty.
+ */
+void *
+utils_file_map(const char *filename, size_t *len)
+{
+#ifdef _WIN32
+    FILE *fp = fopen(filename, "rb");
+    if (fp == 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    fseek(fp, 0, SEEK_END);
+    *len = (size_t) ftell(fp);
+    rewind(fp);
+    void *addr = NULL;
+    if (*len > 0) {
+        addr = malloc(*len);
+        if (fread(addr, 1, *len, fp) != *len) {
+            printf("Error reading file: %s. %s.\n", filename, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(fp);
+#else
+    const int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    *len = (size_t) st.st_size;
+    void *addr = NULL;
+    if (*len > 0) {
+        addr = mmap(NULL, *len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            printf("Error mapping file: %s. %s.\n", filename, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+    close(fd);
+#endif
+    return addr;
+}
+
+/**
+ * @brief Releases a file mapped with utils_file_map().
+ * @param [in] addr Start of the mapping; may be NULL.
+ * @param [in] len The length of the mapping.
+ */
+void
+utils_file_unmap(void *addr, const size_t len)
+{
+    if (addr == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    (void) len;
+    free(addr);
+#else
+    munmap(addr, len);
+#endif
+}
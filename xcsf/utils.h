@@ -25,9 +25,9 @@
 #pragma once
 
 #include "../lib/cJSON/cJSON.h"
-#include "../lib/dSFMT/dSFMT.h"
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -40,6 +40,12 @@ rand_uniform(const double min, const double max);
 int
 rand_uniform_int(const int min, const int max);
 
+void
+rand_normal_fill(double *x, const int n, const double mu, const double sigma);
+
+void
+rand_uniform_fill(double *x, const int n, const double min, const double max);
+
 void
 rand_init(void);
 
@@ -49,6 +55,12 @@ rand_init_seed(const uint32_t seed);
 void
 utils_json_parse_check(const cJSON *json);
 
+void *
+utils_file_map(const char *filename, size_t *len);
+
+void
+utils_file_unmap(void *addr, const size_t len);
+
 /**
  * @brief Returns a float clamped within the specified range.
  * @param [in] a The value to be clamped.
@@ -75,6 +87,20 @@ clamp_int(const int a, const int min, const int max)
     return (a < min) ? min : (a > max) ? max : a;
 }
 
+/**
+ * @brief Returns the number of bits set in a 64-bit word.
+ * @param [in] w The word.
+ * @return The number of set bits.
+ */
+static inline int
+bit_count(uint64_t w)
+{
+    w -= (w >> 1) & 0x5555555555555555ULL;
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int) ((w * 0x0101010101010101ULL) >> 56);
+}
+
 /**
  * @brief Returns the index of the largest element in vector X.
  * @details First occurrence is selected in the case of a tie.
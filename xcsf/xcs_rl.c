@@ -132,9 +132,13 @@ xcs_rl_init_trial(struct XCSF *xcsf)
         xcsf->x_dim = 1;
         exit(EXIT_FAILURE);
     }
-    xcsf->prev_state = malloc(sizeof(double) * xcsf->x_dim);
-    clset_init(&xcsf->prev_aset);
-    clset_init(&xcsf->kset);
+    if (xcsf->prev_state == NULL || xcsf->prev_state_dim != xcsf->x_dim) {
+        free(xcsf->prev_state);
+        xcsf->prev_state = malloc(sizeof(double) * xcsf->x_dim);
+        xcsf->prev_state_dim = xcsf->x_dim;
+    }
+    clset_clear(&xcsf->prev_aset);
+    clset_clear(&xcsf->kset);
 }
 
 /**
@@ -144,9 +148,8 @@ xcs_rl_init_trial(struct XCSF *xcsf)
 void
 xcs_rl_end_trial(struct XCSF *xcsf)
 {
-    clset_free(&xcsf->prev_aset);
-    clset_kill(xcsf, &xcsf->kset);
-    free(xcsf->prev_state);
+    clset_clear(&xcsf->prev_aset);
+    clset_purge(xcsf, &xcsf->kset);
 }
 
 /**
@@ -156,8 +159,8 @@ xcs_rl_end_trial(struct XCSF *xcsf)
 void
 xcs_rl_init_step(struct XCSF *xcsf)
 {
-    clset_init(&xcsf->mset);
-    clset_init(&xcsf->aset);
+    clset_clear(&xcsf->mset);
+    clset_clear(&xcsf->aset);
 }
 
 /**
@@ -171,9 +174,12 @@ void
 xcs_rl_end_step(struct XCSF *xcsf, const double *state, const int action,
                 const double reward)
 {
-    clset_free(&xcsf->mset);
-    clset_free(&xcsf->prev_aset);
+    // the action set becomes the previous one and reuses its memory
+    const struct Set prev_aset = xcsf->prev_aset;
     xcsf->prev_aset = xcsf->aset;
+    xcsf->aset = prev_aset;
+    clset_clear(&xcsf->aset);
+    clset_clear(&xcsf->mset);
     xcsf->prev_reward = reward;
     xcsf->prev_pred = pa_val(xcsf, action);
     memcpy(xcsf->prev_state, state, sizeof(double) * xcsf->x_dim);
@@ -193,7 +199,7 @@ xcs_rl_update(struct XCSF *xcsf, const double *state, const int action,
               const double reward, const bool done)
 {
     clset_action(xcsf, action); // create action set
-    if (xcsf->prev_aset.list != NULL) { // update previous action set and run EA
+    if (xcsf->prev_aset.size > 0) { // update previous action set and run EA
         const double p = xcsf->prev_reward + (xcsf->GAMMA * pa_best_val(xcsf));
         clset_validate(&xcsf->prev_aset);
         clset_update(xcsf, &xcsf->prev_aset, xcsf->prev_state, &p, false);
@@ -225,7 +231,7 @@ xcs_rl_error(struct XCSF *xcsf, const int action, const double reward,
 {
     double error = 0;
     const double prediction = pa_val(xcsf, action);
-    if (xcsf->prev_aset.list != NULL) {
+    if (xcsf->prev_aset.size > 0) {
         const double p = xcsf->prev_reward + (xcsf->GAMMA * prediction);
         error += (xcsf->loss_ptr)(xcsf, &xcsf->prev_pred, &p) / max_p;
     }
@@ -22,13 +22,24 @@
  */
 
 #include "xcs_supervised.h"
+#include "action.h"
+#include "cl.h"
 #include "clset.h"
+#include "clset_del.h"
+#include "clset_soa.h"
+#include "cond_dgp.h"
+#include "cond_gp.h"
+#include "condition.h"
 #include "ea.h"
 #include "loss.h"
 #include "pa.h"
 #include "param.h"
 #include "perf.h"
 #include "utils.h"
+#include <float.h>
+
+#define BATCH_SIZE (256) //!< Maximum number of samples evaluated together
+#define BATCH_WORDS (BATCH_SIZE / 64) //!< Match words per rule in a batch
 
 /**
  * @brief Selects a data sample for training or testing.
@@ -59,8 +70,8 @@ static void
 xcs_supervised_trial(struct XCSF *xcsf, const double *x, const double *y,
                      const double *cover)
 {
-    clset_init(&xcsf->mset);
-    clset_init(&xcsf->kset);
+    clset_clear(&xcsf->mset);
+    clset_clear(&xcsf->kset);
     if (cover != NULL) {
         // no coverage is to be performed
         clset_match(xcsf, x, false);
@@ -80,8 +91,454 @@ xcs_supervised_trial(struct XCSF *xcsf, const double *x, const double *y,
         clset_update(xcsf, &xcsf->mset, x, y, true);
         ea(xcsf, &xcsf->mset);
     }
-    clset_kill(xcsf, &xcsf->kset);
-    clset_free(&xcsf->mset);
+    clset_purge(xcsf, &xcsf->kset);
+    clset_clear(&xcsf->mset);
+}
+
+/**
+ * @brief Scratch memory for evaluating a block of samples together.
+ */
+struct Batch {
+    uint64_t *match; //!< Rules x samples match matrix
+    uint64_t *rows; //!< Samples x rules match matrix
+    int *mset_size; //!< Number of rules matching each sample
+    int *count; //!< Number of samples matched by each rule
+    int *base; //!< First prediction of each rule in each match word
+    int *general; //!< Rules used to measure generality
+    int *mtotal; //!< Running match counts of the generality rules
+    double *pa; //!< Prediction array for each sample
+    double *nr; //!< Total fitness for each sample
+    double *pred; //!< Predictions of each rule for each matched sample
+    int *action; //!< Actions of each rule for each matched sample
+    int pred_max; //!< Number of predictions allocated
+};
+
+/**
+ * @brief Returns whether the population can be evaluated in batches.
+ * @details Rule types share a network between the condition and the action or
+ * prediction and therefore must be evaluated one sample at a time.
+ * @param [in] xcsf The XCSF data structure.
+ * @return Whether batch evaluation is supported.
+ */
+static bool
+xcs_supervised_batch_enabled(const struct XCSF *xcsf)
+{
+    switch (xcsf->cond->type) {
+        case RULE_TYPE_DGP:
+        case RULE_TYPE_NEURAL:
+        case RULE_TYPE_NETWORK:
+            return false;
+        default:
+            return xcsf->act->type == ACT_TYPE_INTEGER;
+    }
+}
+
+/**
+ * @brief Allocates the scratch memory for batch evaluation.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [out] batch The batch scratch memory.
+ */
+static void
+xcs_supervised_batch_init(const struct XCSF *xcsf, struct Batch *batch)
+{
+    const int n_words = clset_soa_words(xcsf->pset.size);
+    batch->match = malloc(sizeof(uint64_t) * xcsf->pset.size * BATCH_WORDS);
+    batch->rows = malloc(sizeof(uint64_t) * BATCH_SIZE * n_words);
+    batch->count = malloc(sizeof(int) * xcsf->pset.size);
+    batch->base = malloc(sizeof(int) * xcsf->pset.size * BATCH_WORDS);
+    batch->mset_size = malloc(sizeof(int) * BATCH_SIZE);
+    batch->general = malloc(sizeof(int) * xcsf->pset.size);
+    batch->mtotal = malloc(sizeof(int) * xcsf->pset.size);
+    batch->pa = malloc(sizeof(double) * BATCH_SIZE * xcsf->pa_size);
+    batch->nr = malloc(sizeof(double) * BATCH_SIZE * xcsf->pa_size);
+    batch->pred_max = 0;
+    batch->pred = NULL;
+    batch->action = NULL;
+}
+
+/**
+ * @brief Ensures there is room for the predictions of a block of samples.
+ * @details Grows geometrically so that the buffers are reallocated only a
+ * few times over all of the blocks evaluated.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] batch The batch scratch memory.
+ * @param [in] n The number of predictions required.
+ */
+static void
+xcs_supervised_batch_reserve(const struct XCSF *xcsf, struct Batch *batch,
+                             const int n)
+{
+    if (n > batch->pred_max) {
+        int max = (batch->pred_max > 0) ? batch->pred_max : BATCH_SIZE;
+        while (max < n) {
+            max *= 2;
+        }
+        free(batch->pred);
+        free(batch->action);
+        batch->pred = malloc(sizeof(double) * max * xcsf->y_dim);
+        batch->action = malloc(sizeof(int) * max);
+        batch->pred_max = max;
+    }
+}
+
+/**
+ * @brief Frees the scratch memory for batch evaluation.
+ * @param [in] batch The batch scratch memory.
+ */
+static void
+xcs_supervised_batch_free(const struct Batch *batch)
+{
+    free(batch->match);
+    free(batch->rows);
+    free(batch->count);
+    free(batch->base);
+    free(batch->mset_size);
+    free(batch->general);
+    free(batch->mtotal);
+    free(batch->pa);
+    free(batch->nr);
+    free(batch->pred);
+    free(batch->action);
+}
+
+/**
+ * @brief Returns whether a rule matched a sample within the block.
+ * @param [in] batch The batch scratch memory.
+ * @param [in] i The population index of the rule.
+ * @param [in] r The sample within the block.
+ * @return Whether the rule matched the sample.
+ */
+static inline bool
+xcs_supervised_batch_bit(const struct Batch *batch, const int i, const int r)
+{
+    return (batch->match[i * BATCH_WORDS + (r >> 6)] >> (r & 63)) & 1;
+}
+
+/**
+ * @brief Sets the match bits of a rule for a block of samples.
+ * @details Tree GP and stateless DGP conditions are evaluated across the
+ * whole block at once; other conditions are matched one sample at a time.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The rule to match.
+ * @param [in] x The feature variables of the block.
+ * @param [in] n_rows The number of samples in the block.
+ * @param [out] m The match words of the rule.
+ */
+static void
+xcs_supervised_batch_match_rule(const struct XCSF *xcsf, const struct Cl *c,
+                                const double *x, const int n_rows,
+                                uint64_t *m)
+{
+    if (xcsf->cond->type == COND_TYPE_GP) {
+        cond_gp_match_batch(xcsf, c, x, n_rows, m);
+    } else if (xcsf->cond->type == COND_TYPE_DGP && !xcsf->STATEFUL) {
+        cond_dgp_match_batch(xcsf, c, x, n_rows, m);
+    } else {
+        for (int r = 0; r < n_rows; ++r) {
+            if (cond_match(xcsf, c, &x[r * xcsf->x_dim])) {
+                m[r >> 6] |= (uint64_t) 1 << (r & 63);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Builds the match matrices for a block of samples.
+ * @details Samples are matched concurrently against the SoA store and the
+ * results transposed, with each thread writing the rows of its own rules.
+ * Other condition types are matched rule by rule and transposed the other
+ * way, with each thread writing the rows of its own samples.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] batch The batch scratch memory.
+ * @param [in] x The feature variables of the block.
+ * @param [in] n_rows The number of samples in the block.
+ */
+static void
+xcs_supervised_batch_match(struct XCSF *xcsf, const struct Batch *batch,
+                           const double *x, const int n_rows)
+{
+    const struct Set *pset = &xcsf->pset;
+    const int n_words = clset_soa_words(pset->size);
+    memset(batch->match, 0, sizeof(uint64_t) * pset->size * BATCH_WORDS);
+    if (clset_soa_enabled(xcsf)) {
+        clset_soa_match_rows(xcsf, x, n_rows, batch->rows);
+#ifdef PARALLEL_MATCH
+        #pragma omp parallel for
+#endif
+        for (int w = 0; w < n_words; ++w) {
+            for (int r = 0; r < n_rows; ++r) {
+                const uint64_t word = batch->rows[r * n_words + w];
+                const uint64_t bit = (uint64_t) 1 << (r & 63);
+                for (int j = 0; j < 64 && word >> j != 0; ++j) {
+                    if ((word >> j) & 1) {
+                        const int i = w * 64 + j;
+                        batch->match[i * BATCH_WORDS + (r >> 6)] |= bit;
+                    }
+                }
+            }
+        }
+    } else {
+#ifdef PARALLEL_MATCH
+        #pragma omp parallel for
+#endif
+        for (int i = 0; i < pset->size; ++i) {
+            xcs_supervised_batch_match_rule(xcsf, pset->cl[i], x, n_rows,
+                                            &batch->match[i * BATCH_WORDS]);
+        }
+#ifdef PARALLEL_MATCH
+        #pragma omp parallel for
+#endif
+        for (int r = 0; r < n_rows; ++r) {
+            uint64_t *row = &batch->rows[r * n_words];
+            memset(row, 0, sizeof(uint64_t) * n_words);
+            for (int i = 0; i < pset->size; ++i) {
+                if (xcs_supervised_batch_bit(batch, i, r)) {
+                    row[i >> 6] |= (uint64_t) 1 << (i & 63);
+                }
+            }
+        }
+    }
+    for (int r = 0; r < n_rows; ++r) {
+        int size = 0;
+        for (int w = 0; w < n_words; ++w) {
+            size += bit_count(batch->rows[r * n_words + w]);
+        }
+        batch->mset_size[r] = size;
+    }
+}
+
+/**
+ * @brief Updates the match statistics as if each sample were matched in turn.
+ * @details Classifier experience and error are unchanged when not exploring,
+ * so the rules considered by clset_mfrac() are fixed for the whole block and
+ * only their running match counts need to be tracked from sample to sample.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] batch The batch scratch memory.
+ * @param [in] n_rows The number of samples in the block.
+ */
+static void
+xcs_supervised_batch_stats(struct XCSF *xcsf, const struct Batch *batch,
+                           const int n_rows)
+{
+    const struct Set *pset = &xcsf->pset;
+    // rules used to measure generality: most general below E0, else best
+    int n_general = 0;
+    int *general = batch->general;
+    int *mtotal = batch->mtotal;
+    int best = -1;
+    double error = DBL_MAX;
+    for (int i = 0; i < pset->size; ++i) {
+        const struct Cl *c = pset->cl[i];
+        if (c->exp * xcsf->BETA > 1) {
+            if (c->err < xcsf->E0) {
+                general[n_general] = i;
+                mtotal[n_general] = c->mtotal;
+                ++n_general;
+            }
+            if (c->err < error) {
+                best = i;
+                error = c->err;
+            }
+        }
+    }
+    int best_mtotal = (best >= 0) ? pset->cl[best]->mtotal : 0;
+    for (int r = 0; r < n_rows; ++r) {
+        double mfrac = 0;
+        for (int k = 0; k < n_general; ++k) {
+            const struct Cl *c = pset->cl[general[k]];
+            mtotal[k] += xcs_supervised_batch_bit(batch, general[k], r);
+            const double frac = (double) mtotal[k] / (c->age + r + 1);
+            if (frac > mfrac) {
+                mfrac = frac;
+            }
+        }
+        if (best >= 0) {
+            best_mtotal += xcs_supervised_batch_bit(batch, best, r);
+            if (mfrac == 0) {
+                mfrac = (double) best_mtotal / (pset->cl[best]->age + r + 1);
+            }
+        }
+        xcsf->mset_size += (batch->mset_size[r] - xcsf->mset_size) * xcsf->BETA;
+        xcsf->mfrac += (mfrac - xcsf->mfrac) * xcsf->BETA;
+    }
+    for (int i = 0; i < pset->size; ++i) {
+        struct Cl *c = pset->cl[i];
+        int count = 0;
+        for (int w = 0; w < BATCH_WORDS; ++w) {
+            count += bit_count(batch->match[i * BATCH_WORDS + w]);
+        }
+        batch->count[i] = count;
+        c->m = xcs_supervised_batch_bit(batch, i, n_rows - 1);
+        c->mtotal += count;
+        c->age += n_rows;
+        clset_del_aged(xcsf, c, n_rows, count);
+    }
+}
+
+/**
+ * @brief Computes the prediction arrays for a block of samples.
+ * @details Produces the same result as running a trial for each sample with
+ * covering disabled. Each rule computes its predictions for all of the
+ * samples it matches before moving on to the next rule, and the prediction
+ * arrays are accumulated in population order as in pa_build().
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] batch The batch scratch memory.
+ * @param [in] x The feature variables of the block.
+ * @param [in] n_rows The number of samples in the block (at most BATCH_SIZE).
+ * @param [in] cover The prediction array to use for an empty match set.
+ */
+static void
+xcs_supervised_batch_predict(struct XCSF *xcsf, struct Batch *batch,
+                             const double *x, const int n_rows,
+                             const double *cover)
+{
+    const struct Set *pset = &xcsf->pset;
+    const int pa_size = xcsf->pa_size;
+    const int y_dim = xcsf->y_dim;
+    xcs_supervised_batch_match(xcsf, batch, x, n_rows);
+    xcs_supervised_batch_stats(xcsf, batch, n_rows);
+    // each rule writes its predictions from its own offset
+    int n_preds = 0;
+    for (int i = 0; i < pset->size; ++i) {
+        for (int w = 0; w < BATCH_WORDS; ++w) {
+            batch->base[i * BATCH_WORDS + w] = n_preds;
+            n_preds += bit_count(batch->match[i * BATCH_WORDS + w]);
+        }
+    }
+    xcs_supervised_batch_reserve(xcsf, batch, n_preds);
+    double *pred = batch->pred;
+    int *action = batch->action;
+    // propagate inputs and compute predictions; rules own their scratch
+#ifdef PARALLEL_PRED
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < pset->size; ++i) {
+        struct Cl *c = pset->cl[i];
+        int k = batch->base[i * BATCH_WORDS];
+        for (int r = 0; r < n_rows && batch->count[i] > 0; ++r) {
+            if (xcs_supervised_batch_bit(batch, i, r)) {
+                const double *xr = &x[r * xcsf->x_dim];
+                action[k] = cl_action(xcsf, c, xr);
+                memcpy(&pred[k * y_dim], cl_predict(xcsf, c, xr),
+                       sizeof(double) * y_dim);
+                ++k;
+            }
+        }
+    }
+    // compute each prediction array in population order for determinism
+    const int n_words = clset_soa_words(pset->size);
+#ifdef PARALLEL_PRED
+    #pragma omp parallel for
+#endif
+    for (int r = 0; r < n_rows; ++r) {
+        double *pa = &batch->pa[r * pa_size];
+        double *nr = &batch->nr[r * pa_size];
+        if (batch->mset_size[r] < 1) {
+            memcpy(pa, cover, sizeof(double) * pa_size);
+            continue;
+        }
+        memset(pa, 0, sizeof(double) * pa_size);
+        memset(nr, 0, sizeof(double) * pa_size);
+        const uint64_t below = ((uint64_t) 1 << (r & 63)) - 1;
+        for (int w = 0; w < n_words; ++w) {
+            const uint64_t word = batch->rows[r * n_words + w];
+            for (int j = 0; j < 64 && word >> j != 0; ++j) {
+                if ((word >> j) & 1) {
+                    const int i = w * 64 + j;
+                    const int m = i * BATCH_WORDS + (r >> 6);
+                    const int k =
+                        batch->base[m] + bit_count(batch->match[m] & below);
+                    const double fitness = pset->cl[i]->fit;
+                    const int pos = action[k] * y_dim;
+                    for (int l = 0; l < y_dim; ++l) {
+                        pa[pos + l] += pred[k * y_dim + l] * fitness;
+                        nr[pos + l] += fitness;
+                    }
+                }
+            }
+        }
+        for (int l = 0; l < pa_size; ++l) {
+            pa[l] = (nr[l] != 0) ? pa[l] / nr[l] : 0;
+        }
+    }
+    int last = -1; // last sample with a non-empty match set
+    for (int r = 0; r < n_rows; ++r) {
+        if (batch->mset_size[r] > 0) {
+            last = r;
+        }
+    }
+    // leave the prediction array as it would be after the final trial
+    memcpy(xcsf->pa, &batch->pa[(n_rows - 1) * pa_size],
+           sizeof(double) * pa_size);
+    if (last >= 0) {
+        memcpy(xcsf->nr, &batch->nr[last * pa_size], sizeof(double) * pa_size);
+    }
+}
+
+/**
+ * @brief Returns the total loss over consecutive samples evaluated in batches.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The feature variables.
+ * @param [in] y The labelled variables.
+ * @param [in] n_samples The number of samples.
+ * @param [in] cover The prediction array to use for an empty match set.
+ * @return The total loss using the loss function.
+ */
+static double
+xcs_supervised_batch_loss(struct XCSF *xcsf, const double *x, const double *y,
+                          const int n_samples, const double *cover)
+{
+    struct Batch batch;
+    xcs_supervised_batch_init(xcsf, &batch);
+    double err = 0;
+    for (int row = 0; row < n_samples; row += BATCH_SIZE) {
+        const int n_rows = clamp_int(n_samples - row, 1, BATCH_SIZE);
+        xcs_supervised_batch_predict(xcsf, &batch, &x[row * xcsf->x_dim],
+                                     n_rows, cover);
+        for (int r = 0; r < n_rows; ++r) {
+            const double *yr = &y[(row + r) * xcsf->y_dim];
+            err += (xcsf->loss_ptr)(xcsf, &batch.pa[r * xcsf->pa_size], yr);
+        }
+    }
+    xcs_supervised_batch_free(&batch);
+    return err;
+}
+
+/**
+ * @brief Executes a learning trial on a training sample.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The feature variables.
+ * @param [in] y The labelled variables.
+ * @return The training error using the loss function.
+ */
+static double
+xcs_supervised_learn(struct XCSF *xcsf, const double *x, const double *y)
+{
+    param_set_explore(xcsf, true);
+    xcs_supervised_trial(xcsf, x, y, NULL);
+    const double error = (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
+    xcsf->error += (error - xcsf->error) * xcsf->BETA;
+    return error;
+}
+
+/**
+ * @brief Executes a test trial on a sample of the test data.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] test_data The input data to use for testing.
+ * @param [in] cnt The current sequence counter.
+ * @param [in] shuffle Whether to select the sample randomly.
+ * @return The testing error using the loss function.
+ */
+static double
+xcs_supervised_test(struct XCSF *xcsf, const struct Input *test_data,
+                    const int cnt, const bool shuffle)
+{
+    const int row = xcs_supervised_sample(test_data, cnt, shuffle);
+    const double *x = &test_data->x[row * test_data->x_dim];
+    const double *y = &test_data->y[row * test_data->y_dim];
+    param_set_explore(xcsf, false);
+    xcs_supervised_trial(xcsf, x, y, NULL);
+    return (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
 }
 
 /**
@@ -103,30 +560,57 @@ xcs_supervised_fit(struct XCSF *xcsf, const struct Input *train_data,
     double werr = 0; // training error: windowed total
     double wterr = 0; // testing error: windowed total
     for (int cnt = 0; cnt < trials; ++cnt) {
-        // training sample
-        int row = xcs_supervised_sample(train_data, cnt, shuffle);
+        const int row = xcs_supervised_sample(train_data, cnt, shuffle);
         const double *x = &train_data->x[row * train_data->x_dim];
         const double *y = &train_data->y[row * train_data->y_dim];
-        param_set_explore(xcsf, true);
-        xcs_supervised_trial(xcsf, x, y, NULL);
-        const double error = (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
+        const double error = xcs_supervised_learn(xcsf, x, y);
         werr += error;
         err += error;
-        xcsf->error += (error - xcsf->error) * xcsf->BETA;
-        // test sample
         if (test_data != NULL) {
-            row = xcs_supervised_sample(test_data, cnt, shuffle);
-            x = &test_data->x[row * test_data->x_dim];
-            y = &test_data->y[row * test_data->y_dim];
-            param_set_explore(xcsf, false);
-            xcs_supervised_trial(xcsf, x, y, NULL);
-            wterr += (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
+            wterr += xcs_supervised_test(xcsf, test_data, cnt, shuffle);
         }
         perf_print(xcsf, &werr, &wterr, cnt);
     }
     return err / trials;
 }
 
+/**
+ * @brief Executes XCSF learning iterations on the rows of a stream.
+ * @details Stops after the given number of trials or when the stream is
+ * exhausted, whichever comes first.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] train_data The stream of data to use for training.
+ * @param [in] test_data The input data to use for testing, or NULL.
+ * @param [in] shuffle Whether to randomise the test instances.
+ * @param [in] trials Maximum number of trials to execute.
+ * @param [out] n_trials The number of trials executed.
+ * @return The average XCSF training error using the loss function.
+ */
+double
+xcs_supervised_fit_stream(struct XCSF *xcsf, struct Stream *train_data,
+                          const struct Input *test_data, const bool shuffle,
+                          const int trials, int *n_trials)
+{
+    double err = 0; // training error: total over all trials
+    double werr = 0; // training error: windowed total
+    double wterr = 0; // testing error: windowed total
+    const double *x = NULL;
+    const double *y = NULL;
+    int cnt = 0;
+    while (cnt < trials && stream_next(train_data, &x, &y)) {
+        const double error = xcs_supervised_learn(xcsf, x, y);
+        werr += error;
+        err += error;
+        if (test_data != NULL) {
+            wterr += xcs_supervised_test(xcsf, test_data, cnt, shuffle);
+        }
+        perf_print(xcsf, &werr, &wterr, cnt);
+        ++cnt;
+    }
+    *n_trials = cnt;
+    return (cnt > 0) ? err / cnt : 0;
+}
+
 /**
  * @brief Calculates the XCSF predictions for the provided input.
  * @param [in] xcsf The XCSF data structure.
@@ -141,6 +625,19 @@ xcs_supervised_predict(struct XCSF *xcsf, const double *x, double *pred,
                        const int n_samples, const double *cover)
 {
     param_set_explore(xcsf, false);
+    if (cover != NULL && xcs_supervised_batch_enabled(xcsf)) {
+        struct Batch batch;
+        xcs_supervised_batch_init(xcsf, &batch);
+        for (int row = 0; row < n_samples; row += BATCH_SIZE) {
+            const int n_rows = clamp_int(n_samples - row, 1, BATCH_SIZE);
+            xcs_supervised_batch_predict(xcsf, &batch, &x[row * xcsf->x_dim],
+                                         n_rows, cover);
+            memcpy(&pred[row * xcsf->pa_size], batch.pa,
+                   sizeof(double) * n_rows * xcsf->pa_size);
+        }
+        xcs_supervised_batch_free(&batch);
+        return;
+    }
     for (int row = 0; row < n_samples; ++row) {
         xcs_supervised_trial(xcsf, &x[row * xcsf->x_dim], NULL, cover);
         memcpy(&pred[row * xcsf->pa_size], xcsf->pa,
@@ -161,6 +658,11 @@ xcs_supervised_score(struct XCSF *xcsf, const struct Input *data,
                      const double *cover)
 {
     param_set_explore(xcsf, false);
+    if (cover != NULL && xcs_supervised_batch_enabled(xcsf)) {
+        const double err = xcs_supervised_batch_loss(xcsf, data->x, data->y,
+                                                     data->n_samples, cover);
+        return err / data->n_samples;
+    }
     double err = 0;
     for (int row = 0; row < data->n_samples; ++row) {
         const double *x = &data->x[row * data->x_dim];
@@ -188,6 +690,22 @@ xcs_supervised_score_n(struct XCSF *xcsf, const struct Input *data, const int N,
         return xcs_supervised_score(xcsf, data, cover);
     }
     param_set_explore(xcsf, false);
+    if (cover != NULL && xcs_supervised_batch_enabled(xcsf)) {
+        // gather the randomly drawn samples into contiguous rows
+        double *x = malloc(sizeof(double) * N * data->x_dim);
+        double *y = malloc(sizeof(double) * N * data->y_dim);
+        for (int i = 0; i < N; ++i) {
+            const int row = xcs_supervised_sample(data, i, true);
+            memcpy(&x[i * data->x_dim], &data->x[row * data->x_dim],
+                   sizeof(double) * data->x_dim);
+            memcpy(&y[i * data->y_dim], &data->y[row * data->y_dim],
+                   sizeof(double) * data->y_dim);
+        }
+        const double err = xcs_supervised_batch_loss(xcsf, x, y, N, cover);
+        free(x);
+        free(y);
+        return err / N;
+    }
     double err = 0;
     for (int i = 0; i < N; ++i) {
         const int row = xcs_supervised_sample(data, i, true);
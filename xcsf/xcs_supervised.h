@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "stream.h"
 #include "xcsf.h"
 
 double
@@ -30,6 +31,11 @@ xcs_supervised_fit(struct XCSF *xcsf, const struct Input *train_data,
                    const struct Input *test_data, const bool shuffle,
                    const int trials);
 
+double
+xcs_supervised_fit_stream(struct XCSF *xcsf, struct Stream *train_data,
+                          const struct Input *test_data, const bool shuffle,
+                          const int trials, int *n_trials);
+
 double
 xcs_supervised_score(struct XCSF *xcsf, const struct Input *data,
                      const double *cover);
@@ -23,11 +23,16 @@
 
 #include "cl.h"
 #include "clset.h"
+#include "clset_del.h"
+#include "clset_soa.h"
+#include "clset_stats.h"
 #include "cond_neural.h"
 #include "loss.h"
 #include "pa.h"
 #include "param.h"
+#include "pool.h"
 #include "pred_neural.h"
+#include "snapshot.h"
 
 /**
  * @brief Initialises XCSF with an empty population.
@@ -43,6 +48,16 @@ xcsf_init(struct XCSF *xcsf)
     xcsf->mfrac = 0;
     clset_init(&xcsf->pset);
     clset_init(&xcsf->prev_pset);
+    clset_init(&xcsf->mset);
+    clset_init(&xcsf->aset);
+    clset_init(&xcsf->kset);
+    clset_init(&xcsf->prev_aset);
+    xcsf->prev_state = NULL;
+    xcsf->prev_state_dim = 0;
+    xcsf->soa = NULL;
+    xcsf->del = NULL;
+    xcsf->snap = NULL;
+    xcsf->stats = calloc(1, sizeof(struct SetStats));
     pa_init(xcsf);
     clset_pset_init(xcsf);
 }
@@ -61,6 +76,17 @@ xcsf_free(struct XCSF *xcsf)
     xcsf->mfrac = 0;
     clset_kill(xcsf, &xcsf->pset);
     clset_kill(xcsf, &xcsf->prev_pset);
+    clset_kill(xcsf, &xcsf->kset);
+    clset_free(&xcsf->mset);
+    clset_free(&xcsf->aset);
+    clset_free(&xcsf->prev_aset);
+    free(xcsf->prev_state);
+    xcsf->prev_state = NULL;
+    xcsf->prev_state_dim = 0;
+    clset_soa_free(xcsf);
+    clset_del_free(xcsf);
+    clset_stats_free(xcsf);
+    snapshot_free(xcsf);
     pa_free(xcsf);
 }
 
@@ -79,63 +105,171 @@ xcsf_print_pset(const struct XCSF *xcsf, const bool print_cond,
 }
 
 /**
- * @brief Writes the current state of XCSF to a file.
+ * @brief Writes the current state of XCSF to a stream.
+ * @details The version is followed by the size of the floating point type
+ * used for neural network values so that a build of different precision
+ * can reject the file.
  * @param [in] xcsf The XCSF data structure.
- * @param [in] filename The name of the output file.
+ * @param [in] fp Pointer to the output stream.
  * @return The total number of elements written.
  */
-size_t
-xcsf_save(const struct XCSF *xcsf, const char *filename)
+static size_t
+xcsf_save_stream(const struct XCSF *xcsf, FILE *fp)
 {
-    FILE *fp = fopen(filename, "wb");
-    if (fp == 0) {
-        printf("Error saving file: %s. %s.\n", filename, strerror(errno));
-        exit(EXIT_FAILURE);
-    }
     size_t s = 0;
     s += fwrite(&VERSION_MAJOR, sizeof(int), 1, fp);
     s += fwrite(&VERSION_MINOR, sizeof(int), 1, fp);
     s += fwrite(&VERSION_BUILD, sizeof(int), 1, fp);
+    const int precision = (int) sizeof(real);
+    s += fwrite(&precision, sizeof(int), 1, fp);
     s += param_save(xcsf, fp);
     s += clset_pset_save(xcsf, fp);
-    fclose(fp);
     return s;
 }
 
 /**
- * @brief Reads the state of XCSF from a file.
+ * @brief Reads the state of XCSF from a stream.
  * @param [in] xcsf The XCSF data structure.
- * @param [in] filename The name of the input file.
+ * @param [in] fp Pointer to the input stream.
+ * @param [in] name Name of the source used in error messages.
  * @return The total number of elements read.
  */
-size_t
-xcsf_load(struct XCSF *xcsf, const char *filename)
+static size_t
+xcsf_load_stream(struct XCSF *xcsf, FILE *fp, const char *name)
 {
     if (xcsf->pset.size > 0) {
         clset_kill(xcsf, &xcsf->pset);
         clset_init(&xcsf->pset);
     }
-    FILE *fp = fopen(filename, "rb");
-    if (fp == 0) {
-        printf("Error loading file: %s. %s.\n", filename, strerror(errno));
-        exit(EXIT_FAILURE);
-    }
+    clset_soa_invalidate(xcsf);
+    clset_stats_invalidate(xcsf);
+    clset_del_invalidate(xcsf);
     size_t s = 0;
     int major = 0;
     int minor = 0;
     int build = 0;
+    int precision = 0;
     s += fread(&major, sizeof(int), 1, fp);
     s += fread(&minor, sizeof(int), 1, fp);
     s += fread(&build, sizeof(int), 1, fp);
     if (major != VERSION_MAJOR || minor != VERSION_MINOR) {
-        printf("Error loading file: %s. Version mismatch. ", filename);
+        printf("Error loading %s. Version mismatch. ", name);
         printf("This version: %d.%d\n", VERSION_MAJOR, VERSION_MINOR);
         printf("Loaded version: %d.%d\n", major, minor);
         fclose(fp);
         exit(EXIT_FAILURE);
     }
+    s += fread(&precision, sizeof(int), 1, fp);
+    if (precision != (int) sizeof(real)) {
+        printf("Error loading %s. Precision mismatch. ", name);
+        printf("This build: %d bytes\n", (int) sizeof(real));
+        printf("Loaded precision: %d bytes\n", precision);
+        fclose(fp);
+        exit(EXIT_FAILURE);
+    }
     s += param_load(xcsf, fp);
     s += clset_pset_load(xcsf, fp);
+    return s;
+}
+
+/**
+ * @brief Writes the current state of XCSF to a file.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The name of the output file.
+ * @return The total number of elements written.
+ */
+size_t
+xcsf_save(const struct XCSF *xcsf, const char *filename)
+{
+    FILE *fp = fopen(filename, "wb");
+    if (fp == 0) {
+        printf("Error saving file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    const size_t s = xcsf_save_stream(xcsf, fp);
+    fclose(fp);
+    return s;
+}
+
+/**
+ * @brief Reads the state of XCSF from a file.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The name of the input file.
+ * @return The total number of elements read.
+ */
+size_t
+xcsf_load(struct XCSF *xcsf, const char *filename)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (fp == 0) {
+        printf("Error loading file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    const size_t s = xcsf_load_stream(xcsf, fp, filename);
+    fclose(fp);
+    return s;
+}
+
+/**
+ * @brief Writes the current state of XCSF to a memory buffer.
+ * @details The buffer holds the same bytes as a file written by xcsf_save()
+ * and is allocated with malloc; the caller is responsible for freeing it.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [out] buf Pointer set to the new buffer.
+ * @param [out] len The number of bytes in the buffer.
+ * @return The total number of elements written.
+ */
+size_t
+xcsf_save_buffer(const struct XCSF *xcsf, char **buf, size_t *len)
+{
+#ifdef _WIN32
+    FILE *fp = tmpfile();
+#else
+    FILE *fp = open_memstream(buf, len);
+#endif
+    if (fp == 0) {
+        printf("Error saving to memory. %s.\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    const size_t s = xcsf_save_stream(xcsf, fp);
+#ifdef _WIN32
+    *len = (size_t) ftell(fp);
+    *buf = malloc(*len);
+    rewind(fp);
+    if (fread(*buf, 1, *len, fp) != *len) {
+        printf("Error saving to memory. %s.\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+#endif
+    fclose(fp);
+    return s;
+}
+
+/**
+ * @brief Reads the state of XCSF from a memory buffer.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] buf Buffer written by xcsf_save_buffer(); it is not modified.
+ * @param [in] len The number of bytes in the buffer.
+ * @return The total number of elements read.
+ */
+size_t
+xcsf_load_buffer(struct XCSF *xcsf, const char *buf, const size_t len)
+{
+#ifdef _WIN32
+    FILE *fp = tmpfile();
+    if (fp != 0) {
+        fwrite(buf, 1, len, fp);
+        rewind(fp);
+    }
+#else
+    // opened read-only, so the buffer is never written through
+    FILE *fp = fmemopen((void *) (uintptr_t) buf, len, "rb");
+#endif
+    if (fp == 0) {
+        printf("Error loading from memory. %s.\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    const size_t s = xcsf_load_stream(xcsf, fp, "memory buffer");
     fclose(fp);
     return s;
 }
@@ -148,15 +282,16 @@ xcsf_load(struct XCSF *xcsf, const char *filename)
 void
 xcsf_pred_expand(const struct XCSF *xcsf)
 {
-    const struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        pred_neural_expand(xcsf, iter->cl);
-        iter->cl->fit = xcsf->INIT_FITNESS;
-        iter->cl->err = xcsf->INIT_ERROR;
-        iter->cl->exp = 0;
-        iter->cl->time = xcsf->time;
-        iter = iter->next;
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        struct Cl *c = xcsf->pset.cl[i];
+        pred_neural_expand(xcsf, c);
+        c->fit = xcsf->INIT_FITNESS;
+        c->err = xcsf->INIT_ERROR;
+        c->exp = 0;
+        c->time = xcsf->time;
     }
+    clset_stats_invalidate(xcsf);
+    clset_del_invalidate(xcsf);
 }
 
 /**
@@ -172,17 +307,18 @@ xcsf_ae_to_classifier(struct XCSF *xcsf, const int y_dim, const int n_del)
     param_set_y_dim(xcsf, y_dim);
     param_set_loss_func(xcsf, LOSS_ONEHOT);
     pa_init(xcsf);
-    const struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        free(iter->cl->prediction);
-        iter->cl->prediction = calloc(xcsf->y_dim, sizeof(double));
-        pred_neural_ae_to_classifier(xcsf, iter->cl, n_del);
-        iter->cl->fit = xcsf->INIT_FITNESS;
-        iter->cl->err = xcsf->INIT_ERROR;
-        iter->cl->exp = 0;
-        iter->cl->time = xcsf->time;
-        iter = iter->next;
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        struct Cl *c = xcsf->pset.cl[i];
+        pool_free(xcsf->pool, c->prediction);
+        c->prediction = pool_calloc(xcsf->pool, xcsf->y_dim, sizeof(double));
+        pred_neural_ae_to_classifier(xcsf, c, n_del);
+        c->fit = xcsf->INIT_FITNESS;
+        c->err = xcsf->INIT_ERROR;
+        c->exp = 0;
+        c->time = xcsf->time;
     }
+    clset_stats_invalidate(xcsf);
+    clset_del_invalidate(xcsf);
 }
 
 /**
@@ -193,13 +329,11 @@ void
 xcsf_store_pset(struct XCSF *xcsf)
 {
     clset_kill(xcsf, &xcsf->prev_pset);
-    const struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        struct Cl *new = malloc(sizeof(struct Cl));
-        const struct Cl *src = iter->cl;
+    for (int i = 0; i < xcsf->pset.size; ++i) {
+        struct Cl *new = cl_alloc(xcsf);
+        const struct Cl *src = xcsf->pset.cl[i];
         cl_init_copy(xcsf, new, src);
         clset_add(&xcsf->prev_pset, new);
-        iter = iter->next;
     }
 }
 
@@ -215,6 +349,9 @@ xcsf_retrieve_pset(struct XCSF *xcsf)
         return;
     }
     clset_kill(xcsf, &xcsf->pset);
+    clset_soa_invalidate(xcsf);
+    clset_stats_invalidate(xcsf);
+    clset_del_invalidate(xcsf);
     xcsf->pset = xcsf->prev_pset;
     clset_init(&xcsf->prev_pset);
 }
@@ -36,8 +36,8 @@
 #include <string.h>
 
 static const int VERSION_MAJOR = 1; //!< XCSF major version number
-static const int VERSION_MINOR = 4; //!< XCSF minor version number
-static const int VERSION_BUILD = 3; //!< XCSF build version number
+static const int VERSION_MINOR = 5; //!< XCSF minor version number
+static const int VERSION_BUILD = 0; //!< XCSF build version number
 
 /**
  * @brief Classifier data structure.
@@ -60,23 +60,18 @@ struct Cl {
     int action; //!< Current classifier action
     int age; //!< Total number of times match testing been performed
     int mtotal; //!< Total number of times actually matched an input
-};
-
-/**
- * @brief Classifier linked list.
- */
-struct Clist {
-    struct Cl *cl; //!< Pointer to classifier data structure
-    struct Clist *next; //!< Pointer to the next list element
+    int slot; //!< Last known index of the classifier in the population
 };
 
 /**
  * @brief Classifier set.
+ * @details Classifiers are stored as a contiguous, growable array of pointers.
  */
 struct Set {
-    struct Clist *list; //!< Linked list of classifiers
+    struct Cl **cl; //!< Array of pointers to classifiers
     int size; //!< Number of macro-classifiers
     int num; //!< The total numerosity of classifiers
+    int capacity; //!< Number of classifier pointers allocated
 };
 
 /**
@@ -89,6 +84,11 @@ struct XCSF {
     struct Set aset; //!< Action set
     struct Set kset; //!< Kill set
     struct Set prev_aset; //!< Previous action set
+    struct SetSoa *soa; //!< SoA store of population interval conditions
+    struct SetDel *del; //!< Deletion vote tree of the population
+    struct SetStats *stats; //!< Running statistics of the population
+    struct Pool *pool; //!< Allocator for classifiers and their payloads
+    struct Snapshot *snap; //!< Mapped snapshot the population points into
     struct ArgsAct *act; //!< Action parameters
     struct ArgsCond *cond; //!< Condition parameters
     struct ArgsPred *pred; //!< Prediction parameters
@@ -104,6 +104,7 @@ struct XCSF {
     double *pa; //!< Prediction array (stores fitness weighted predictions)
     double *nr; //!< Prediction array (stores total fitness)
     double *prev_state; //!< Environment state on the previous step
+    int prev_state_dim; //!< Number of variables allocated for prev_state
     double *cover; //!< Values to return for a prediction instead of covering
     int time; //!< Current number of EA executions
     int pa_size; //!< Prediction array size
@@ -157,6 +158,12 @@ xcsf_load(struct XCSF *xcsf, const char *filename);
 size_t
 xcsf_save(const struct XCSF *xcsf, const char *filename);
 
+size_t
+xcsf_load_buffer(struct XCSF *xcsf, const char *buf, const size_t len);
+
+size_t
+xcsf_save_buffer(const struct XCSF *xcsf, char **buf, size_t *len);
+
 void
 xcsf_free(struct XCSF *xcsf);
 